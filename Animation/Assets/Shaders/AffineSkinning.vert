@@ -0,0 +1,47 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aUV;
+layout (location = 3) in vec4 weights;
+layout (location = 4) in ivec4 joints;
+
+layout (location = 0) out vec3 normal;
+layout (location = 1) out vec2 uv;
+layout (location = 2) out vec3 fragPos;
+
+layout (location = 5) uniform mat4 model;
+layout (location = 6) uniform mat4 view;
+layout (location = 7) uniform mat4 projection;
+
+// First joint of the palette and the number of joints per instance, instanced draws read
+// the palette of instance i at paletteOffset + i * jointCount
+layout (location = 8) uniform uint paletteOffset;
+layout (location = 9) uniform uint jointCount;
+
+// Skinning matrices already multiplied by the inverse bind pose on the CPU, three rows of a
+// 3x4 matrix per joint. No joint limit.
+layout (std430, binding = 0) readonly buffer SkinningPalette
+{
+    vec4 palette[];
+};
+
+void main()
+{
+    uint base = (paletteOffset + uint(gl_InstanceID) * jointCount) * 3;
+    uvec4 index = base + uvec4(joints) * 3;
+
+    vec4 row0 = palette[index.x]     * weights.x + palette[index.y]     * weights.y + palette[index.z]     * weights.z + palette[index.w]     * weights.w;
+    vec4 row1 = palette[index.x + 1] * weights.x + palette[index.y + 1] * weights.y + palette[index.z + 1] * weights.z + palette[index.w + 1] * weights.w;
+    vec4 row2 = palette[index.x + 2] * weights.x + palette[index.y + 2] * weights.y + palette[index.z + 2] * weights.z + palette[index.w + 2] * weights.w;
+
+    vec4 position = vec4(aPosition, 1.0);
+    vec4 skinnedPosition = vec4(dot(row0, position), dot(row1, position), dot(row2, position), 1.0);
+    vec3 skinnedNormal = vec3(dot(row0.xyz, aNormal), dot(row1.xyz, aNormal), dot(row2.xyz, aNormal));
+
+    gl_Position = projection * view * model * skinnedPosition;
+    
+    fragPos = vec3(model * skinnedPosition);
+    normal = vec3(model * vec4(skinnedNormal, 0.0f));
+    uv = aUV;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aUV;
+layout (location = 3) in vec4 weights;
+layout (location = 4) in ivec4 joints;
+
+layout (location = 0) out vec3 normal;
+layout (location = 1) out vec2 uv;
+layout (location = 2) out vec3 fragPos;
+
+layout (location = 5) uniform mat4 model;
+layout (location = 6) uniform mat4 view;
+layout (location = 7) uniform mat4 projection;
+
+// Must match Renderer::PaletteBuffer::MaxUniformJoints, 341 joints of 48 bytes fit the
+// 16 KB GL_MAX_UNIFORM_BLOCK_SIZE every driver guarantees
+#define MAX_JOINTS 341
+
+// Skinning matrices already multiplied by the inverse bind pose on the CPU, three rows of a
+// 3x4 matrix per joint
+layout (std140, binding = 0) uniform SkinningPalette
+{
+    vec4 palette[MAX_JOINTS * 3];
+};
+
+void main()
+{
+    ivec4 index = joints * 3;
+
+    vec4 row0 = palette[index.x]     * weights.x + palette[index.y]     * weights.y + palette[index.z]     * weights.z + palette[index.w]     * weights.w;
+    vec4 row1 = palette[index.x + 1] * weights.x + palette[index.y + 1] * weights.y + palette[index.z + 1] * weights.z + palette[index.w + 1] * weights.w;
+    vec4 row2 = palette[index.x + 2] * weights.x + palette[index.y + 2] * weights.y + palette[index.z + 2] * weights.z + palette[index.w + 2] * weights.w;
+
+    vec4 position = vec4(aPosition, 1.0);
+    vec4 skinnedPosition = vec4(dot(row0, position), dot(row1, position), dot(row2, position), 1.0);
+    vec3 skinnedNormal = vec3(dot(row0.xyz, aNormal), dot(row1.xyz, aNormal), dot(row2.xyz, aNormal));
+
+    gl_Position = projection * view * model * skinnedPosition;
+    
+    fragPos = vec3(model * skinnedPosition);
+    normal = vec3(model * vec4(skinnedNormal, 0.0f));
+    uv = aUV;
+}
\ No newline at end of file
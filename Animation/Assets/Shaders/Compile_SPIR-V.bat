@@ -1,2 +1,4 @@
 glslangValidator --auto-map-locations -G -o Static.vert.spv Static.vert
-glslangValidator --auto-map-locations -G -o Lit.frag.spv Lit.frag
\ No newline at end of file
+glslangValidator --auto-map-locations -G -o Lit.frag.spv Lit.frag
+glslangValidator --auto-map-locations -G -o AffineSkinning.vert.spv AffineSkinning.vert
+glslangValidator --auto-map-locations -G -o AffineSkinningUBO.vert.spv AffineSkinningUBO.vert
\ No newline at end of file
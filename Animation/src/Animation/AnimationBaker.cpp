@@ -1,34 +1,162 @@
-#pragma once
-
 #include "AnimationBaker.h"
 
 namespace Animation
 {
-	void bakeAnimationToTexture(const Skeleton& skeleton, AnimationClip& animationClip, AnimationTexture& texture)
+	namespace AnimationBakerHelpers
 	{
-		const AnimationPose& bindPose = skeleton.getBindPose();
-
-		AnimationPose pose = bindPose;
-
-		uint32_t textureWidth = texture.getSize();
+		// Per-thread scratch data of the baker
+		struct BakeContext
+		{
+			AnimationPose pose;
+			std::vector<Transform> globalTransforms;
+			std::vector<Matrix3x4> globalMatrices;
+		};
 
-		for (uint32_t x = 0; x < textureWidth; x++)
+		inline void bakeColumn(const Skeleton& skeleton, const AnimationClip& animationClip, uint32_t x, uint32_t rowOffset,
+							   AnimationTexture& texture, BakeContext& context)
 		{
-			float t = static_cast<float>(x) / (textureWidth - 1);
+			uint32_t textureWidth = texture.getSize();
+
+			float t = textureWidth > 1 ? static_cast<float>(x) / (textureWidth - 1) : 0.0f;
 			float start = animationClip.getStartTime();
 			float time = start + animationClip.getDuration() * t;
-			
-			animationClip.sample(pose, time);
 
-			for (uint32_t y = 0; y < pose.getSize() * 3; y += 3)
+			context.pose = skeleton.getBindPose();
+			animationClip.sample(context.pose, time);
+			context.pose.getGlobalTransforms(context.globalTransforms);
+
+			// Positions come from the matrices, see getGlobalTransforms
+			context.pose.getMatrixPalette(context.globalMatrices);
+
+			uint32_t numJoints = context.pose.getSize();
+
+			for (uint32_t i = 0; i < numJoints; i++)
 			{
-				Transform node = pose.getGlobalTransform(y / 3);
+				const Transform& node = context.globalTransforms[i];
+				const Matrix3x4& matrix = context.globalMatrices[i];
+				uint32_t y = rowOffset + i * 3;
 
-				texture.setTexel(x, y + 0, node.position);
+				texture.setTexel(x, y + 0, Vector3(matrix.m03, matrix.m13, matrix.m23));
 				texture.setTexel(x, y + 1, node.rotation);
 				texture.setTexel(x, y + 2, node.scale);
 			}
 		}
+
+		inline void addClipEntry(const Skeleton& skeleton, const AnimationClip& animationClip, uint32_t rowOffset, AnimationTexture& texture)
+		{
+			AnimationTextureClip clip;
+			clip.name = animationClip.getName();
+			clip.rowOffset = rowOffset;
+			clip.numRows = skeleton.getBindPose().getSize() * 3;
+			clip.numFrames = texture.getSize();
+			clip.duration = animationClip.getDuration();
+			clip.bLooping = animationClip.isLooping();
+
+			texture.addClip(clip);
+		}
+
+		inline void layoutClips(const Skeleton& skeleton, const std::vector<AnimationClip>& animationClips, AnimationTexture& texture, std::vector<uint32_t>& outRowOffsets)
+		{
+			uint32_t numClips = static_cast<uint32_t>(animationClips.size());
+			uint32_t rowsPerClip = skeleton.getBindPose().getSize() * 3;
+
+			outRowOffsets.resize(numClips);
+
+			for (uint32_t i = 0; i < numClips; i++)
+			{
+				outRowOffsets[i] = i * rowsPerClip;
+			}
+
+			if (texture.getHeight() < numClips * rowsPerClip)
+			{
+				texture.resize(texture.getSize(), numClips * rowsPerClip);
+			}
+
+			texture.clearClips();
+
+			for (uint32_t i = 0; i < numClips; i++)
+			{
+				addClipEntry(skeleton, animationClips[i], outRowOffsets[i], texture);
+			}
+		}
+	}
+
+	void bakeAnimationToTexture(const Skeleton& skeleton, const AnimationClip& animationClip, AnimationTexture& texture)
+	{
+		texture.clearClips();
+		AnimationBakerHelpers::addClipEntry(skeleton, animationClip, 0, texture);
+
+		AnimationBakerHelpers::BakeContext context;
+		uint32_t textureWidth = texture.getSize();
+
+		for (uint32_t x = 0; x < textureWidth; x++)
+		{
+			AnimationBakerHelpers::bakeColumn(skeleton, animationClip, x, 0, texture, context);
+		}
+
+		texture.uploadTextureDataToGPU();
+	}
+
+	void bakeAnimationToTexture(const Skeleton& skeleton, const AnimationClip& animationClip, AnimationTexture& texture, Util::JobSystem& jobSystem)
+	{
+		texture.clearClips();
+		AnimationBakerHelpers::addClipEntry(skeleton, animationClip, 0, texture);
+
+		std::vector<AnimationBakerHelpers::BakeContext> contexts(jobSystem.getNumWorkers());
+
+		// Columns write disjoint texels, so they can be baked in any order
+		jobSystem.parallelFor(texture.getSize(), 16, [&](uint32_t begin, uint32_t end, uint32_t workerIndex)
+		{
+			for (uint32_t x = begin; x < end; x++)
+			{
+				AnimationBakerHelpers::bakeColumn(skeleton, animationClip, x, 0, texture, contexts[workerIndex]);
+			}
+		});
+
+		texture.uploadTextureDataToGPU();
+	}
+
+	void bakeAnimationsToTexture(const Skeleton& skeleton, const std::vector<AnimationClip>& animationClips, AnimationTexture& texture, std::vector<uint32_t>& outRowOffsets)
+	{
+		uint32_t numClips = static_cast<uint32_t>(animationClips.size());
+
+		AnimationBakerHelpers::layoutClips(skeleton, animationClips, texture, outRowOffsets);
+
+		AnimationBakerHelpers::BakeContext context;
+		uint32_t textureWidth = texture.getSize();
+
+		for (uint32_t i = 0; i < numClips; i++)
+		{
+			for (uint32_t x = 0; x < textureWidth; x++)
+			{
+				AnimationBakerHelpers::bakeColumn(skeleton, animationClips[i], x, outRowOffsets[i], texture, context);
+			}
+		}
+
+		texture.uploadTextureDataToGPU();
+	}
+
+	void bakeAnimationsToTexture(const Skeleton& skeleton, const std::vector<AnimationClip>& animationClips, AnimationTexture& texture, std::vector<uint32_t>& outRowOffsets, Util::JobSystem& jobSystem)
+	{
+		uint32_t numClips = static_cast<uint32_t>(animationClips.size());
+
+		AnimationBakerHelpers::layoutClips(skeleton, animationClips, texture, outRowOffsets);
+
+		std::vector<AnimationBakerHelpers::BakeContext> contexts(jobSystem.getNumWorkers());
+		uint32_t textureWidth = texture.getSize();
+
+		// One item per column of every clip, consecutive items stay on the same clip
+		jobSystem.parallelFor(numClips * textureWidth, 16, [&](uint32_t begin, uint32_t end, uint32_t workerIndex)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				uint32_t clip = i / textureWidth;
+				uint32_t x = i % textureWidth;
+
+				AnimationBakerHelpers::bakeColumn(skeleton, animationClips[clip], x, outRowOffsets[clip], texture, contexts[workerIndex]);
+			}
+		});
+
 		texture.uploadTextureDataToGPU();
 	}
 }
\ No newline at end of file
@@ -4,7 +4,21 @@
 #include "AnimationClip.h"
 #include "AnimationTexture.h"
 
+#include <Utils/JobSystem.h>
+
+#include <cstdint>
+#include <vector>
+
 namespace Animation
 {
-	void bakeAnimationToTexture(const Skeleton& skeleton, AnimationClip& animationClip, AnimationTexture& texture);
+	// Columns are evenly spaced samples over the clip, every joint takes three rows
+	// (position, rotation and scale of its global transform)
+	void bakeAnimationToTexture(const Skeleton& skeleton, const AnimationClip& animationClip, AnimationTexture& texture);
+	void bakeAnimationToTexture(const Skeleton& skeleton, const AnimationClip& animationClip, AnimationTexture& texture, Util::JobSystem& jobSystem);
+
+	// Bakes several clips into one texture, stacked vertically in order, and fills the clip
+	// directory of the texture. outRowOffsets receives the first row of every clip. The
+	// texture grows taller if the clips don't fit.
+	void bakeAnimationsToTexture(const Skeleton& skeleton, const std::vector<AnimationClip>& animationClips, AnimationTexture& texture, std::vector<uint32_t>& outRowOffsets);
+	void bakeAnimationsToTexture(const Skeleton& skeleton, const std::vector<AnimationClip>& animationClips, AnimationTexture& texture, std::vector<uint32_t>& outRowOffsets, Util::JobSystem& jobSystem);
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "AnimationClip.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include <Math/Math.h>
@@ -19,6 +20,7 @@ namespace Animation
 		startTime = 0.0f;
 		endTime = 0.0f;
 		bLooping = true;
+		quaternionInterpolation = QuaternionInterpolation::Nlerp;
 	}
 
 	template <typename TAnimationTransformTrack>
@@ -30,7 +32,20 @@ namespace Animation
 	template <typename TAnimationTransformTrack>
 	void TAnimationClip<TAnimationTransformTrack>::setJointIdAtIndex(uint32_t index, uint32_t jointId)
 	{
-		return transformTracks[index].setJointId(jointId);
+		uint32_t oldJointId = transformTracks[index].getJointId();
+
+		if (getTrackIndex(oldJointId) == static_cast<int32_t>(index))
+		{
+			trackIndices[oldJointId] = -1;
+		}
+
+		if (jointId >= trackIndices.size())
+		{
+			trackIndices.resize(jointId + 1, -1);
+		}
+
+		trackIndices[jointId] = static_cast<int32_t>(index);
+		transformTracks[index].setJointId(jointId);
 	}
 
 	template <typename TAnimationTransformTrack>
@@ -48,38 +63,264 @@ namespace Animation
 		}
 
 		float time = adjustTimeToFitRange(inTime);
+		sampleInRange(outAnimationPose, time, nullptr);
+
+		return time;
+	}
+
+	template <typename TAnimationTransformTrack>
+	float TAnimationClip<TAnimationTransformTrack>::sample(AnimationPose& outAnimationPose, float inTime, const std::vector<bool>& activeJoints) const
+	{
+		if (getDuration() == 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float time = adjustTimeToFitRange(inTime);
+		sampleInRange(outAnimationPose, time, &activeJoints);
+
+		return time;
+	}
+
+	template <typename TAnimationTransformTrack>
+	int64_t TAnimationClip<TAnimationTransformTrack>::sampleAtTick(AnimationPose& outAnimationPose, int64_t tick) const
+	{
+		if (getDuration() == 0.0f)
+		{
+			return 0;
+		}
+
+		int64_t adjustedTick = adjustTickToFitRange(tick);
+		sampleInRange(outAnimationPose, ticksToSeconds(adjustedTick), nullptr);
+
+		return adjustedTick;
+	}
+
+	template <typename TAnimationTransformTrack>
+	int64_t TAnimationClip<TAnimationTransformTrack>::sampleAtTick(AnimationPose& outAnimationPose, int64_t tick, const std::vector<bool>& activeJoints) const
+	{
+		if (getDuration() == 0.0f)
+		{
+			return 0;
+		}
+
+		int64_t adjustedTick = adjustTickToFitRange(tick);
+		sampleInRange(outAnimationPose, ticksToSeconds(adjustedTick), &activeJoints);
+
+		return adjustedTick;
+	}
+
+	template <typename TAnimationTransformTrack>
+	void TAnimationClip<TAnimationTransformTrack>::sampleBatch(const float* times, AnimationPose* outPoses, uint32_t count) const
+	{
+		if (getDuration() == 0.0f)
+		{
+			return;
+		}
+
+		float adjustedTimes[SampleBatchSize];
+		Transform transforms[SampleBatchSize];
 
 		uint32_t trackSize = static_cast<uint32_t>(transformTracks.size());
 
+		for (uint32_t first = 0; first < count; first += SampleBatchSize)
+		{
+			uint32_t batchCount = Min(count - first, SampleBatchSize);
+			AnimationPose* poses = outPoses + first;
+
+			for (uint32_t i = 0; i < batchCount; i++)
+			{
+				adjustedTimes[i] = adjustTimeToFitRange(times[first + i]);
+			}
+
+			for (uint32_t track = 0; track < trackSize; track++)
+			{
+				uint32_t jointId = transformTracks[track].getJointId();
+
+				for (uint32_t i = 0; i < batchCount; i++)
+				{
+					transforms[i] = poses[i].getLocalTransform(jointId);
+				}
+
+				transformTracks[track].sampleInRange(adjustedTimes, transforms, batchCount);
+
+				for (uint32_t i = 0; i < batchCount; i++)
+				{
+					poses[i].setLocalTransform(jointId, transforms[i]);
+				}
+			}
+		}
+	}
+
+	template <typename TAnimationTransformTrack>
+	float TAnimationClip<TAnimationTransformTrack>::sampleJoints(AnimationPose& outAnimationPose, float inTime, const std::vector<uint32_t>& jointIds, bool bIncludeAncestors) const
+	{
+		if (getDuration() == 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float time = adjustTimeToFitRange(inTime);
+
+		// Ancestors shared by several joints are sampled once, a walk stops at the first
+		// joint an earlier one already went through
+		std::vector<bool> sampled;
+
+		if (bIncludeAncestors)
+		{
+			sampled.resize(outAnimationPose.getSize(), false);
+		}
+
+		for (uint32_t jointId : jointIds)
+		{
+			int32_t current = static_cast<int32_t>(jointId);
+
+			// Up the hierarchy when the ancestors are asked for, the joint alone otherwise
+			while (current >= 0)
+			{
+				if (bIncludeAncestors)
+				{
+					if (sampled[current])
+					{
+						break;
+					}
+
+					sampled[current] = true;
+				}
+
+				const Transform& localTransform = outAnimationPose.getLocalTransform(current);
+				outAnimationPose.setLocalTransform(current, sampleJoint(localTransform, time, current));
+
+				current = bIncludeAncestors ? outAnimationPose.getParent(current) : -1;
+			}
+		}
+
+		return time;
+	}
+
+	template <typename TAnimationTransformTrack>
+	Transform TAnimationClip<TAnimationTransformTrack>::sampleGlobalTransform(const AnimationPose& referencePose, float inTime, uint32_t jointId) const
+	{
+		// Like sample, a clip without duration leaves the pose as it is
+		if (getDuration() == 0.0f)
+		{
+			return referencePose.getGlobalTransform(jointId);
+		}
+
+		float time = adjustTimeToFitRange(inTime);
+
+		Transform result = sampleJoint(referencePose.getLocalTransform(jointId), time, jointId);
+
+		for (int32_t parentId = referencePose.getParent(jointId); parentId >= 0; parentId = referencePose.getParent(parentId))
+		{
+			result = combine(sampleJoint(referencePose.getLocalTransform(parentId), time, parentId), result);
+		}
+
+		return result;
+	}
+
+	template <typename TAnimationTransformTrack>
+	Transform TAnimationClip<TAnimationTransformTrack>::sampleJoint(const Transform& reference, float time, uint32_t jointId) const
+	{
+		int32_t trackIndex = getTrackIndex(jointId);
+
+		if (trackIndex < 0)
+		{
+			return reference;
+		}
+
+		return transformTracks[trackIndex].sampleInRange(reference, time);
+	}
+
+	template <typename TAnimationTransformTrack>
+	void TAnimationClip<TAnimationTransformTrack>::sampleInRange(AnimationPose& outAnimationPose, float time, const std::vector<bool>* activeJoints) const
+	{
+		uint32_t trackSize = static_cast<uint32_t>(transformTracks.size());
+
 		for (uint32_t i = 0; i < trackSize; i++)
 		{
 			uint32_t jointId = transformTracks[i].getJointId();
+
+			if (activeJoints != nullptr && (jointId >= activeJoints->size() || !(*activeJoints)[jointId]))
+			{
+				continue;
+			}
+
 			Transform localTransform = outAnimationPose.getLocalTransform(jointId);
-			Transform animatedTransform = transformTracks[i].sample(localTransform, time, bLooping);
+			Transform animatedTransform = transformTracks[i].sampleInRange(localTransform, time);
 			outAnimationPose.setLocalTransform(jointId, animatedTransform);
 		}
-
-		return time;
 	}
 
 	template <typename TAnimationTransformTrack>
 	TAnimationTransformTrack& TAnimationClip<TAnimationTransformTrack>::operator[](uint32_t jointId)
 	{
+		int32_t trackIndex = getTrackIndex(jointId);
+
+		if (trackIndex >= 0)
+		{
+			return transformTracks[trackIndex];
+		}
+
+		if (jointId >= trackIndices.size())
+		{
+			trackIndices.resize(jointId + 1, -1);
+		}
+
+		// Keep the tracks sorted by joint id. Loaders usually go through the joints in order,
+		// then the new track simply goes at the end.
+		auto position = std::lower_bound(transformTracks.begin(), transformTracks.end(), jointId,
+			[](const TAnimationTransformTrack& track, uint32_t id) { return track.getJointId() < id; });
+
+		uint32_t newIndex = static_cast<uint32_t>(position - transformTracks.begin());
+		transformTracks.emplace(position, TAnimationTransformTrack());
+
+		TAnimationTransformTrack& transformTrack = transformTracks[newIndex];
+		transformTrack.setJointId(jointId);
+		transformTrack.getRotationTrack().setQuaternionInterpolation(quaternionInterpolation);
+
 		uint32_t trackSize = static_cast<uint32_t>(transformTracks.size());
+
+		for (uint32_t i = newIndex; i < trackSize; i++)
+		{
+			trackIndices[transformTracks[i].getJointId()] = static_cast<int32_t>(i);
+		}
 		
+		return transformTrack;
+	}
+
+	template <typename TAnimationTransformTrack>
+	void TAnimationClip<TAnimationTransformTrack>::sortTracks()
+	{
+		std::stable_sort(transformTracks.begin(), transformTracks.end(),
+			[](const TAnimationTransformTrack& a, const TAnimationTransformTrack& b) { return a.getJointId() < b.getJointId(); });
+
+		trackIndices.assign(trackIndices.size(), -1);
+
+		uint32_t trackSize = static_cast<uint32_t>(transformTracks.size());
+
 		for (uint32_t i = 0; i < trackSize; i++)
 		{
-			if (transformTracks[i].getJointId() == jointId)
+			uint32_t jointId = transformTracks[i].getJointId();
+
+			if (jointId >= trackIndices.size())
 			{
-				return transformTracks[i];
+				trackIndices.resize(jointId + 1, -1);
 			}
+
+			trackIndices[jointId] = static_cast<int32_t>(i);
 		}
+	}
 
-		transformTracks.emplace_back(TAnimationTransformTrack());
-		TAnimationTransformTrack& transformTrack = transformTracks[transformTracks.size() - 1];
-		transformTrack.setJointId(jointId);
-		
-		return transformTrack;
+	template <typename TAnimationTransformTrack>
+	int32_t TAnimationClip<TAnimationTransformTrack>::getTrackIndex(uint32_t jointId) const
+	{
+		if (jointId >= trackIndices.size())
+		{
+			return -1;
+		}
+
+		return trackIndices[jointId];
 	}
 
 	template <typename TAnimationTransformTrack>
@@ -154,6 +395,23 @@ namespace Animation
 		bLooping = bInLooping;
 	}
 
+	template <typename TAnimationTransformTrack>
+	QuaternionInterpolation TAnimationClip<TAnimationTransformTrack>::getQuaternionInterpolation() const
+	{
+		return quaternionInterpolation;
+	}
+
+	template <typename TAnimationTransformTrack>
+	void TAnimationClip<TAnimationTransformTrack>::setQuaternionInterpolation(QuaternionInterpolation inQuaternionInterpolation)
+	{
+		quaternionInterpolation = inQuaternionInterpolation;
+
+		for (TAnimationTransformTrack& transformTrack : transformTracks)
+		{
+			transformTrack.getRotationTrack().setQuaternionInterpolation(quaternionInterpolation);
+		}
+	}
+
 	template <typename TAnimationTransformTrack>
 	float TAnimationClip<TAnimationTransformTrack>::adjustTimeToFitRange(float time) const
 	{
@@ -193,17 +451,55 @@ namespace Animation
 		return adjustedTime;
 	}
 
+	template <typename TAnimationTransformTrack>
+	int64_t TAnimationClip<TAnimationTransformTrack>::adjustTickToFitRange(int64_t tick) const
+	{
+		int64_t startTick = getStartTick();
+		int64_t endTick = getEndTick();
+
+		if (bLooping)
+		{
+			return endTick > startTick ? wrapTick(tick, startTick, endTick - startTick) : startTick;
+		}
+
+		if (tick < startTick)
+		{
+			return startTick;
+		}
+
+		if (tick > endTick)
+		{
+			return endTick;
+		}
+
+		return tick;
+	}
+
+	template <typename TAnimationTransformTrack>
+	int64_t TAnimationClip<TAnimationTransformTrack>::getStartTick() const
+	{
+		return secondsToTicks(startTime);
+	}
+
+	template <typename TAnimationTransformTrack>
+	int64_t TAnimationClip<TAnimationTransformTrack>::getEndTick() const
+	{
+		return secondsToTicks(endTime);
+	}
+
 	FastAnimationClip optimizeAnimationClip(AnimationClip& input)
 	{
 		FastAnimationClip result;
 		result.setName(input.getName());
 		result.setLooping(input.isLooping());
+		result.setQuaternionInterpolation(input.getQuaternionInterpolation());
 
 		uint32_t size = input.getSize();
 		for (uint32_t i = 0; i < size; i++)
 		{
 			uint32_t jointId = input.getJointIdAtIndex(i);
 			result[jointId] = optimizeAnimationTransformTrack(input[jointId]);
+			result[jointId].getRotationTrack().precondition();
 		}
 
 		result.recalculateDuration();
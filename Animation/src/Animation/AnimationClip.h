@@ -15,13 +15,44 @@ namespace Animation
 	public:
 		TAnimationClip();
 		
+		// The tracks are sorted by joint id, so sampling writes the joints of a pose in order.
+		// setJointIdAtIndex leaves them where they are, call sortTracks once all the ids are
+		// changed.
 		uint32_t getJointIdAtIndex(uint32_t index) const;
 		void setJointIdAtIndex(uint32_t index, uint32_t jointId);
+		void sortTracks();
 		uint32_t getSize() const;
 
 		float sample(AnimationPose& outAnimationPose, float inTime) const;
+
+		// Only samples the tracks of joints set in activeJoints, see SkeletonLOD
+		float sample(AnimationPose& outAnimationPose, float inTime, const std::vector<bool>& activeJoints) const;
+
+		// Same with integer tick time, see AnimationTick.h. Returns the tick that was sampled,
+		// wrapped or clamped into the range of the clip.
+		int64_t sampleAtTick(AnimationPose& outAnimationPose, int64_t tick) const;
+		int64_t sampleAtTick(AnimationPose& outAnimationPose, int64_t tick, const std::vector<bool>& activeJoints) const;
+
+		// Samples count instances playing the clip at their own times, one pose each. Goes
+		// track by track, so the keys of a track stay in cache while they serve every
+		// instance, and interpolates each track for all instances at once.
+		void sampleBatch(const float* times, AnimationPose* outPoses, uint32_t count) const;
+
+		// Only samples the tracks of the given joints, for queries like the hand of an
+		// attachment. With bIncludeAncestors the parents of every joint are sampled as well,
+		// so getGlobalTransform of the joints is right afterwards.
+		float sampleJoints(AnimationPose& outAnimationPose, float inTime, const std::vector<uint32_t>& jointIds, bool bIncludeAncestors = false) const;
+
+		// Global transform of one joint at a time, sampling the joint and its ancestors.
+		// Joints without a track keep the transform of the reference pose, which is not
+		// modified.
+		Transform sampleGlobalTransform(const AnimationPose& referencePose, float inTime, uint32_t jointId) const;
+
 		TAnimationTransformTrack& operator[](uint32_t jointId);
 
+		// Index of the track of a joint, -1 if the clip doesn't animate it
+		int32_t getTrackIndex(uint32_t jointId) const;
+
 		void recalculateDuration();
 		std::string getName() const;
 		void setName(const std::string& newName);
@@ -30,16 +61,37 @@ namespace Animation
 		float getEndTime() const;
 		bool isLooping() const;
 		void setLooping(bool bInLooping);
-		
-	protected:
+
+		// Interpolation of the linear rotation tracks, set on all of them including the
+		// ones added later
+		QuaternionInterpolation getQuaternionInterpolation() const;
+		void setQuaternionInterpolation(QuaternionInterpolation inQuaternionInterpolation);
+
+		// Wraps (looping) or clamps time into the range of the clip, as sample does
 		float adjustTimeToFitRange(float time) const;
+		int64_t adjustTickToFitRange(int64_t tick) const;
+
+		int64_t getStartTick() const;
+		int64_t getEndTick() const;
 		
+	protected:
+		// Time already in the range of the clip. Tracks of joints that aren't set in
+		// activeJoints are skipped, all of them are sampled without it.
+		void sampleInRange(AnimationPose& outAnimationPose, float time, const std::vector<bool>* activeJoints) const;
+
+		Transform sampleJoint(const Transform& reference, float time, uint32_t jointId) const;
+
 	protected:
 		std::vector<TAnimationTransformTrack> transformTracks;
+
+		// Track index of every joint id, -1 for joints without a track. Kept up to date by
+		// operator[], which makes building a clip linear in the number of joints.
+		std::vector<int32_t> trackIndices;
 		std::string name;
 		float startTime;
 		float endTime;
 		bool bLooping;
+		QuaternionInterpolation quaternionInterpolation;
 	};
 
 	using AnimationClip = TAnimationClip<AnimationTransformTrack>;
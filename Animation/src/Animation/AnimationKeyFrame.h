@@ -14,6 +14,18 @@ namespace Animation
 		float time;
 	};
 
+	// Cubic Hermite segment between two keyframes in power basis, a * t^3 + b * t^2 + c * t + d
+	// per component with t from 0 to 1 over the segment
+	template <int32_t N>
+	class HermiteSegment
+	{
+	public:
+		float a[N];
+		float b[N];
+		float c[N];
+		float d[N];
+	};
+
 	using ScalarKeyFrame = AnimationKeyFrame<1>;
 	using VectorKeyFrame = AnimationKeyFrame<2>;
 	using QuaternionKeyFrame = AnimationKeyFrame<4>;
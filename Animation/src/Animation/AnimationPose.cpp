@@ -93,6 +93,45 @@ namespace Animation
 		return result;
 	}
 
+	void AnimationPose::getGlobalTransforms(std::vector<Transform>& out) const
+	{
+		uint32_t size = getSize();
+
+		if (out.size() != size)
+		{
+			out.resize(size);
+		}
+
+		if (size != 0)
+		{
+			getGlobalTransforms(&out[0]);
+		}
+	}
+
+	void AnimationPose::getGlobalTransforms(Transform* out) const
+	{
+		uint32_t size = getSize();
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			int32_t parent = parents[i];
+
+			if (parent > static_cast<int32_t>(i))
+			{
+				// Parent not computed yet, walk the hierarchy instead
+				out[i] = getGlobalTransform(i);
+			}
+			else if (parent >= 0)
+			{
+				out[i] = combine(out[parent], joints[i]);
+			}
+			else
+			{
+				out[i] = joints[i];
+			}
+		}
+	}
+
 	const Transform AnimationPose::operator[](uint32_t index) const
 	{
 		return getGlobalTransform(index);
@@ -107,6 +146,16 @@ namespace Animation
 			out.resize(size);
 		}
 
+		if (size != 0)
+		{
+			getMatrixPalette(&out[0]);
+		}
+	}
+
+	void AnimationPose::getMatrixPalette(Matrix4* out) const
+	{
+		uint32_t size = getSize();
+
 		// Slow path
 #if 0
 		for (uint32_t i = 0; i < size; i++)
@@ -128,8 +177,59 @@ namespace Animation
 				break;
 			}
 
-			Matrix4 global = transformToMatrix4(joints[i]);
+			// Joint matrices are affine, the local one only needs its top three rows
+			Matrix3x4 local = transformToMatrix3x4(joints[i]);
 			
+			if (parent >= 0)
+			{
+				out[i] = multiplyAffine(out[parent], local);
+			}
+			else
+			{
+				out[i] = toMatrix4(local);
+			}
+		}
+
+		// Joints whose parent comes after them fall back to walking the hierarchy
+		for (uint32_t j = i; j < size; j++)
+		{
+			Transform globalTransform = getGlobalTransform(j);
+			out[j] = transformToMatrix4(globalTransform);
+		}
+#endif
+	}
+
+	void AnimationPose::getMatrixPalette(std::vector<Matrix3x4>& out) const
+	{
+		uint32_t size = getSize();
+
+		if (out.size() != size)
+		{
+			out.resize(size);
+		}
+
+		if (size != 0)
+		{
+			getMatrixPalette(&out[0]);
+		}
+	}
+
+	void AnimationPose::getMatrixPalette(Matrix3x4* out) const
+	{
+		uint32_t size = getSize();
+		uint32_t i = 0;
+
+		for (i = 0; i < size; i++)
+		{
+			int32_t parent = parents[i];
+
+			if (parent > static_cast<int32_t>(i))
+			{
+				break;
+			}
+
+			Matrix3x4 global = transformToMatrix3x4(joints[i]);
+
 			if (parent >= 0)
 			{
 				global = out[parent] * global;
@@ -138,14 +238,35 @@ namespace Animation
 			out[i] = global;
 		}
 
-		uint32_t j = i;
+		// Joints whose parent comes after them fall back to walking the hierarchy
+		for (uint32_t j = i; j < size; j++)
+		{
+			out[j] = transformToMatrix3x4(getGlobalTransform(j));
+		}
+	}
+
+	void AnimationPose::getSkinningPalette(const std::vector<Matrix3x4>& inverseBindPose, Matrix3x4* out) const
+	{
+		getMatrixPalette(out);
+
+		uint32_t size = getSize();
 
-		for (j = 0; j < size; j++)
+		for (uint32_t i = 0; i < size; i++)
 		{
-			Transform globalTransform = getGlobalTransform(j);
-			out[j] = transformToMatrix4(globalTransform);
+			out[i] = out[i] * inverseBindPose[i];
+		}
+	}
+
+	void AnimationPose::getSkinningPalette(const std::vector<Matrix3x4>& inverseBindPose, Matrix4* out) const
+	{
+		getMatrixPalette(out);
+
+		uint32_t size = getSize();
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			out[i] = multiplyAffine(out[i], inverseBindPose[i]);
 		}
-#endif
 	}
 
 	void AnimationPose::getDualQuaternionPalette(std::vector<DualQuaternion>& out)
@@ -227,5 +348,4 @@ namespace Animation
 
 		return true;
 	}
-}
-
+}
\ No newline at end of file
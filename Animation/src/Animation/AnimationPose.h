@@ -30,9 +30,23 @@ namespace Animation
 		void setLocalTransform(uint32_t index, const Transform& transform);
 
 		Transform getGlobalTransform(uint32_t index) const;
+
+		// Global transforms of every joint in one pass over the hierarchy. Rotations and
+		// scales match getGlobalTransform. Positions drift from it by the order of the
+		// non-uniform scale of the ancestors (1e-4 on Woman.gltf), combine doesn't
+		// associate then. The translations of getMatrixPalette are exact.
+		void getGlobalTransforms(std::vector<Transform>& out) const;
+		void getGlobalTransforms(Transform* out) const;
 		const Transform operator[](uint32_t index) const;
 
 		void getMatrixPalette(std::vector<Matrix4>& out) const;
+		void getMatrixPalette(Matrix4* out) const;
+		void getMatrixPalette(std::vector<Matrix3x4>& out) const;
+		void getMatrixPalette(Matrix3x4* out) const;
+
+		// Global matrices times the inverse bind pose, what skinning needs
+		void getSkinningPalette(const std::vector<Matrix3x4>& inverseBindPose, Matrix3x4* out) const;
+		void getSkinningPalette(const std::vector<Matrix3x4>& inverseBindPose, Matrix4* out) const;
 
 		void getDualQuaternionPalette(std::vector<DualQuaternion>& out);
 		DualQuaternion getGlobalDualQuaternion(uint32_t index);
@@ -0,0 +1,707 @@
+#include "AnimationSystem.h"
+#include "Blending.h"
+
+#include <Math/Math.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace Animation
+{
+	template AnimationSystem<AnimationClip>;
+	template AnimationSystem<FastAnimationClip>;
+
+	namespace AnimationSystemHelpers
+	{
+		inline int64_t scaleTicks(int64_t ticks, float scale)
+		{
+			return std::llround(static_cast<double>(ticks) * scale);
+		}
+	}
+
+	template <typename TAnimationClip>
+	AnimationSystem<TAnimationClip>::AnimationSystem()
+	{
+		skeleton = nullptr;
+		animationClips = nullptr;
+		poseCache = nullptr;
+		skinPaletteCache = nullptr;
+		numAnimationClips = 0;
+		numJoints = 0;
+
+		lodDistances[0] = 0.0f;
+
+		for (uint32_t i = 1; i < NumLODLevels; i++)
+		{
+			lodDistances[i] = std::numeric_limits<float>::max();
+		}
+
+		frameIndex = 0;
+		averageSampleTime = 0.0f;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setSkeleton(const Skeleton& inSkeleton)
+	{
+		skeleton = &inSkeleton;
+		numJoints = skeleton->getRestPose().getSize();
+
+		animationPose = skeleton->getRestPose();
+		fadePose = skeleton->getRestPose();
+		workerPoses.clear();
+
+		palettes.resize(instances.size() * numJoints);
+		sampledPoses.resize(instances.size() * numJoints * 2);
+
+		for (auto& instance : instances)
+		{
+			instance.bSampled = false;
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setAnimationClips(const std::vector<TAnimationClip>& inAnimationClips)
+	{
+		animationClips = inAnimationClips.size() > 0 ? &inAnimationClips[0] : nullptr;
+		numAnimationClips = static_cast<uint32_t>(inAnimationClips.size());
+		bucketOffsets.resize(numAnimationClips * NumLODLevels * NumUpdateKinds + 1);
+
+		// Instances playing clips that are gone fall back to the first one
+		for (auto& instance : instances)
+		{
+			if (!isValidClip(instance.clip))
+			{
+				spdlog::error("AnimationSystem::setAnimationClips: clip {} of an instance is out of range, playing clip 0", instance.clip);
+				instance.clip = 0;
+				instance.tick = numAnimationClips > 0 ? animationClips[0].getStartTick() : 0;
+				instance.bSampled = false;
+			}
+
+			if (instance.fadeClip >= 0 && !isValidClip(static_cast<uint32_t>(instance.fadeClip)))
+			{
+				instance.fadeClip = -1;
+			}
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::reserve(uint32_t numInstances)
+	{
+		instances.reserve(numInstances);
+		sortedInstances.reserve(numInstances);
+		instanceBuckets.reserve(numInstances);
+		palettes.reserve(numInstances * numJoints);
+		sampledPoses.reserve(numInstances * numJoints * 2);
+	}
+
+	template <typename TAnimationClip>
+	uint32_t AnimationSystem<TAnimationClip>::addInstance(uint32_t clip, float time, float playbackSpeed)
+	{
+		if (!isValidClip(clip))
+		{
+			spdlog::error("AnimationSystem::addInstance: clip {} is out of range, there are {} clips", clip, numAnimationClips);
+			return InvalidInstance;
+		}
+
+		uint32_t index = static_cast<uint32_t>(instances.size());
+
+		AnimationSystemInstance instance;
+		instance.clip = clip;
+		instance.tick = secondsToTicks(time);
+		instance.playbackSpeed = playbackSpeed;
+
+		instances.emplace_back(instance);
+		sortedInstances.resize(instances.size());
+		instanceBuckets.resize(instances.size());
+		palettes.resize(instances.size() * numJoints);
+		sampledPoses.resize(instances.size() * numJoints * 2);
+
+		setDistance(index, 0.0f);
+
+		return index;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::clear()
+	{
+		instances.clear();
+		sortedInstances.clear();
+		instanceBuckets.clear();
+		palettes.clear();
+		sampledPoses.clear();
+	}
+
+	template <typename TAnimationClip>
+	uint32_t AnimationSystem<TAnimationClip>::getNumInstances() const
+	{
+		return static_cast<uint32_t>(instances.size());
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::play(uint32_t instance, uint32_t clip, float time)
+	{
+		if (!isValidClip(clip))
+		{
+			spdlog::error("AnimationSystem::play: clip {} is out of range, there are {} clips", clip, numAnimationClips);
+			return;
+		}
+
+		AnimationSystemInstance& target = instances[instance];
+		target.clip = clip;
+		target.tick = secondsToTicks(time);
+		target.fadeClip = -1;
+
+		// Don't interpolate from the pose of the previous clip
+		target.pendingDeltaTicks = 0;
+		target.bSampled = false;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::fadeTo(uint32_t instance, uint32_t clip, float fadeTime)
+	{
+		if (!isValidClip(clip))
+		{
+			spdlog::error("AnimationSystem::fadeTo: clip {} is out of range, there are {} clips", clip, numAnimationClips);
+			return;
+		}
+
+		AnimationSystemInstance& target = instances[instance];
+
+		// Each instance fades to one clip at a time. A new fade cuts the running one short.
+		if (target.fadeClip >= 0)
+		{
+			if (target.fadeClip == static_cast<int32_t>(clip))
+			{
+				return;
+			}
+
+			target.clip = static_cast<uint32_t>(target.fadeClip);
+			target.tick = target.fadeTick;
+			target.fadeClip = -1;
+		}
+
+		if (target.clip == clip)
+		{
+			return;
+		}
+
+		target.fadeClip = static_cast<int32_t>(clip);
+		target.fadeTick = animationClips[clip].getStartTick();
+		target.fadeDuration = fadeTime;
+		target.fadeElapsed = 0.0f;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setPlaybackSpeed(uint32_t instance, float playbackSpeed)
+	{
+		instances[instance].playbackSpeed = playbackSpeed;
+	}
+
+	template <typename TAnimationClip>
+	const AnimationSystemInstance& AnimationSystem<TAnimationClip>::getInstance(uint32_t instance) const
+	{
+		return instances[instance];
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setLODDistances(float level1Distance, float level2Distance, float level3Distance)
+	{
+		lodDistances[1] = level1Distance;
+		lodDistances[2] = level2Distance;
+		lodDistances[3] = level3Distance;
+
+		uint32_t numInstances = static_cast<uint32_t>(instances.size());
+
+		for (uint32_t i = 0; i < numInstances; i++)
+		{
+			setDistance(i, instances[i].distance);
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setDistance(uint32_t instance, float distance)
+	{
+		AnimationSystemInstance& target = instances[instance];
+		target.distance = distance;
+		target.lodLevel = 0;
+
+		for (uint32_t i = NumLODLevels - 1; i > 0; i--)
+		{
+			if (distance >= lodDistances[i])
+			{
+				target.lodLevel = i;
+				break;
+			}
+		}
+	}
+
+	template <typename TAnimationClip>
+	const AnimationLODStats& AnimationSystem<TAnimationClip>::getLODStats(uint32_t level) const
+	{
+		return lodStats[level];
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setSkeletonLOD(uint32_t instance, const SkeletonLOD* skeletonLOD)
+	{
+		instances[instance].skeletonLOD = skeletonLOD;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setPoseCache(PoseCache<TAnimationClip>* inPoseCache)
+	{
+		poseCache = inPoseCache;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setSkinPaletteCache(SkinPaletteCache<TAnimationClip>* inSkinPaletteCache)
+	{
+		skinPaletteCache = inSkinPaletteCache;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::setBakedPlayback(uint32_t instance, bool bBakedPlayback)
+	{
+		instances[instance].bBakedPlayback = bBakedPlayback;
+		instances[instance].bSampled = false;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::update(float deltaTime)
+	{
+		updateTicks(secondsToTicks(deltaTime));
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::updateTicks(int64_t deltaTicks)
+	{
+		if (skeleton == nullptr || animationClips == nullptr)
+		{
+			return;
+		}
+
+		beginUpdate(1);
+		bakeClips();
+		groupInstances();
+
+		updateInstances(0, static_cast<uint32_t>(sortedInstances.size()), deltaTicks, animationPose, fadePose, &workerStats[0]);
+
+		endUpdate();
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::update(float deltaTime, Util::JobSystem& jobSystem, uint32_t batchSize)
+	{
+		updateTicks(secondsToTicks(deltaTime), jobSystem, batchSize);
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::updateTicks(int64_t deltaTicks, Util::JobSystem& jobSystem, uint32_t batchSize)
+	{
+		if (skeleton == nullptr || animationClips == nullptr)
+		{
+			return;
+		}
+
+		beginUpdate(jobSystem.getNumWorkers());
+		bakeClips();
+		groupInstances();
+
+		uint32_t numWorkerPoses = jobSystem.getNumWorkers() * 2;
+
+		if (workerPoses.size() < numWorkerPoses)
+		{
+			workerPoses.resize(numWorkerPoses, skeleton->getRestPose());
+		}
+
+		jobSystem.parallelFor(static_cast<uint32_t>(sortedInstances.size()), batchSize,
+			[this, deltaTicks](uint32_t begin, uint32_t end, uint32_t workerIndex)
+		{
+			updateInstances(begin, end, deltaTicks, workerPoses[workerIndex * 2], workerPoses[workerIndex * 2 + 1], &workerStats[workerIndex * NumLODLevels]);
+		});
+
+		endUpdate();
+	}
+
+	template <typename TAnimationClip>
+	uint32_t AnimationSystem<TAnimationClip>::getPaletteStride() const
+	{
+		return numJoints;
+	}
+
+	template <typename TAnimationClip>
+	const Matrix3x4* AnimationSystem<TAnimationClip>::getPalette(uint32_t instance) const
+	{
+		return &palettes[instance * numJoints];
+	}
+
+	template <typename TAnimationClip>
+	const std::vector<Matrix3x4>& AnimationSystem<TAnimationClip>::getPalettes() const
+	{
+		return palettes;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::beginUpdate(uint32_t numWorkers)
+	{
+		workerStats.assign(numWorkers * NumLODLevels, AnimationLODStats());
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::bakeClips()
+	{
+		bakedClips.assign(numAnimationClips, false);
+
+		if (skinPaletteCache == nullptr)
+		{
+			return;
+		}
+
+		// Serial, so the instance updates only ever read the cache
+		for (const auto& instance : instances)
+		{
+			if (instance.bBakedPlayback && instance.fadeClip < 0)
+			{
+				bakedClips[instance.clip] = true;
+			}
+		}
+
+		// The clips baked already are kept first, bake only marks them as used. New clips are
+		// baked while they fit next to them, so a bake never evicts a clip used this frame
+		// and a working set larger than the budget doesn't rebake clips every frame.
+		size_t frameUsage = 0;
+
+		for (uint32_t clip = 0; clip < numAnimationClips; clip++)
+		{
+			if (bakedClips[clip] && skinPaletteCache->findBakedClip(animationClips[clip]) != nullptr)
+			{
+				skinPaletteCache->bake(animationClips[clip]);
+				frameUsage += skinPaletteCache->getBakedSize(animationClips[clip]);
+			}
+		}
+
+		for (uint32_t clip = 0; clip < numAnimationClips; clip++)
+		{
+			if (!bakedClips[clip] || skinPaletteCache->findBakedClip(animationClips[clip]) != nullptr)
+			{
+				continue;
+			}
+
+			size_t size = skinPaletteCache->getBakedSize(animationClips[clip]);
+
+			if (frameUsage + size <= skinPaletteCache->getMemoryBudget() && skinPaletteCache->bake(animationClips[clip]) != nullptr)
+			{
+				frameUsage += size;
+			}
+			else
+			{
+				bakedClips[clip] = false;
+			}
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::endUpdate()
+	{
+		uint32_t numWorkers = static_cast<uint32_t>(workerStats.size()) / NumLODLevels;
+		uint32_t numSampled = 0;
+		float sampleTime = 0.0f;
+
+		for (uint32_t level = 0; level < NumLODLevels; level++)
+		{
+			AnimationLODStats& stats = lodStats[level];
+			stats = AnimationLODStats();
+
+			for (uint32_t worker = 0; worker < numWorkers; worker++)
+			{
+				const AnimationLODStats& other = workerStats[worker * NumLODLevels + level];
+				stats.numInstances += other.numInstances;
+				stats.numSampled += other.numSampled;
+				stats.numInterpolated += other.numInterpolated;
+				stats.sampleTime += other.sampleTime;
+				stats.interpolateTime += other.interpolateTime;
+			}
+
+			numSampled += stats.numSampled;
+			sampleTime += stats.sampleTime;
+		}
+
+		// Keep the last known cost when nothing was sampled this frame
+		if (numSampled > 0)
+		{
+			averageSampleTime = sampleTime / numSampled;
+		}
+
+		for (uint32_t level = 0; level < NumLODLevels; level++)
+		{
+			AnimationLODStats& stats = lodStats[level];
+			stats.savedTime = stats.numInterpolated * averageSampleTime - stats.interpolateTime;
+		}
+
+		frameIndex++;
+	}
+
+	template <typename TAnimationClip>
+	bool AnimationSystem<TAnimationClip>::isValidClip(uint32_t clip) const
+	{
+		return clip < numAnimationClips;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::groupInstances()
+	{
+		uint32_t numInstances = static_cast<uint32_t>(instances.size());
+		uint32_t numBuckets = static_cast<uint32_t>(bucketOffsets.size()) - 1;
+
+		for (uint32_t i = 0; i <= numBuckets; i++)
+		{
+			bucketOffsets[i] = 0;
+		}
+
+		for (uint32_t i = 0; i < numInstances; i++)
+		{
+			const AnimationSystemInstance& instance = instances[i];
+			UpdateKind kind = UpdateKind::Sampled;
+
+			if (instance.bBakedPlayback && instance.fadeClip < 0 && bakedClips[instance.clip])
+			{
+				kind = UpdateKind::Baked;
+			}
+			else if (instance.bSampled && ((frameIndex + i) & ((1u << instance.lodLevel) - 1)) != 0)
+			{
+				kind = UpdateKind::Interpolated;
+			}
+
+			uint32_t bucket = (instance.clip * NumLODLevels + instance.lodLevel) * NumUpdateKinds + static_cast<uint32_t>(kind);
+			instanceBuckets[i] = bucket;
+			bucketOffsets[bucket + 1]++;
+		}
+
+		for (uint32_t i = 0; i < numBuckets; i++)
+		{
+			bucketOffsets[i + 1] += bucketOffsets[i];
+		}
+
+		// bucketOffsets[bucket] is used as the insertion cursor and ends up at the end of the
+		// bucket's range, which is the start of the next one
+		for (uint32_t i = 0; i < numInstances; i++)
+		{
+			sortedInstances[bucketOffsets[instanceBuckets[i]]++] = i;
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::updateInstances(uint32_t begin, uint32_t end, int64_t deltaTicks, AnimationPose& scratchPose, AnimationPose& scratchFadePose, AnimationLODStats* stats)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		uint32_t i = begin;
+
+		// One clock read per run of a bucket, a batch may start or end in the middle of one
+		while (i < end)
+		{
+			uint32_t bucket = instanceBuckets[sortedInstances[i]];
+			uint32_t runEnd = Min(bucketOffsets[bucket], end);
+			uint32_t level = (bucket / NumUpdateKinds) % NumLODLevels;
+			UpdateKind kind = static_cast<UpdateKind>(bucket % NumUpdateKinds);
+			AnimationLODStats& levelStats = stats[level];
+
+			Clock::time_point start = Clock::now();
+
+			for (; i < runEnd; i++)
+			{
+				updateInstance(sortedInstances[i], kind, deltaTicks, scratchPose, scratchFadePose, levelStats);
+			}
+
+			float elapsed = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+			if (kind == UpdateKind::Sampled)
+			{
+				levelStats.sampleTime += elapsed;
+			}
+			else if (kind == UpdateKind::Interpolated)
+			{
+				levelStats.interpolateTime += elapsed;
+			}
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::updateInstance(uint32_t index, UpdateKind kind, int64_t deltaTicks, AnimationPose& scratchPose, AnimationPose& scratchFadePose, AnimationLODStats& levelStats)
+	{
+		AnimationSystemInstance& instance = instances[index];
+		levelStats.numInstances++;
+
+		if (kind == UpdateKind::Baked)
+		{
+			const TAnimationClip& animationClip = animationClips[instance.clip];
+			int64_t tick = animationClip.adjustTickToFitRange(instance.tick + AnimationSystemHelpers::scaleTicks(deltaTicks, instance.playbackSpeed));
+
+			if (skinPaletteCache->samplePalette(animationClip, ticksToSeconds(tick), &palettes[index * numJoints]))
+			{
+				instance.tick = tick;
+				instance.bSampled = false;
+				return;
+			}
+
+			kind = UpdateKind::Sampled;
+		}
+
+		uint32_t interval = 1u << instance.lodLevel;
+		bool bSample = kind == UpdateKind::Sampled;
+
+		instance.pendingDeltaTicks += deltaTicks;
+
+		// Sampled every frame, nothing to interpolate from. bSampled stays false so moving
+		// to a lower rate starts both buffered poses from a fresh sample.
+		if (interval == 1)
+		{
+			sampleInstance(index, instance.pendingDeltaTicks, scratchPose, scratchFadePose);
+			writePalette(index, scratchPose);
+
+			instance.pendingDeltaTicks = 0;
+			instance.framesSinceUpdate = 0;
+			instance.bSampled = false;
+			levelStats.numSampled++;
+			return;
+		}
+
+		Transform* previous = &sampledPoses[index * numJoints * 2];
+		Transform* current = previous + numJoints;
+
+		if (bSample)
+		{
+			sampleInstance(index, instance.pendingDeltaTicks, scratchPose, scratchFadePose);
+
+			if (instance.bSampled)
+			{
+				std::copy(current, current + numJoints, previous);
+			}
+
+			for (uint32_t i = 0; i < numJoints; i++)
+			{
+				current[i] = scratchPose.getLocalTransform(i);
+			}
+
+			if (!instance.bSampled)
+			{
+				std::copy(current, current + numJoints, previous);
+			}
+
+			instance.pendingDeltaTicks = 0;
+			instance.framesSinceUpdate = 0;
+			instance.bSampled = true;
+		}
+		else
+		{
+			instance.framesSinceUpdate++;
+		}
+
+		// Blend from the previous to the current sample over the interval, reaching the
+		// current one right before the next sample
+		float t = static_cast<float>(instance.framesSinceUpdate + 1) / interval;
+
+		if (t < 1.0f)
+		{
+			for (uint32_t i = 0; i < numJoints; i++)
+			{
+				scratchPose.setLocalTransform(i, lerp(previous[i], current[i], t));
+			}
+		}
+		else if (!bSample)
+		{
+			for (uint32_t i = 0; i < numJoints; i++)
+			{
+				scratchPose.setLocalTransform(i, current[i]);
+			}
+		}
+
+		writePalette(index, scratchPose);
+
+		if (bSample)
+		{
+			levelStats.numSampled++;
+		}
+		else
+		{
+			levelStats.numInterpolated++;
+		}
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::sampleInstance(uint32_t index, int64_t deltaTicks, AnimationPose& scratchPose, AnimationPose& scratchFadePose)
+	{
+		AnimationSystemInstance& instance = instances[index];
+		const AnimationPose& restPose = skeleton->getRestPose();
+		int64_t scaledDeltaTicks = AnimationSystemHelpers::scaleTicks(deltaTicks, instance.playbackSpeed);
+
+		scratchPose = restPose;
+		instance.tick = sampleClip(instance, instance.clip, scratchPose, instance.tick + scaledDeltaTicks);
+
+		if (instance.fadeClip >= 0)
+		{
+			scratchFadePose = restPose;
+			instance.fadeTick = sampleClip(instance, instance.fadeClip, scratchFadePose, instance.fadeTick + scaledDeltaTicks);
+
+			// Fades are short, their progress stays in seconds
+			instance.fadeElapsed += ticksToSeconds(scaledDeltaTicks);
+
+			float t = instance.fadeDuration > 0.0f ? instance.fadeElapsed / instance.fadeDuration : 1.0f;
+
+			if (t >= 1.0f)
+			{
+				t = 1.0f;
+				instance.clip = static_cast<uint32_t>(instance.fadeClip);
+				instance.tick = instance.fadeTick;
+				instance.fadeClip = -1;
+			}
+
+			blend(scratchPose, scratchPose, scratchFadePose, t, -1);
+		}
+	}
+
+	template <typename TAnimationClip>
+	int64_t AnimationSystem<TAnimationClip>::sampleClip(const AnimationSystemInstance& instance, uint32_t clip, AnimationPose& outAnimationPose, int64_t tick) const
+	{
+		const TAnimationClip& animationClip = animationClips[clip];
+		const std::vector<bool>* activeJoints = instance.skeletonLOD != nullptr ? &instance.skeletonLOD->getActiveJoints() : nullptr;
+
+		// Wrapped in ticks, only the time within the clip becomes seconds
+		int64_t adjustedTick = animationClip.adjustTickToFitRange(tick);
+		float time = ticksToSeconds(adjustedTick);
+
+		if (poseCache != nullptr)
+		{
+			poseCache->sample(animationClip, outAnimationPose, time, activeJoints);
+		}
+		else if (activeJoints != nullptr)
+		{
+			animationClip.sample(outAnimationPose, time, *activeJoints);
+		}
+		else
+		{
+			animationClip.sample(outAnimationPose, time);
+		}
+
+		return adjustedTick;
+	}
+
+	template <typename TAnimationClip>
+	void AnimationSystem<TAnimationClip>::writePalette(uint32_t index, const AnimationPose& pose)
+	{
+		Matrix3x4* palette = &palettes[index * numJoints];
+		const SkeletonLOD* skeletonLOD = instances[index].skeletonLOD;
+
+		if (skeletonLOD != nullptr)
+		{
+			skeletonLOD->getSkinningPalette(pose, skeleton->getAffineInverseBindPose(), palette);
+			return;
+		}
+
+		pose.getSkinningPalette(skeleton->getAffineInverseBindPose(), palette);
+	}
+}
\ No newline at end of file
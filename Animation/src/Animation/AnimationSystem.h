@@ -0,0 +1,222 @@
+#pragma once
+
+#include "Skeleton.h"
+#include "AnimationPose.h"
+#include "AnimationClip.h"
+#include "AnimationTick.h"
+#include "SkeletonLOD.h"
+#include "PoseCache.h"
+#include "SkinPaletteCache.h"
+
+#include <Math/Matrix3x4.h>
+#include <Utils/JobSystem.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Animation
+{
+	struct AnimationSystemInstance
+	{
+		inline AnimationSystemInstance() :
+			clip(0),
+			tick(0),
+			playbackSpeed(1.0f),
+			fadeClip(-1),
+			fadeTick(0),
+			fadeDuration(0.0f),
+			fadeElapsed(0.0f),
+			distance(0.0f),
+			lodLevel(0),
+			framesSinceUpdate(0),
+			pendingDeltaTicks(0),
+			bSampled(false),
+			skeletonLOD(nullptr),
+			bBakedPlayback(false)
+		{}
+
+		// Playback positions are ticks, see AnimationTick.h
+		uint32_t clip;
+		int64_t tick;
+		float playbackSpeed;
+
+		// Clip being faded to, -1 if the instance isn't fading
+		int32_t fadeClip;
+		int64_t fadeTick;
+		float fadeDuration;
+		float fadeElapsed;
+
+		// Update-rate LOD, see AnimationSystem::setLODDistances
+		float distance;
+		uint32_t lodLevel;
+		uint32_t framesSinceUpdate;
+		int64_t pendingDeltaTicks;
+		bool bSampled;
+
+		// Joints to animate, nullptr for all of them
+		const SkeletonLOD* skeletonLOD;
+
+		// Read the palette from the skin palette cache instead of sampling when possible
+		bool bBakedPlayback;
+	};
+
+	// Per LOD level counters of the last update. Times are in milliseconds.
+	struct AnimationLODStats
+	{
+		inline AnimationLODStats() :
+			numInstances(0),
+			numSampled(0),
+			numInterpolated(0),
+			sampleTime(0.0f),
+			interpolateTime(0.0f),
+			savedTime(0.0f)
+		{}
+
+		uint32_t numInstances;
+		uint32_t numSampled;
+		uint32_t numInterpolated;
+		float sampleTime;
+		float interpolateTime;
+
+		// Estimated time saved compared to sampling every instance of the level
+		float savedTime;
+	};
+
+	// Owns the playback state of many characters sharing one skeleton and one clip set, and
+	// updates all of them in a single call. Instances are visited grouped by clip so the track
+	// data of a clip stays in cache while it serves every instance playing it. The skinning
+	// palettes (global pose * inverse bind pose) of all instances are written into one
+	// contiguous buffer of affine matrices, getPaletteStride() per instance, ready for
+	// upload as three vec4 per joint.
+	// The skeleton and the clips are referenced and have to outlive the system. Clip indices
+	// are checked against the clips set with setAnimationClips, invalid ones are rejected.
+	//
+	// Distant instances can be updated at a lower rate: LOD level n samples its clips every
+	// 2^n frames (60/30/15/7.5 Hz at 60 fps), staggered by instance index so the work is
+	// spread over frames. In between, the palette is built from a lerp of the last two
+	// sampled local poses, which trails the clip by one update interval. Level 0 samples
+	// straight into the palette without keeping the last two poses.
+	//
+	// Instances keep their playback position in integer ticks like the controllers, so
+	// hours of playback don't drift. update converts its delta time to ticks once.
+	template <typename TAnimationClip>
+	class AnimationSystem
+	{
+	public:
+		static constexpr uint32_t NumLODLevels = 4;
+
+		AnimationSystem();
+
+		void setSkeleton(const Skeleton& inSkeleton);
+		void setAnimationClips(const std::vector<TAnimationClip>& inAnimationClips);
+
+		static constexpr uint32_t InvalidInstance = 0xffffffff;
+
+		void reserve(uint32_t numInstances);
+
+		// Returns InvalidInstance if clip isn't one of the animation clips
+		uint32_t addInstance(uint32_t clip, float time = 0.0f, float playbackSpeed = 1.0f);
+		void clear();
+		uint32_t getNumInstances() const;
+
+		void play(uint32_t instance, uint32_t clip, float time);
+		void fadeTo(uint32_t instance, uint32_t clip, float fadeTime);
+		void setPlaybackSpeed(uint32_t instance, float playbackSpeed);
+		const AnimationSystemInstance& getInstance(uint32_t instance) const;
+
+		// Instances at or beyond a distance drop to the matching LOD level. By default every
+		// instance is updated every frame.
+		void setLODDistances(float level1Distance, float level2Distance, float level3Distance);
+		void setDistance(uint32_t instance, float distance);
+		const AnimationLODStats& getLODStats(uint32_t level) const;
+
+		// Restricts sampling and palette computation to the active joints of skeletonLOD,
+		// which has to outlive its use. Meshes drawn with it should be remapped with
+		// remapSkeletalMesh, or rely on the inactive palette entries copied from the
+		// active ancestors.
+		void setSkeletonLOD(uint32_t instance, const SkeletonLOD* skeletonLOD);
+
+		// Samples clips through poseCache so instances at the same clip time share the
+		// work, nullptr to sample directly. The owner calls beginFrame on it every frame.
+		void setPoseCache(PoseCache<TAnimationClip>* inPoseCache);
+
+		// Instances with baked playback read their palettes from skinPaletteCache while
+		// they aren't fading. Their clips are baked at the start of update, instances whose
+		// clip doesn't fit in the cache's budget are sampled as usual.
+		void setSkinPaletteCache(SkinPaletteCache<TAnimationClip>* inSkinPaletteCache);
+		void setBakedPlayback(uint32_t instance, bool bBakedPlayback);
+
+		void update(float deltaTime);
+		void updateTicks(int64_t deltaTicks);
+
+		// Same as update, with the instances spread over the workers of jobSystem in
+		// batches of batchSize. Batches follow the clip grouping.
+		void update(float deltaTime, Util::JobSystem& jobSystem, uint32_t batchSize = 32);
+		void updateTicks(int64_t deltaTicks, Util::JobSystem& jobSystem, uint32_t batchSize = 32);
+
+		uint32_t getPaletteStride() const;
+		const Matrix3x4* getPalette(uint32_t instance) const;
+		const std::vector<Matrix3x4>& getPalettes() const;
+
+	protected:
+		// What an instance does this update, the last part of its bucket
+		enum class UpdateKind : uint32_t
+		{
+			Baked,
+			Sampled,
+			Interpolated
+		};
+
+		static constexpr uint32_t NumUpdateKinds = 3;
+
+		void beginUpdate(uint32_t numWorkers);
+		void bakeClips();
+		void endUpdate();
+		bool isValidClip(uint32_t clip) const;
+		void groupInstances();
+		void updateInstances(uint32_t begin, uint32_t end, int64_t deltaTicks, AnimationPose& scratchPose, AnimationPose& scratchFadePose, AnimationLODStats* stats);
+		void updateInstance(uint32_t index, UpdateKind kind, int64_t deltaTicks, AnimationPose& scratchPose, AnimationPose& scratchFadePose, AnimationLODStats& levelStats);
+		void sampleInstance(uint32_t index, int64_t deltaTicks, AnimationPose& scratchPose, AnimationPose& scratchFadePose);
+		int64_t sampleClip(const AnimationSystemInstance& instance, uint32_t clip, AnimationPose& outAnimationPose, int64_t tick) const;
+		void writePalette(uint32_t index, const AnimationPose& pose);
+
+	protected:
+		const Skeleton* skeleton;
+		const TAnimationClip* animationClips;
+		PoseCache<TAnimationClip>* poseCache;
+		SkinPaletteCache<TAnimationClip>* skinPaletteCache;
+		uint32_t numAnimationClips;
+		uint32_t numJoints;
+
+		std::vector<AnimationSystemInstance> instances;
+		std::vector<Matrix3x4> palettes;
+
+		// Last two sampled local poses of every instance, previous then current. Only
+		// used by instances updated at a lower rate.
+		std::vector<Transform> sampledPoses;
+
+		float lodDistances[NumLODLevels];
+		uint32_t frameIndex;
+		float averageSampleTime;
+		AnimationLODStats lodStats[NumLODLevels];
+
+		// NumLODLevels stats per job system worker, summed into lodStats
+		std::vector<AnimationLODStats> workerStats;
+
+		// Instance indices sorted by bucket (clip, then LOD level, then update kind), rebuilt
+		// with a counting sort every update. Updates are timed per run of a bucket rather
+		// than per instance.
+		std::vector<uint32_t> sortedInstances;
+		std::vector<uint32_t> instanceBuckets;
+		std::vector<uint32_t> bucketOffsets;
+
+		// Clips whose palettes are in the skin palette cache this update
+		std::vector<bool> bakedClips;
+
+		AnimationPose animationPose;
+		AnimationPose fadePose;
+
+		// Two scratch poses per job system worker
+		std::vector<AnimationPose> workerPoses;
+	};
+}
\ No newline at end of file
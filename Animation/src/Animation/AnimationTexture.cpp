@@ -5,20 +5,388 @@
 
 #include <spdlog/spdlog.h>
 
+#include <Math/Math.h>
+#include <Utils/Compression.h>
+
+#include <cfloat>
+#include <cmath>
 #include <fstream>
 
 namespace Animation
 {
+	// State of a chunked load between beginLoad and endLoad
+	struct AnimationTextureStream
+	{
+		std::ifstream file;
+		std::vector<AnimationTextureChunk> chunks;
+		std::vector<uint8_t> buffer;
+		uint32_t nextChunk;
+		uint64_t offset;
+		bool bCompressed;
+		bool bFailed;
+	};
+
+	namespace AnimationTextureHelpers
+	{
+		constexpr float QuantizationSteps = 65535.0f;
+
+		inline void writeClip(std::ofstream& file, const AnimationTextureClip& clip)
+		{
+			uint32_t nameLength = static_cast<uint32_t>(clip.name.size());
+			uint8_t bLooping = clip.bLooping ? 1 : 0;
+
+			file.write((char*)&nameLength, sizeof(uint32_t));
+			file.write(clip.name.data(), nameLength);
+			file.write((char*)&clip.rowOffset, sizeof(uint32_t));
+			file.write((char*)&clip.numRows, sizeof(uint32_t));
+			file.write((char*)&clip.numFrames, sizeof(uint32_t));
+			file.write((char*)&clip.duration, sizeof(float));
+			file.write((char*)&bLooping, sizeof(uint8_t));
+			file.write((char*)&clip.encodedRowOffset, sizeof(uint32_t));
+			file.write((char*)&clip.rowsPerJoint, sizeof(uint32_t));
+			file.write((char*)clip.positionMin.elements, sizeof(float) * 3);
+			file.write((char*)clip.positionMax.elements, sizeof(float) * 3);
+			file.write((char*)&clip.scaleMin, sizeof(float));
+			file.write((char*)&clip.scaleMax, sizeof(float));
+		}
+
+		inline void readClip(std::ifstream& file, AnimationTextureClip& clip)
+		{
+			uint32_t nameLength = 0;
+			uint8_t bLooping = 0;
+
+			file.read((char*)&nameLength, sizeof(uint32_t));
+
+			// Names are short, anything else is a corrupt file
+			if (!file.good() || nameLength > 4096)
+			{
+				file.setstate(std::ios::failbit);
+				return;
+			}
+
+			clip.name.resize(nameLength);
+
+			if (nameLength > 0)
+			{
+				file.read(&clip.name[0], nameLength);
+			}
+
+			file.read((char*)&clip.rowOffset, sizeof(uint32_t));
+			file.read((char*)&clip.numRows, sizeof(uint32_t));
+			file.read((char*)&clip.numFrames, sizeof(uint32_t));
+			file.read((char*)&clip.duration, sizeof(float));
+			file.read((char*)&bLooping, sizeof(uint8_t));
+			file.read((char*)&clip.encodedRowOffset, sizeof(uint32_t));
+			file.read((char*)&clip.rowsPerJoint, sizeof(uint32_t));
+			file.read((char*)clip.positionMin.elements, sizeof(float) * 3);
+			file.read((char*)clip.positionMax.elements, sizeof(float) * 3);
+			file.read((char*)&clip.scaleMin, sizeof(float));
+			file.read((char*)&clip.scaleMax, sizeof(float));
+			clip.bLooping = bLooping != 0;
+		}
+
+		// Largest size an LZ compressed chunk can take, the LZ4 bound
+		constexpr uint64_t MaxStoredChunkSize = AnimationTexture::ChunkSize + AnimationTexture::ChunkSize / 255 + 16;
+
+		// Size of the data a header describes, 0 if it is out of the accepted range
+		inline uint64_t getPayloadSize(const AnimationTextureFileHeader& header)
+		{
+			if (header.format > static_cast<uint32_t>(AnimationTextureFormat::Packed) ||
+				header.width > AnimationTexture::MaxTextureSize ||
+				header.height > AnimationTexture::MaxTextureSize ||
+				header.encodedHeight > AnimationTexture::MaxTextureSize)
+			{
+				return 0;
+			}
+
+			// The float data is allocated whatever the format
+			uint64_t dataSize = static_cast<uint64_t>(header.width) * header.height * 4 * sizeof(float);
+
+			if (dataSize > AnimationTexture::MaxDataSize)
+			{
+				return 0;
+			}
+
+			if (static_cast<AnimationTextureFormat>(header.format) == AnimationTextureFormat::RGBA32F)
+			{
+				return dataSize;
+			}
+
+			return static_cast<uint64_t>(header.width) * header.encodedHeight * 4 * sizeof(uint16_t);
+		}
+
+		inline bool isValidClip(const AnimationTextureClip& clip, const AnimationTextureFileHeader& header)
+		{
+			if (clip.numRows % 3 != 0 ||
+				static_cast<uint64_t>(clip.rowOffset) + clip.numRows > header.height ||
+				clip.numFrames > header.width)
+			{
+				return false;
+			}
+
+			if (static_cast<AnimationTextureFormat>(header.format) == AnimationTextureFormat::RGBA32F)
+			{
+				return true;
+			}
+
+			return (clip.rowsPerJoint == 2 || clip.rowsPerJoint == 3) &&
+				   static_cast<uint64_t>(clip.encodedRowOffset) + static_cast<uint64_t>(clip.numRows / 3) * clip.rowsPerJoint <= header.encodedHeight;
+		}
+
+		inline bool isValidChunkTable(const std::vector<AnimationTextureChunk>& chunks, const AnimationTextureFileHeader& header, uint64_t remainingFileSize)
+		{
+			uint64_t offset = 0;
+			uint64_t storedSize = 0;
+
+			// Chunks are ChunkSize apart like save writes them, stored within the file
+			for (const auto& chunk : chunks)
+			{
+				if (offset >= header.payloadSize || chunk.size != Min<uint64_t>(AnimationTexture::ChunkSize, header.payloadSize - offset))
+				{
+					return false;
+				}
+
+				if (header.compression != 0 ? chunk.storedSize > MaxStoredChunkSize : chunk.storedSize != chunk.size)
+				{
+					return false;
+				}
+
+				offset += chunk.size;
+				storedSize += chunk.storedSize;
+			}
+
+			return offset == header.payloadSize && storedSize <= remainingFileSize;
+		}
+
+		inline uint16_t quantize(float value, float minValue, float maxValue)
+		{
+			if (maxValue <= minValue)
+			{
+				return 0;
+			}
+
+			float t = Min(Max((value - minValue) / (maxValue - minValue), 0.0f), 1.0f);
+
+			return static_cast<uint16_t>(t * QuantizationSteps + 0.5f);
+		}
+
+		inline float dequantize(uint16_t value, float minValue, float maxValue)
+		{
+			return minValue + (maxValue - minValue) * (value / QuantizationSteps);
+		}
+
+		inline void encodeData(AnimationTextureFormat format, const std::vector<float>& data, uint32_t width, uint32_t height,
+							   std::vector<AnimationTextureClip>& clips, std::vector<uint16_t>& outEncoded, uint32_t& outEncodedHeight)
+		{
+			outEncoded.clear();
+			outEncodedHeight = 0;
+
+			if (format == AnimationTextureFormat::RGBA32F)
+			{
+				return;
+			}
+
+			if (format == AnimationTextureFormat::RGBA16F)
+			{
+				outEncoded.resize(data.size());
+
+				for (size_t i = 0; i < data.size(); i++)
+				{
+					outEncoded[i] = FloatToHalf(data[i]);
+				}
+
+				for (auto& clip : clips)
+				{
+					clip.encodedRowOffset = clip.rowOffset;
+					clip.rowsPerJoint = 3;
+				}
+
+				outEncodedHeight = height;
+				return;
+			}
+
+			// Packed: find the ranges and the layout of every clip first
+			for (auto& clip : clips)
+			{
+				uint32_t numJoints = clip.numRows / 3;
+				uint32_t numFrames = Min(clip.numFrames, width);
+				bool bUniformScale = true;
+
+				clip.positionMin = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+				clip.positionMax = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+				clip.scaleMin = FLT_MAX;
+				clip.scaleMax = -FLT_MAX;
+
+				for (uint32_t joint = 0; joint < numJoints; joint++)
+				{
+					for (uint32_t x = 0; x < numFrames; x++)
+					{
+						const float* position = &data[((clip.rowOffset + joint * 3) * width + x) * 4];
+						const float* scale = &data[((clip.rowOffset + joint * 3 + 2) * width + x) * 4];
+
+						for (uint32_t i = 0; i < 3; i++)
+						{
+							clip.positionMin.elements[i] = Min(clip.positionMin.elements[i], position[i]);
+							clip.positionMax.elements[i] = Max(clip.positionMax.elements[i], position[i]);
+							clip.scaleMin = Min(clip.scaleMin, scale[i]);
+							clip.scaleMax = Max(clip.scaleMax, scale[i]);
+						}
+
+						float tolerance = 1e-5f * Max(1.0f, FastAbs(scale[0]));
+
+						if (FastAbs(scale[0] - scale[1]) > tolerance || FastAbs(scale[0] - scale[2]) > tolerance)
+						{
+							bUniformScale = false;
+						}
+					}
+				}
+
+				if (numJoints == 0 || numFrames == 0)
+				{
+					clip.positionMin = clip.positionMax = Vector3::Zero;
+					clip.scaleMin = clip.scaleMax = 0.0f;
+				}
+
+				clip.rowsPerJoint = bUniformScale ? 2 : 3;
+				clip.encodedRowOffset = outEncodedHeight;
+				outEncodedHeight += numJoints * clip.rowsPerJoint;
+			}
+
+			outEncoded.assign(static_cast<size_t>(width) * outEncodedHeight * 4, 0);
+
+			for (const auto& clip : clips)
+			{
+				uint32_t numJoints = clip.numRows / 3;
+				uint32_t numFrames = Min(clip.numFrames, width);
+
+				for (uint32_t joint = 0; joint < numJoints; joint++)
+				{
+					uint32_t y = clip.encodedRowOffset + joint * clip.rowsPerJoint;
+
+					for (uint32_t x = 0; x < numFrames; x++)
+					{
+						const float* position = &data[((clip.rowOffset + joint * 3) * width + x) * 4];
+						const float* rotation = &data[((clip.rowOffset + joint * 3 + 1) * width + x) * 4];
+						const float* scale = &data[((clip.rowOffset + joint * 3 + 2) * width + x) * 4];
+
+						uint16_t* rotationOut = &outEncoded[(static_cast<size_t>(y) * width + x) * 4];
+						uint16_t* positionOut = &outEncoded[(static_cast<size_t>(y + 1) * width + x) * 4];
+
+						for (uint32_t i = 0; i < 4; i++)
+						{
+							rotationOut[i] = quantize(rotation[i], -1.0f, 1.0f);
+						}
+
+						for (uint32_t i = 0; i < 3; i++)
+						{
+							positionOut[i] = quantize(position[i], clip.positionMin.elements[i], clip.positionMax.elements[i]);
+						}
+
+						if (clip.rowsPerJoint == 2)
+						{
+							positionOut[3] = quantize(scale[0], clip.scaleMin, clip.scaleMax);
+						}
+						else
+						{
+							uint16_t* scaleOut = &outEncoded[(static_cast<size_t>(y + 2) * width + x) * 4];
+
+							for (uint32_t i = 0; i < 3; i++)
+							{
+								scaleOut[i] = quantize(scale[i], clip.scaleMin, clip.scaleMax);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		inline void decodeData(AnimationTextureFormat format, const std::vector<uint16_t>& encoded, uint32_t width,
+							   const std::vector<AnimationTextureClip>& clips, std::vector<float>& outData)
+		{
+			if (format == AnimationTextureFormat::RGBA16F)
+			{
+				for (size_t i = 0; i < encoded.size() && i < outData.size(); i++)
+				{
+					outData[i] = HalfToFloat(encoded[i]);
+				}
+
+				return;
+			}
+
+			if (format != AnimationTextureFormat::Packed)
+			{
+				return;
+			}
+
+			for (const auto& clip : clips)
+			{
+				uint32_t numJoints = clip.numRows / 3;
+				uint32_t numFrames = Min(clip.numFrames, width);
+
+				for (uint32_t joint = 0; joint < numJoints; joint++)
+				{
+					uint32_t y = clip.encodedRowOffset + joint * clip.rowsPerJoint;
+
+					for (uint32_t x = 0; x < numFrames; x++)
+					{
+						const uint16_t* rotationIn = &encoded[(static_cast<size_t>(y) * width + x) * 4];
+						const uint16_t* positionIn = &encoded[(static_cast<size_t>(y + 1) * width + x) * 4];
+
+						float* position = &outData[((clip.rowOffset + joint * 3) * width + x) * 4];
+						float* rotation = &outData[((clip.rowOffset + joint * 3 + 1) * width + x) * 4];
+						float* scale = &outData[((clip.rowOffset + joint * 3 + 2) * width + x) * 4];
+
+						for (uint32_t i = 0; i < 4; i++)
+						{
+							rotation[i] = dequantize(rotationIn[i], -1.0f, 1.0f);
+						}
+
+						for (uint32_t i = 0; i < 3; i++)
+						{
+							position[i] = dequantize(positionIn[i], clip.positionMin.elements[i], clip.positionMax.elements[i]);
+						}
+
+						position[3] = 0.0f;
+
+						if (clip.rowsPerJoint == 2)
+						{
+							scale[0] = scale[1] = scale[2] = dequantize(positionIn[3], clip.scaleMin, clip.scaleMax);
+						}
+						else
+						{
+							const uint16_t* scaleIn = &encoded[(static_cast<size_t>(y + 2) * width + x) * 4];
+
+							for (uint32_t i = 0; i < 3; i++)
+							{
+								scale[i] = dequantize(scaleIn[i], clip.scaleMin, clip.scaleMax);
+							}
+						}
+
+						scale[3] = 0.0f;
+					}
+				}
+			}
+		}
+	}
+
 	
 	AnimationTexture::AnimationTexture()
 	{
+		format = AnimationTextureFormat::RGBA32F;
 		size = 0;
+		height = 0;
+		encodedHeight = 0;
+		bEncodedDataStale = false;
 		glGenTextures(1, &handle);
 	}
 
 	AnimationTexture::AnimationTexture(const AnimationTexture& other)
 	{
+		format = AnimationTextureFormat::RGBA32F;
 		size = 0;
+		height = 0;
+		encodedHeight = 0;
+		bEncodedDataStale = false;
 		glGenTextures(1, &handle);
 		
 		*this = other;
@@ -36,13 +404,19 @@ namespace Animation
 			return *this;
 		}
 
+		format = other.format;
 		size = other.size;
+		height = other.height;
+		encodedHeight = other.encodedHeight;
 		data = other.data;
+		encodedData = other.encodedData;
+		clips = other.clips;
+		bEncodedDataStale = other.bEncodedDataStale.load(std::memory_order_relaxed);
 
 		return *this;
 	}
 	
-	void AnimationTexture::save(const std::string& path)
+	bool AnimationTexture::save(const std::string& path, bool bCompress)
 	{
 		std::ofstream file;
 		
@@ -51,44 +425,307 @@ namespace Animation
 		if (!file.is_open())
 		{
 			spdlog::error("Couldn't open {0}\n", path);
+			return false;
 		}
 
-		file << size;
-		
-		if (size != 0)
+		if (format != AnimationTextureFormat::RGBA32F && bEncodedDataStale)
 		{
-			file.write((char*)&data[0], sizeof(float) * (size * size * 4));
+			encode();
 		}
-		
+
+		const uint8_t* payload = getPayload();
+		uint64_t payloadSize = getPayloadSize();
+		uint32_t numChunks = static_cast<uint32_t>((payloadSize + ChunkSize - 1) / ChunkSize);
+
+		AnimationTextureFileHeader header = {};
+		header.magic = FileMagic;
+		header.version = FileVersion;
+		header.width = size;
+		header.height = height;
+		header.format = static_cast<uint32_t>(format);
+		header.encodedHeight = encodedHeight;
+		header.compression = bCompress ? 1 : 0;
+		header.numClips = static_cast<uint32_t>(clips.size());
+		header.numChunks = numChunks;
+		header.payloadSize = payloadSize;
+
+		file.write((char*)&header, sizeof(AnimationTextureFileHeader));
+
+		for (const auto& clip : clips)
+		{
+			AnimationTextureHelpers::writeClip(file, clip);
+		}
+
+		// Compress every chunk first so the chunk table can precede the data
+		std::vector<std::vector<uint8_t>> compressedChunks(bCompress ? numChunks : 0);
+		std::vector<AnimationTextureChunk> chunks(numChunks);
+
+		for (uint32_t i = 0; i < numChunks; i++)
+		{
+			uint64_t offset = static_cast<uint64_t>(i) * ChunkSize;
+			uint32_t chunkSize = static_cast<uint32_t>(Min<uint64_t>(ChunkSize, payloadSize - offset));
+
+			chunks[i].size = chunkSize;
+			chunks[i].storedSize = chunkSize;
+
+			if (bCompress)
+			{
+				chunks[i].storedSize = static_cast<uint32_t>(Util::compressLZ(payload + offset, chunkSize, compressedChunks[i]));
+			}
+		}
+
+		if (numChunks > 0)
+		{
+			file.write((char*)&chunks[0], sizeof(AnimationTextureChunk) * numChunks);
+		}
+
+		for (uint32_t i = 0; i < numChunks; i++)
+		{
+			if (bCompress)
+			{
+				file.write((char*)compressedChunks[i].data(), chunks[i].storedSize);
+			}
+			else
+			{
+				file.write((char*)(payload + static_cast<uint64_t>(i) * ChunkSize), chunks[i].size);
+			}
+		}
+
 		file.close();
+
+		return true;
 	}
 
-	void AnimationTexture::load(const std::string& path)
+	bool AnimationTexture::load(const std::string& path)
 	{
-		std::ifstream file;
+		if (!beginLoad(path))
+		{
+			return false;
+		}
+
+		while (loadNextChunk())
+		{
+		}
+
+		if (!endLoad())
+		{
+			return false;
+		}
+
+		uploadTextureDataToGPU();
+
+		return true;
+	}
+
+	bool AnimationTexture::beginLoad(const std::string& path)
+	{
+		// Everything is read and checked into locals first and only kept once the whole
+		// header, directory and chunk table make sense
+		std::unique_ptr<AnimationTextureStream> newStream(new AnimationTextureStream());
+		std::ifstream& file = newStream->file;
 
 		file.open(path, std::ios::in | std::ios::binary);
 
 		if (!file.is_open())
 		{
 			spdlog::error("Couldn't open {0}\n", path);
+			return false;
 		}
 
-		file >> size;
-		
-		data.resize(size);
-		
-		file.read((char*)&data[0], sizeof(float) * (size * size * 4));
-		file.close();
+		file.seekg(0, std::ios::end);
+		uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+		file.seekg(0, std::ios::beg);
 
-		uploadTextureDataToGPU();
+		AnimationTextureFileHeader header;
+		file.read((char*)&header, sizeof(AnimationTextureFileHeader));
+
+		if (!file.good() || header.magic != FileMagic)
+		{
+			spdlog::error("{0} isn't an animation texture\n", path);
+			return false;
+		}
+
+		if (header.version != FileVersion)
+		{
+			spdlog::error("{0} has version {1}, expected {2}\n", path, header.version, FileVersion);
+			return false;
+		}
+
+		// Bounds before anything is allocated from the header
+		uint64_t payloadSize = AnimationTextureHelpers::getPayloadSize(header);
+		uint64_t numChunks = (header.payloadSize + ChunkSize - 1) / ChunkSize;
+
+		if (payloadSize != header.payloadSize || header.numChunks != numChunks || header.numClips > header.height)
+		{
+			spdlog::error("{0} is corrupt\n", path);
+			return false;
+		}
+
+		std::vector<AnimationTextureClip> newClips(header.numClips);
+
+		for (auto& clip : newClips)
+		{
+			AnimationTextureHelpers::readClip(file, clip);
+
+			if (!file.good() || !AnimationTextureHelpers::isValidClip(clip, header))
+			{
+				spdlog::error("{0} is corrupt\n", path);
+				return false;
+			}
+		}
+
+		newStream->chunks.resize(header.numChunks);
+
+		if (header.numChunks > 0)
+		{
+			file.read((char*)&newStream->chunks[0], sizeof(AnimationTextureChunk) * header.numChunks);
+		}
+
+		uint64_t position = file.good() ? static_cast<uint64_t>(file.tellg()) : fileSize;
+
+		if (!file.good() || !AnimationTextureHelpers::isValidChunkTable(newStream->chunks, header, fileSize - position))
+		{
+			spdlog::error("{0} is corrupt\n", path);
+			return false;
+		}
+
+		size = header.width;
+		height = header.height;
+		format = static_cast<AnimationTextureFormat>(header.format);
+		encodedHeight = header.encodedHeight;
+		clips.swap(newClips);
+
+		data.assign(static_cast<size_t>(size) * height * 4, 0.0f);
+		encodedData.clear();
+		bEncodedDataStale = true;
+
+		if (format != AnimationTextureFormat::RGBA32F)
+		{
+			encodedData.resize(static_cast<size_t>(size) * encodedHeight * 4);
+		}
+
+		newStream->bCompressed = header.compression != 0;
+		newStream->nextChunk = 0;
+		newStream->offset = 0;
+		newStream->bFailed = false;
+		stream = std::move(newStream);
+
+		return true;
+	}
+
+	bool AnimationTexture::loadNextChunk()
+	{
+		if (!stream || stream->bFailed || stream->nextChunk >= stream->chunks.size())
+		{
+			return false;
+		}
+
+		const AnimationTextureChunk& chunk = stream->chunks[stream->nextChunk];
+		uint8_t* destination = getPayload() + stream->offset;
+
+		if (stream->bCompressed)
+		{
+			stream->buffer.resize(chunk.storedSize);
+
+			if (chunk.storedSize > 0)
+			{
+				stream->file.read((char*)&stream->buffer[0], chunk.storedSize);
+			}
+
+			stream->bFailed = !stream->file.good() ||
+							  !Util::decompressLZ(stream->buffer.data(), chunk.storedSize, destination, chunk.size);
+		}
+		else
+		{
+			stream->file.read((char*)destination, chunk.size);
+			stream->bFailed = !stream->file.good();
+		}
+
+		stream->offset += chunk.size;
+		stream->nextChunk++;
+
+		return !stream->bFailed && stream->nextChunk < stream->chunks.size();
+	}
+
+	bool AnimationTexture::isLoading() const
+	{
+		return stream != nullptr;
+	}
+
+	float AnimationTexture::getLoadProgress() const
+	{
+		if (!stream || stream->chunks.empty())
+		{
+			return 1.0f;
+		}
+
+		return static_cast<float>(stream->nextChunk) / stream->chunks.size();
+	}
+
+	bool AnimationTexture::endLoad()
+	{
+		if (!stream)
+		{
+			return false;
+		}
+
+		bool bSucceeded = !stream->bFailed && stream->nextChunk == stream->chunks.size();
+		stream.reset();
+
+		if (!bSucceeded)
+		{
+			spdlog::error("Couldn't read the animation texture data\n");
+			return false;
+		}
+
+		// The CPU side works on the float data, the encoded data stays the one of the file
+		decode();
+
+		return true;
+	}
+
+	uint8_t* AnimationTexture::getPayload()
+	{
+		if (format == AnimationTextureFormat::RGBA32F)
+		{
+			return data.empty() ? nullptr : reinterpret_cast<uint8_t*>(&data[0]);
+		}
+
+		return encodedData.empty() ? nullptr : reinterpret_cast<uint8_t*>(&encodedData[0]);
+	}
+
+	uint64_t AnimationTexture::getPayloadSize() const
+	{
+		if (format == AnimationTextureFormat::RGBA32F)
+		{
+			return data.size() * sizeof(float);
+		}
+
+		return encodedData.size() * sizeof(uint16_t);
 	}
 
 	void AnimationTexture::uploadTextureDataToGPU()
 	{
+		// The bakers only write the float data
+		if (format != AnimationTextureFormat::RGBA32F && bEncodedDataStale)
+		{
+			encode();
+		}
+
 		glBindTexture(GL_TEXTURE_2D, handle);
 
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, size, size, 0, GL_RGBA, GL_FLOAT, &data[0]);
+		switch (format)
+		{
+		case AnimationTextureFormat::RGBA16F:
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, size, encodedHeight, 0, GL_RGBA, GL_HALF_FLOAT, encodedData.empty() ? nullptr : &encodedData[0]);
+			break;
+		case AnimationTextureFormat::Packed:
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16, size, encodedHeight, 0, GL_RGBA, GL_UNSIGNED_SHORT, encodedData.empty() ? nullptr : &encodedData[0]);
+			break;
+		default:
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, size, height, 0, GL_RGBA, GL_FLOAT, data.empty() ? nullptr : &data[0]);
+			break;
+		}
 		
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -104,10 +741,22 @@ namespace Animation
 		return size;
 	}
 
+	uint32_t AnimationTexture::getHeight() const
+	{
+		return height;
+	}
+
 	void AnimationTexture::resize(uint32_t newSize)
 	{
-		size = newSize;
-		data.resize(size * size * 4);
+		resize(newSize, newSize);
+	}
+
+	void AnimationTexture::resize(uint32_t newWidth, uint32_t newHeight)
+	{
+		size = newWidth;
+		height = newHeight;
+		data.resize(static_cast<size_t>(size) * height * 4);
+		markEncodedDataStale();
 	}
 
 	const std::vector<float>& AnimationTexture::getData() const
@@ -123,6 +772,8 @@ namespace Animation
 		data[index + 1] = value.y;
 		data[index + 2] = value.z;
 		data[index + 3] = 0.0f;
+
+		markEncodedDataStale();
 	}
 
 	void AnimationTexture::setTexel(uint32_t x, uint32_t y, const Quaternion& value)
@@ -133,9 +784,11 @@ namespace Animation
 		data[index + 1] = value.y;
 		data[index + 2] = value.z;
 		data[index + 3] = value.w;
+
+		markEncodedDataStale();
 	}
 
-	Math::Vector4 AnimationTexture::getTexel(uint32_t x, uint32_t y)
+	Math::Vector4 AnimationTexture::getTexel(uint32_t x, uint32_t y) const
 	{
 		uint32_t index = (y * size + x) * 4;
 
@@ -145,6 +798,93 @@ namespace Animation
 					   data[index + 3]);
 	}
 
+	void AnimationTexture::addClip(const AnimationTextureClip& clip)
+	{
+		clips.push_back(clip);
+		markEncodedDataStale();
+	}
+
+	void AnimationTexture::clearClips()
+	{
+		clips.clear();
+		markEncodedDataStale();
+	}
+
+	uint32_t AnimationTexture::getNumClips() const
+	{
+		return static_cast<uint32_t>(clips.size());
+	}
+
+	const AnimationTextureClip& AnimationTexture::getClip(uint32_t index) const
+	{
+		return clips[index];
+	}
+
+	int32_t AnimationTexture::findClip(const std::string& name) const
+	{
+		uint32_t numClips = static_cast<uint32_t>(clips.size());
+
+		for (uint32_t i = 0; i < numClips; i++)
+		{
+			if (clips[i].name == name)
+			{
+				return static_cast<int32_t>(i);
+			}
+		}
+
+		return -1;
+	}
+
+	float AnimationTexture::getFrame(uint32_t clip, float time) const
+	{
+		const AnimationTextureClip& entry = clips[clip];
+
+		if (entry.numFrames < 2 || entry.duration <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float t = time / entry.duration;
+
+		if (entry.bLooping)
+		{
+			t = t - std::floor(t);
+		}
+		else
+		{
+			t = Min(Max(t, 0.0f), 1.0f);
+		}
+
+		return t * (entry.numFrames - 1);
+	}
+
+	Transform AnimationTexture::getJointTransform(uint32_t clip, uint32_t joint, float time) const
+	{
+		const AnimationTextureClip& entry = clips[clip];
+		float frame = getFrame(clip, time);
+
+		uint32_t x0 = static_cast<uint32_t>(frame);
+		uint32_t x1 = Min(x0 + 1, entry.numFrames > 0 ? entry.numFrames - 1 : 0);
+		float t = frame - x0;
+		uint32_t y = entry.rowOffset + joint * 3;
+
+		Transform frames[2];
+		uint32_t columns[2] = { x0, x1 };
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			Vector4 position = getTexel(columns[i], y + 0);
+			Vector4 rotation = getTexel(columns[i], y + 1);
+			Vector4 scale = getTexel(columns[i], y + 2);
+
+			frames[i].position = Vector3(position.x, position.y, position.z);
+			frames[i].rotation = Quaternion(rotation.x, rotation.y, rotation.z, rotation.w);
+			frames[i].scale = Vector3(scale.x, scale.y, scale.z);
+		}
+
+		return lerp(frames[0], frames[1], t);
+	}
+
 	void AnimationTexture::bind(uint32_t uniformIndex, uint32_t textureIndex)
 	{
 		glActiveTexture(GL_TEXTURE0 + textureIndex);
@@ -159,8 +899,131 @@ namespace Animation
 		glActiveTexture(GL_TEXTURE0);
 	}
 
+	void AnimationTexture::setFormat(AnimationTextureFormat inFormat)
+	{
+		if (inFormat == AnimationTextureFormat::Packed && clips.empty())
+		{
+			spdlog::warn("The packed animation texture format needs a clip directory\n");
+			inFormat = AnimationTextureFormat::RGBA32F;
+		}
+
+		format = inFormat;
+		encode();
+	}
+
+	AnimationTextureFormat AnimationTexture::getFormat() const
+	{
+		return format;
+	}
+
+	void AnimationTexture::encode()
+	{
+		AnimationTextureHelpers::encodeData(format, data, size, height, clips, encodedData, encodedHeight);
+		bEncodedDataStale = false;
+	}
+
+	void AnimationTexture::decode()
+	{
+		AnimationTextureHelpers::decodeData(format, encodedData, size, clips, data);
+		bEncodedDataStale = false;
+	}
+
+	const std::vector<uint16_t>& AnimationTexture::getEncodedData() const
+	{
+		return encodedData;
+	}
+
+	uint32_t AnimationTexture::getEncodedHeight() const
+	{
+		return encodedHeight;
+	}
+
+	size_t AnimationTexture::getGPUMemorySize() const
+	{
+		if (format == AnimationTextureFormat::RGBA32F)
+		{
+			return data.size() * sizeof(float);
+		}
+
+		return encodedData.size() * sizeof(uint16_t);
+	}
+
+	AnimationTextureError AnimationTexture::measureEncodingError() const
+	{
+		AnimationTextureError error;
+
+		if (format == AnimationTextureFormat::RGBA32F)
+		{
+			return error;
+		}
+
+		std::vector<AnimationTextureClip> encodedClips = clips;
+		std::vector<uint16_t> encoded;
+		uint32_t encodedRows = 0;
+		AnimationTextureHelpers::encodeData(format, data, size, height, encodedClips, encoded, encodedRows);
+
+		std::vector<float> decoded(data.size(), 0.0f);
+		AnimationTextureHelpers::decodeData(format, encoded, size, encodedClips, decoded);
+
+		double positionErrorSum = 0.0;
+		uint32_t numSamples = 0;
+
+		for (const auto& clip : clips)
+		{
+			uint32_t numJoints = clip.numRows / 3;
+			uint32_t numFrames = Min(clip.numFrames, size);
+
+			for (uint32_t joint = 0; joint < numJoints; joint++)
+			{
+				for (uint32_t x = 0; x < numFrames; x++)
+				{
+					size_t index = ((clip.rowOffset + joint * 3) * static_cast<size_t>(size) + x) * 4;
+					size_t rowStride = static_cast<size_t>(size) * 4;
+
+					const float* position = &data[index];
+					const float* rotation = &data[index + rowStride];
+					const float* scale = &data[index + rowStride * 2];
+					const float* decodedPosition = &decoded[index];
+					const float* decodedRotation = &decoded[index + rowStride];
+					const float* decodedScale = &decoded[index + rowStride * 2];
+
+					Vector3 positionDelta(position[0] - decodedPosition[0], position[1] - decodedPosition[1], position[2] - decodedPosition[2]);
+					float positionError = Sqrt(dot(positionDelta, positionDelta));
+
+					Quaternion a(rotation[0], rotation[1], rotation[2], rotation[3]);
+					Quaternion b(decodedRotation[0], decodedRotation[1], decodedRotation[2], decodedRotation[3]);
+					float cosHalfAngle = Min(FastAbs(dot(normalized(a), normalized(b))), 1.0f);
+
+					error.maxPositionError = Max(error.maxPositionError, positionError);
+					error.maxRotationError = Max(error.maxRotationError, 2.0f * ACos(cosHalfAngle));
+
+					for (uint32_t i = 0; i < 3; i++)
+					{
+						error.maxScaleError = Max(error.maxScaleError, FastAbs(scale[i] - decodedScale[i]));
+					}
+
+					positionErrorSum += positionError;
+					numSamples++;
+				}
+			}
+		}
+
+		error.averagePositionError = numSamples > 0 ? static_cast<float>(positionErrorSum / numSamples) : 0.0f;
+
+		return error;
+	}
+
 	uint32_t AnimationTexture::getHandle() const
 	{
 		return handle;
 	}
+
+	void AnimationTexture::markEncodedDataStale()
+	{
+		// Checked first so the parallel bakers mostly read the flag rather than write it
+		if (!bEncodedDataStale.load(std::memory_order_relaxed))
+		{
+			bEncodedDataStale.store(true, std::memory_order_relaxed);
+		}
+	}
 }
\ No newline at end of file
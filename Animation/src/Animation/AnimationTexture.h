@@ -2,8 +2,13 @@
 
 #include <Math/Vector3.h>
 #include <Math/Quaternion.h>
+#include <Math/Vector4.h>
+#include <Math/Transform.h>
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -11,35 +16,205 @@ using namespace Math;
 
 namespace Animation
 {
+	// GPU format of an animation texture. The float data used on the CPU is always RGBA32F.
+	// RGBA16F halves the memory. Packed stores every value as a 16 bit normalized integer:
+	// rotations over [-1, 1], positions and scales over the range of their clip, with the
+	// scale folded into the w of the position texel when it is uniform. That is two texels
+	// per joint instead of three, a third of the RGBA32F memory.
+	enum class AnimationTextureFormat : uint32_t
+	{
+		RGBA32F = 0,
+		RGBA16F = 1,
+		Packed = 2
+	};
+
+	// Directory entry of a clip baked into an atlas. The clip covers numRows rows starting
+	// at rowOffset (three per joint) and numFrames columns spread evenly over its duration.
+	struct AnimationTextureClip
+	{
+		inline AnimationTextureClip() :
+			rowOffset(0),
+			numRows(0),
+			numFrames(0),
+			duration(0.0f),
+			bLooping(false),
+			encodedRowOffset(0),
+			rowsPerJoint(3),
+			positionMin(Vector3::Zero),
+			positionMax(Vector3::Zero),
+			scaleMin(0.0f),
+			scaleMax(0.0f)
+		{}
+
+		std::string name;
+		uint32_t rowOffset;
+		uint32_t numRows;
+		uint32_t numFrames;
+		float duration;
+		bool bLooping;
+
+		// Layout and quantization ranges of the clip in the encoded data
+		uint32_t encodedRowOffset;
+		uint32_t rowsPerJoint;
+		Vector3 positionMin;
+		Vector3 positionMax;
+		float scaleMin;
+		float scaleMax;
+	};
+
+	// Largest differences between the float data and its encoded version. The rotation error
+	// is an angle in radians.
+	struct AnimationTextureError
+	{
+		inline AnimationTextureError() :
+			maxPositionError(0.0f),
+			averagePositionError(0.0f),
+			maxRotationError(0.0f),
+			maxScaleError(0.0f)
+		{}
+
+		float maxPositionError;
+		float averagePositionError;
+		float maxRotationError;
+		float maxScaleError;
+	};
+
+	// Layout of an animation texture file, all values little endian:
+	//   AnimationTextureFileHeader
+	//   numClips directory entries
+	//   numChunks AnimationTextureChunk
+	//   the chunks, optionally LZ compressed one by one
+	// The chunks hold the float data for RGBA32F and the encoded data otherwise. Each chunk
+	// is decompressed on its own so a large atlas can be streamed in pieces.
+	struct AnimationTextureFileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t format;
+		uint32_t encodedHeight;
+		uint32_t compression;
+		uint32_t numClips;
+		uint32_t numChunks;
+		uint32_t padding;
+		uint64_t payloadSize;
+	};
+
+	struct AnimationTextureChunk
+	{
+		uint32_t size;
+		uint32_t storedSize;
+	};
+
+	struct AnimationTextureStream;
+
 	class AnimationTexture
 	{
 	public:
+		// "ATEX"
+		static constexpr uint32_t FileMagic = 0x58455441;
+		static constexpr uint32_t FileVersion = 1;
+		static constexpr uint32_t ChunkSize = 256 * 1024;
+
+		// Largest texture accepted from a file, the size most GPUs support, and largest
+		// float data it may expand to
+		static constexpr uint32_t MaxTextureSize = 16384;
+		static constexpr uint64_t MaxDataSize = 1024ull * 1024 * 1024;
+
 		AnimationTexture();
 		AnimationTexture(const AnimationTexture& other);
 		AnimationTexture& operator=(const AnimationTexture& other);
 		~AnimationTexture();
-		
-		void save(const std::string& path);
-		void load(const std::string& path);
-		
+
+		bool save(const std::string& path, bool bCompress = false);
+		bool load(const std::string& path);
+
+		// Chunked load. beginLoad reads the header and the clip directory, every call to
+		// loadNextChunk reads one chunk and returns false once all of them are read or on
+		// error, endLoad checks the result and decodes. A file beginLoad rejects leaves the
+		// texture as it was. None of them touches OpenGL, so they
+		// can run on a background thread, uploadTextureDataToGPU has to follow on the render
+		// thread.
+		bool beginLoad(const std::string& path);
+		bool loadNextChunk();
+		bool isLoading() const;
+		float getLoadProgress() const;
+		bool endLoad();
+
+		// Formats other than RGBA32F encode the float data first if setTexel, resize or the
+		// clips changed it since the last encode, as save does. Data just loaded from a
+		// file is uploaded as it was stored, Packed doesn't survive decoding and encoding
+		// again bit for bit.
 		void uploadTextureDataToGPU();
 
+		// Width of the texture, the number of frames
 		uint32_t getSize() const;
+		uint32_t getHeight() const;
 		void resize(uint32_t newSize);
-		
+		void resize(uint32_t newWidth, uint32_t newHeight);
+
 		const std::vector<float>& getData() const;
 
 		void setTexel(uint32_t x, uint32_t y, const Vector3& value);
 		void setTexel(uint32_t x, uint32_t y, const Quaternion& value);
-		
-		Vector4 getTexel(uint32_t x, uint32_t y);
+
+		Vector4 getTexel(uint32_t x, uint32_t y) const;
+
+		void addClip(const AnimationTextureClip& clip);
+		void clearClips();
+		uint32_t getNumClips() const;
+		const AnimationTextureClip& getClip(uint32_t index) const;
+
+		// Index of the clip with the given name, -1 if there is none
+		int32_t findClip(const std::string& name) const;
+
+		// Column of a clip at a time since its start, fractional between two frames. Looping
+		// clips wrap, the others clamp.
+		float getFrame(uint32_t clip, float time) const;
+
+		// Global transform of a joint of a clip, interpolated between the two nearest frames
+		Transform getJointTransform(uint32_t clip, uint32_t joint, float time) const;
+
+		// Changing the format encodes the float data. The packed format needs the clip
+		// directory, a texture without clips stays RGBA32F.
+		void setFormat(AnimationTextureFormat inFormat);
+		AnimationTextureFormat getFormat() const;
+
+		// Rebuild the encoded data from the float data, or the other way around
+		void encode();
+		void decode();
+
+		const std::vector<uint16_t>& getEncodedData() const;
+		uint32_t getEncodedHeight() const;
+		size_t getGPUMemorySize() const;
+
+		// Error the current format introduces, measured against the float data
+		AnimationTextureError measureEncodingError() const;
+
 		void bind(uint32_t uniformIndex, uint32_t textureIndex);
 		void unbind(uint32_t textureIndex);
-		
+
 		uint32_t getHandle() const;
+	protected:
+		uint8_t* getPayload();
+		uint64_t getPayloadSize() const;
+
+		void markEncodedDataStale();
+
 	protected:
 		std::vector<float> data;
+		std::vector<uint16_t> encodedData;
+		std::vector<AnimationTextureClip> clips;
+		AnimationTextureFormat format;
 		uint32_t size;
+		uint32_t height;
+		uint32_t encodedHeight;
 		uint32_t handle;
+		std::unique_ptr<AnimationTextureStream> stream;
+
+		// Set by everything that changes the float data or the clips, setTexel included,
+		// which the bakers call from several threads
+		std::atomic<bool> bEncodedDataStale;
 	};
-}	
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace Animation
+{
+	// Integer playback time, 48000 ticks a second. A tick count neither loses precision nor
+	// needs FMod to loop: after a day of playback a float time is only good to about 8 ms,
+	// a tick is exact and wraps with an integer modulo. Only the time within the range of a
+	// clip is turned back into seconds.
+	constexpr int64_t TicksPerSecond = 48000;
+
+	inline int64_t secondsToTicks(float seconds)
+	{
+		return std::llround(static_cast<double>(seconds) * TicksPerSecond);
+	}
+
+	inline float ticksToSeconds(int64_t ticks)
+	{
+		return static_cast<float>(static_cast<double>(ticks) / TicksPerSecond);
+	}
+
+	// Tick wrapped into [start, start + duration), duration has to be positive
+	inline int64_t wrapTick(int64_t tick, int64_t start, int64_t duration)
+	{
+		int64_t offset = (tick - start) % duration;
+
+		if (offset < 0)
+		{
+			offset += duration;
+		}
+
+		return start + offset;
+	}
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "AnimationTrackHelpers.h"
 #include <Math/Math.h>
 
+#include <cstring>
+
 namespace Animation
 {
 	template AnimationTrack<float, 1>;
@@ -12,6 +14,8 @@ namespace Animation
 	AnimationTrack<T, N>::AnimationTrack()
 	{
 		interpolation = Interpolation::Linear;
+		quaternionInterpolation = QuaternionInterpolation::Nlerp;
+		bPreconditioned = false;
 	}
 
 	template <typename T, int32_t N>
@@ -38,6 +42,18 @@ namespace Animation
 		interpolation = inInterpolation;
 	}
 
+	template <typename T, int32_t N>
+	QuaternionInterpolation AnimationTrack<T, N>::getQuaternionInterpolation() const
+	{
+		return quaternionInterpolation;
+	}
+
+	template <typename T, int32_t N>
+	void AnimationTrack<T, N>::setQuaternionInterpolation(QuaternionInterpolation inQuaternionInterpolation)
+	{
+		quaternionInterpolation = inQuaternionInterpolation;
+	}
+
 	template <typename T, int32_t N>
 	float AnimationTrack<T, N>::getStartTime() const
 	{
@@ -53,17 +69,116 @@ namespace Animation
 	template <typename T, int32_t N>
 	T AnimationTrack<T, N>::sample(float time, bool bLooping) const
 	{
+		return sampleInRange(adjustTimeToFitTrack(time, bLooping));
+	}
+
+	template <typename T, int32_t N>
+	void AnimationTrack<T, N>::sampleInRange(const float* times, T* out, uint32_t count) const
+	{
+		uint32_t size = static_cast<uint32_t>(keyframes.size());
+
+		if (interpolation != Interpolation::Linear || size <= 1)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				out[i] = sampleInRange(times[i]);
+			}
+
+			return;
+		}
+
+		float startTime = keyframes[0].time;
+		float endTime = keyframes[size - 1].time;
+
+		T from[SampleBatchSize];
+		T to[SampleBatchSize];
+		float factors[SampleBatchSize];
+
+		for (uint32_t first = 0; first < count; first += SampleBatchSize)
+		{
+			uint32_t batchCount = Min(count - first, SampleBatchSize);
+
+			// Gather the keys around every time, then interpolate them all in one go
+			for (uint32_t i = 0; i < batchCount; i++)
+			{
+				float trackTime = Min(Max(times[first + i], startTime), endTime);
+				int32_t currentFrame = frameIndex(trackTime);
+				float currentFrameTime = keyframes[currentFrame].time;
+				float frameDelta = keyframes[currentFrame + 1].time - currentFrameTime;
+
+				// Same result as sampleLinear for keys at the same time
+				if (frameDelta <= 0.0f)
+				{
+					from[i] = T();
+					to[i] = T();
+					factors[i] = 0.0f;
+					continue;
+				}
+
+				from[i] = cast(&keyframes[currentFrame].value[0]);
+				to[i] = cast(&keyframes[currentFrame + 1].value[0]);
+				factors[i] = (trackTime - currentFrameTime) / frameDelta;
+			}
+
+			AnimationTrackHelpers::interpolateN(from, to, factors, out + first, batchCount, quaternionInterpolation, bPreconditioned);
+		}
+	}
+
+	template <typename T, int32_t N>
+	T AnimationTrack<T, N>::sampleAtTick(int64_t tick, bool bLooping) const
+	{
+		uint32_t size = static_cast<uint32_t>(keyframes.size());
+
+		if (size <= 1)
+		{
+			return T();
+		}
+
+		int64_t startTick = secondsToTicks(keyframes[0].time);
+		int64_t endTick = secondsToTicks(keyframes[size - 1].time);
+
+		if (bLooping && endTick > startTick)
+		{
+			tick = wrapTick(tick, startTick, endTick - startTick);
+		}
+
+		// sampleInRange clamps the rest
+		return sampleInRange(ticksToSeconds(tick));
+	}
+
+	template <typename T, int32_t N>
+	T AnimationTrack<T, N>::sampleInRange(float time) const
+	{
+		uint32_t size = static_cast<uint32_t>(keyframes.size());
+
+		if (size <= 1)
+		{
+			return T();
+		}
+
+		float trackTime = time;
+
+		if (trackTime < keyframes[0].time)
+		{
+			trackTime = keyframes[0].time;
+		}
+
+		if (trackTime > keyframes[size - 1].time)
+		{
+			trackTime = keyframes[size - 1].time;
+		}
+
 		if (interpolation == Interpolation::Constant)
 		{
-			return sampleConstant(time, bLooping);
+			return sampleConstant(trackTime);
 		}
 		else if (interpolation == Interpolation::Linear)
 		{
-			return sampleLinear(time, bLooping);
+			return sampleLinear(trackTime);
 		}
 		else
 		{
-			return sampleCubic(time, bLooping);
+			return sampleCubic(trackTime);
 		}
 	}
 
@@ -74,9 +189,9 @@ namespace Animation
 	}
 
 	template <typename T, int32_t N>
-	T AnimationTrack<T, N>::sampleConstant(float time, bool bLooping) const
+	T AnimationTrack<T, N>::sampleConstant(float trackTime) const
 	{
-		int32_t frame = frameIndex(time, bLooping);
+		int32_t frame = frameIndex(trackTime);
 
 		if (frame < 0 || frame >= keyframes.size())
 		{
@@ -87,9 +202,9 @@ namespace Animation
 	}
 
 	template <typename T, int32_t N>
-	T AnimationTrack<T, N>::sampleLinear(float time, bool bLooping) const
+	T AnimationTrack<T, N>::sampleLinear(float trackTime) const
 	{
-		int32_t currentFrame = frameIndex(time, bLooping);
+		int32_t currentFrame = frameIndex(trackTime);
 
 		if (currentFrame < 0 || currentFrame >= (keyframes.size() - 1))
 		{
@@ -98,7 +213,6 @@ namespace Animation
 
 		int32_t nextFrame = currentFrame + 1;
 
-		float trackTime = adjustTimeToFitTrack(time, bLooping);
 		float currentFrameTime = keyframes[currentFrame].time;
 		float frameDelta = keyframes[nextFrame].time - currentFrameTime;
 
@@ -111,14 +225,19 @@ namespace Animation
 
 		T start = cast(&keyframes[currentFrame].value[0]);
 		T end = cast(&keyframes[nextFrame].value[0]);
+
+		if (bPreconditioned)
+		{
+			return AnimationTrackHelpers::interpolateAligned(start, end, t, quaternionInterpolation);
+		}
 	
-		return AnimationTrackHelpers::interpolate(start, end, t);
+		return AnimationTrackHelpers::interpolate(start, end, t, quaternionInterpolation);
 	}
 
 	template <typename T, int32_t N>
-	T AnimationTrack<T, N>::sampleCubic(float time, bool bLooping) const
+	T AnimationTrack<T, N>::sampleCubic(float trackTime) const
 	{
-		int32_t currentFrame = frameIndex(time, bLooping);
+		int32_t currentFrame = frameIndex(trackTime);
 
 		if (currentFrame < 0 || currentFrame >= keyframes.size() - 1)
 		{
@@ -127,7 +246,6 @@ namespace Animation
 
 		int32_t nextFrame = currentFrame + 1;
 
-		float trackTime = adjustTimeToFitTrack(time, bLooping);
 		float currentFrameTime = keyframes[currentFrame].time;
 		float frameDelta = keyframes[nextFrame].time - currentFrameTime;
 
@@ -137,6 +255,22 @@ namespace Animation
 		}
 
 		float t = (trackTime - currentFrameTime) / frameDelta;
+
+		if (hermiteSegments.size() == keyframes.size() - 1)
+		{
+			const HermiteSegment<N>& segment = hermiteSegments[currentFrame];
+			float result[N];
+
+			for (int32_t i = 0; i < N; i++)
+			{
+				result[i] = ((segment.a[i] * t + segment.b[i]) * t + segment.c[i]) * t + segment.d[i];
+			}
+
+			// cast normalizes quaternions unless the keys are preconditioned
+			T value = cast(result);
+
+			return bPreconditioned ? AnimationTrackHelpers::adjustHermiteResult(value) : value;
+		}
 		
 		size_t size = sizeof(float);
 
@@ -146,19 +280,111 @@ namespace Animation
 		slope1 = slope1 * frameDelta;
 
 		T point2 = cast(&keyframes[nextFrame].value[0]);
-		T slope2; // keyframes[nextFrame].out * frameDelta;
-		memcpy_s(&slope2, sizeof(T), keyframes[nextFrame].out, N * size);
+		T slope2; // keyframes[nextFrame].in * frameDelta;
+		memcpy_s(&slope2, sizeof(T), keyframes[nextFrame].in, N * size);
 		slope2 = slope2 * frameDelta;
 
 		return hermite(t, point1, slope1, point2, slope2);
 	}
 
+	template <typename T, int32_t N>
+	void AnimationTrack<T, N>::updateHermiteSegments()
+	{
+		hermiteSegments.clear();
+
+		uint32_t size = static_cast<uint32_t>(keyframes.size());
+
+		if (interpolation != Interpolation::Cubic || size <= 1)
+		{
+			return;
+		}
+
+		hermiteSegments.resize(size - 1);
+
+		for (uint32_t i = 0; i < size - 1; i++)
+		{
+			const AnimationKeyFrame<N>& current = keyframes[i];
+			const AnimationKeyFrame<N>& next = keyframes[i + 1];
+			float frameDelta = next.time - current.time;
+
+			T point1 = cast(&current.value[0]);
+			T point2 = cast(&next.value[0]);
+			AnimationTrackHelpers::neighborhood(point1, point2);
+
+			float p1[N];
+			float p2[N];
+			memcpy(p1, &point1, N * sizeof(float));
+			memcpy(p2, &point2, N * sizeof(float));
+
+			// The Hermite basis of hermite() expanded into powers of t
+			HermiteSegment<N>& segment = hermiteSegments[i];
+
+			for (int32_t j = 0; j < N; j++)
+			{
+				float s1 = current.out[j] * frameDelta;
+				float s2 = next.in[j] * frameDelta;
+
+				segment.a[j] = 2.0f * p1[j] + s1 - 2.0f * p2[j] + s2;
+				segment.b[j] = -3.0f * p1[j] - 2.0f * s1 + 3.0f * p2[j] - s2;
+				segment.c[j] = s1;
+				segment.d[j] = p1[j];
+			}
+		}
+	}
+
+	template <typename T, int32_t N>
+	void AnimationTrack<T, N>::precondition()
+	{
+		uint32_t size = static_cast<uint32_t>(keyframes.size());
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			AnimationKeyFrame<N>& keyframe = keyframes[i];
+
+			T value = cast(&keyframe.value[0]);
+
+			if (i > 0)
+			{
+				T previous = cast(&keyframes[i - 1].value[0]);
+				T aligned = value;
+				AnimationTrackHelpers::neighborhood(previous, aligned);
+
+				// Negated key, negated curve through it
+				if (memcmp(&aligned, &value, sizeof(T)) != 0)
+				{
+					for (int32_t j = 0; j < N; j++)
+					{
+						keyframe.in[j] = -keyframe.in[j];
+						keyframe.out[j] = -keyframe.out[j];
+					}
+				}
+
+				value = aligned;
+			}
+
+			memcpy(&keyframe.value[0], &value, N * sizeof(float));
+		}
+
+		bPreconditioned = true;
+
+		updateHermiteSegments();
+	}
+
+	template <typename T, int32_t N>
+	bool AnimationTrack<T, N>::isPreconditioned() const
+	{
+		return bPreconditioned;
+	}
+
 	template <typename T, int32_t N>
 	T AnimationTrack<T, N>::hermite(float time, const T& p1, const T& s1, const T& p2, const T& s2) const
 	{
 		T adjustedP2 = p2;
 		
-		AnimationTrackHelpers::neighborhood(p1, adjustedP2);
+		if (!bPreconditioned)
+		{
+			AnimationTrackHelpers::neighborhood(p1, adjustedP2);
+		}
 		
 		T result = p1 * ((1.0f + 2.0f * time) * ((1.0f - time) * (1.0f - time))) +
 				   s1 * (time * ((1.0f - time) * (1.0f - time))) +
@@ -169,7 +395,7 @@ namespace Animation
 	}
 
 	template <typename T, int32_t N>
-	int32_t AnimationTrack<T, N>::frameIndex(float time, bool bLooping) const
+	int32_t AnimationTrack<T, N>::frameIndex(float trackTime) const
 	{
 		uint32_t size = static_cast<uint32_t>(keyframes.size());
 
@@ -178,34 +404,14 @@ namespace Animation
 			return -1;
 		}
 
-		float adjustedTime = time;
-
-		if (bLooping)
+		if (trackTime <= keyframes[0].time)
 		{
-			float startTime = keyframes[0].time;
-			float endTime = keyframes[size - 1].time;
-			float duration = endTime - startTime;
-
-			adjustedTime = FMod(adjustedTime - startTime, duration) + startTime;
-
-			if (adjustedTime < 0.0f)
-			{
-				adjustedTime += endTime - startTime;
-			}
-
-			adjustedTime = adjustedTime + startTime;
+			return 0;
 		}
-		else
-		{
-			if (adjustedTime <= keyframes[0].time)
-			{
-				return 0;
-			}
 
-			if (adjustedTime >= keyframes[size - 2].time)
-			{
-				return static_cast<int32_t>(size - 2);
-			}
+		if (trackTime >= keyframes[size - 2].time)
+		{
+			return static_cast<int32_t>(size - 2);
 		}
 
 		// The presented loop goes through every frame in the track. If an animation has a lot of 
@@ -218,7 +424,7 @@ namespace Animation
 		// to turn this loop into a constant lookup.
 		for (int32_t i = size - 1; i >= 0 ; i--)
 		{
-			if (adjustedTime >= keyframes[i].time)
+			if (trackTime >= keyframes[i].time)
 			{
 				return i;
 			}
@@ -292,6 +498,6 @@ namespace Animation
 	Quaternion AnimationTrack<Quaternion, 4>::cast(const float* value) const
 	{
 		Quaternion result = Quaternion(value[0], value[1], value[2], value[3]);
-		return normalized(result);
+		return bPreconditioned ? result : normalized(result);
 	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "AnimationKeyFrame.h"
+#include "AnimationTick.h"
 #include <Math/Interpolation.h>
 #include <Math/Vector3.h>
 #include <Math/Quaternion.h>
@@ -12,6 +13,10 @@ using namespace Math;
 
 namespace Animation
 {
+	// Number of times the batched sampling functions work on at once, their scratch arrays
+	// live on the stack
+	constexpr uint32_t SampleBatchSize = 64;
+
 	template <typename T, int32_t N>
 	class AnimationTrack
 	{
@@ -24,26 +29,57 @@ namespace Animation
 		Interpolation getInterpolation() const;
 		
 		void setInterpolation(Interpolation inInterpolation);
+
+		// Only used by linear quaternion tracks
+		QuaternionInterpolation getQuaternionInterpolation() const;
+		void setQuaternionInterpolation(QuaternionInterpolation inQuaternionInterpolation);
 		
 		float getStartTime() const;
 		float getEndTime() const;
 		
 		T sample(float time, bool bLooping) const;
+
+		// Time already wrapped or clamped into the range of the clip, only clamped to the
+		// keys of the track. Clips resolve looping once and call this for every track.
+		T sampleInRange(float time) const;
+
+		// sampleInRange at count times. The keys stay in cache across all of them and linear
+		// tracks interpolate the whole batch at once, rotations with the SIMD kernels.
+		void sampleInRange(const float* times, T* out, uint32_t count) const;
+
+		// Integer tick time, looping wraps it with an integer modulo
+		T sampleAtTick(int64_t tick, bool bLooping) const;
+
+		// Precomputes the polynomial of every segment of a cubic track, with the hemisphere
+		// of quaternion keys already aligned. Has to be called again after editing the
+		// keyframes, sampling uses the segments whenever there is one per pair of keys.
+		// Tracks without them evaluate the Hermite basis.
+		void updateHermiteSegments();
+
+		// Normalizes the keys of a quaternion track and flips each into the hemisphere of
+		// the one before, tangents included, so sampling can skip both. Editing the keys
+		// afterwards has to keep them that way.
+		void precondition();
+		bool isPreconditioned() const;
 		
 		AnimationKeyFrame<N>& operator[](uint32_t index);
 	protected:
-		T sampleConstant(float time, bool bLooping) const;
-		T sampleLinear(float time, bool bLooping) const;
-		T sampleCubic(float time, bool bLooping) const;
+		T sampleConstant(float trackTime) const;
+		T sampleLinear(float trackTime) const;
+		T sampleCubic(float trackTime) const;
 		T hermite(float time, const T& p1, const T& s1, const T& p2, const T& s2) const;
 		
-		virtual int32_t frameIndex(float time, bool bLooping) const;
+		// Frame right before a time within the keys, never the last one
+		virtual int32_t frameIndex(float trackTime) const;
 		float adjustTimeToFitTrack(float time, bool bLooping) const;
 
 		T cast(const float* value) const;	// Will be specialized
 	protected:
 		std::vector<AnimationKeyFrame<N>> keyframes;
+		std::vector<HermiteSegment<N>> hermiteSegments;
 		Interpolation interpolation;
+		QuaternionInterpolation quaternionInterpolation;
+		bool bPreconditioned;
 	};
 
 	using ScalarTrack = AnimationTrack<float, 1>;
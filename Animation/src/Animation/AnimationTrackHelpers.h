@@ -2,6 +2,8 @@
 
 #include <Math/Vector3.h>
 #include <Math/Quaternion.h>
+#include <Math/Interpolation.h>
+#include <Math/SIMD.h>
 
 using namespace Math;
 
@@ -31,6 +33,93 @@ namespace AnimationTrackHelpers
 		return normalized(result);
 	}
 
+	// Only rotations have a choice of interpolation
+	inline float interpolate(float source, float target, float t, QuaternionInterpolation mode)
+	{
+		return interpolate(source, target, t);
+	}
+
+	inline Vector3 interpolate(const Vector3& source, const Vector3& target, float t, QuaternionInterpolation mode)
+	{
+		return interpolate(source, target, t);
+	}
+
+	inline Quaternion interpolate(const Quaternion& source, const Quaternion& target, float t, QuaternionInterpolation mode)
+	{
+		if (mode == QuaternionInterpolation::FastSlerp)
+		{
+			return fastSlerp(source, target, t);
+		}
+		else if (mode == QuaternionInterpolation::Slerp)
+		{
+			return slerp(source, dot(source, target) < 0.0f ? -target : target, t);
+		}
+
+		return interpolate(source, target, t);
+	}
+
+	// interpolate for keys that are known to be normalized and in the same hemisphere
+	inline float interpolateAligned(float source, float target, float t, QuaternionInterpolation mode)
+	{
+		return interpolate(source, target, t);
+	}
+
+	inline Vector3 interpolateAligned(const Vector3& source, const Vector3& target, float t, QuaternionInterpolation mode)
+	{
+		return interpolate(source, target, t);
+	}
+
+	inline Quaternion interpolateAligned(const Quaternion& source, const Quaternion& target, float t, QuaternionInterpolation mode)
+	{
+		if (mode == QuaternionInterpolation::FastSlerp)
+		{
+			return fastSlerp(source, target, t);
+		}
+		else if (mode == QuaternionInterpolation::Slerp)
+		{
+			return slerp(source, target, t);
+		}
+
+		return nlerp(source, target, t);
+	}
+
+	// interpolate over arrays, bAligned as for interpolateAligned. Rotations go through the
+	// batched kernels of SIMD.h where the mode allows it.
+	inline void interpolateN(const float* source, const float* target, const float* t, float* out, uint32_t count, QuaternionInterpolation mode, bool bAligned)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			out[i] = interpolate(source[i], target[i], t[i]);
+		}
+	}
+
+	inline void interpolateN(const Vector3* source, const Vector3* target, const float* t, Vector3* out, uint32_t count, QuaternionInterpolation mode, bool bAligned)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			out[i] = interpolate(source[i], target[i], t[i]);
+		}
+	}
+
+	inline void interpolateN(const Quaternion* source, const Quaternion* target, const float* t, Quaternion* out, uint32_t count, QuaternionInterpolation mode, bool bAligned)
+	{
+		if (mode == QuaternionInterpolation::FastSlerp)
+		{
+			fastSlerpN(source, target, t, out, count);
+		}
+		else if (mode == QuaternionInterpolation::Nlerp && bAligned)
+		{
+			nlerpN(source, target, t, out, count);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				out[i] = bAligned ? interpolateAligned(source[i], target[i], t[i], mode) : interpolate(source[i], target[i], t[i], mode);
+			}
+		}
+	}
+
 	inline float adjustHermiteResult(float value)
 	{
 		return value;
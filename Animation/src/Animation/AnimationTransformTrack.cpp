@@ -1,5 +1,7 @@
 #include "AnimationTransformTrack.h"
 
+#include <Math/Math.h>
+
 namespace Animation
 {
 	template TAnimationTransformTrack<VectorTrack, QuaternionTrack>;
@@ -168,6 +170,72 @@ namespace Animation
 		return result;
 	}
 
+	template <typename TVectorTrack, typename TQuaternionTrack>
+	Transform TAnimationTransformTrack<TVectorTrack, TQuaternionTrack>::sampleInRange(const Transform& reference, float time) const
+	{
+		Transform result = reference;
+
+		if (position.frameCount() > 1)
+		{
+			result.position = position.sampleInRange(time);
+		}
+
+		if (rotation.frameCount() > 1)
+		{
+			result.rotation = rotation.sampleInRange(time);
+		}
+
+		if (scale.frameCount() > 1)
+		{
+			result.scale = scale.sampleInRange(time);
+		}
+
+		return result;
+	}
+
+	template <typename TVectorTrack, typename TQuaternionTrack>
+	void TAnimationTransformTrack<TVectorTrack, TQuaternionTrack>::sampleInRange(const float* times, Transform* inOutTransforms, uint32_t count) const
+	{
+		Vector3 vectors[SampleBatchSize];
+		Quaternion rotations[SampleBatchSize];
+
+		for (uint32_t first = 0; first < count; first += SampleBatchSize)
+		{
+			uint32_t batchCount = Min(count - first, SampleBatchSize);
+			Transform* transforms = inOutTransforms + first;
+
+			if (position.frameCount() > 1)
+			{
+				position.sampleInRange(times + first, vectors, batchCount);
+
+				for (uint32_t i = 0; i < batchCount; i++)
+				{
+					transforms[i].position = vectors[i];
+				}
+			}
+
+			if (rotation.frameCount() > 1)
+			{
+				rotation.sampleInRange(times + first, rotations, batchCount);
+
+				for (uint32_t i = 0; i < batchCount; i++)
+				{
+					transforms[i].rotation = rotations[i];
+				}
+			}
+
+			if (scale.frameCount() > 1)
+			{
+				scale.sampleInRange(times + first, vectors, batchCount);
+
+				for (uint32_t i = 0; i < batchCount; i++)
+				{
+					transforms[i].scale = vectors[i];
+				}
+			}
+		}
+	}
+
 	FastAnimationTransformTrack optimizeAnimationTransformTrack(AnimationTransformTrack& input)
 	{
 		FastAnimationTransformTrack result;
@@ -180,4 +248,3 @@ namespace Animation
 		return result;
 	}
 }
-
@@ -25,6 +25,12 @@ namespace Animation
 		bool isValid() const;
 		
 		Transform sample(const Transform& reference, float time, bool bLooping) const;
+
+		// Time already in the range of the clip, see AnimationTrack::sampleInRange
+		Transform sampleInRange(const Transform& reference, float time) const;
+
+		// Batched version, the transforms are the references on the way in
+		void sampleInRange(const float* times, Transform* inOutTransforms, uint32_t count) const;
 	protected:
 		uint32_t jointId;
 		TVectorTrack position;
@@ -9,34 +9,47 @@ namespace Animation
 	template <typename TAnimationClip>
 	CrossFadeController<TAnimationClip>::CrossFadeController()
 	{
+		firstTarget = 0;
+		numTargets = 0;
 		animationClip = nullptr;
-		time = 0.0f;
-		bWasSkeletonSet = false;
+		tick = 0;
+		skeleton = nullptr;
 	}
 	
 	template <typename TAnimationClip>
 	CrossFadeController<TAnimationClip>::CrossFadeController(const Skeleton& inSkeleton)
 	{
+		firstTarget = 0;
+		numTargets = 0;
 		animationClip = nullptr;
-		time = 0.0f;
-		setSkeleton(skeleton);
+		tick = 0;
+		setSkeleton(inSkeleton);
 	}
 
 	template <typename TAnimationClip>
 	void CrossFadeController<TAnimationClip>::setSkeleton(const Skeleton& inSkeleton)
 	{
-		skeleton = inSkeleton;
-		animationPose = skeleton.getRestPose();
-		bWasSkeletonSet = true;
+		skeleton = &inSkeleton;
+		animationPose = skeleton->getRestPose();
+
+		// Size every pooled pose up front, later copies of the rest pose reuse the storage
+		for (uint32_t i = 0; i < MaxFadeTargets; i++)
+		{
+			targetPoses[i] = animationPose;
+		}
+
+		firstTarget = 0;
+		numTargets = 0;
 	}
 
 	template <typename TAnimationClip>
 	void CrossFadeController<TAnimationClip>::play(TAnimationClip* target)
 	{
-		targets.clear();
+		firstTarget = 0;
+		numTargets = 0;
 		animationClip = target;
-		animationPose = skeleton.getRestPose();
-		time = target->getStartTime();
+		animationPose = skeleton->getRestPose();
+		tick = target->getStartTick();
 	}
 
 	template <typename TAnimationClip>
@@ -51,9 +64,9 @@ namespace Animation
 			return;
 		}
 
-		if (targets.size() >= 1)
+		if (numTargets >= 1)
 		{
-			auto lastAnimationClip = targets[targets.size() - 1].animationClip;
+			auto lastAnimationClip = targets[getSlot(numTargets - 1)].animationClip;
 			if (lastAnimationClip == target)
 			{
 				return;
@@ -67,44 +80,63 @@ namespace Animation
 			}
 		}
 
-		targets.emplace_back(CrossFadeTarget<TAnimationClip>(target, skeleton.getRestPose(), fadeTime));
+		// With the pool exhausted, the oldest fade is cut short and becomes the current clip
+		if (numTargets == MaxFadeTargets)
+		{
+			CrossFadeTarget<TAnimationClip>& oldest = targets[getSlot(0)];
+			animationClip = oldest.animationClip;
+			tick = oldest.tick;
+			retireFadeTargets(1);
+		}
+
+		uint32_t slot = getSlot(numTargets);
+		targets[slot] = CrossFadeTarget<TAnimationClip>(target, fadeTime);
+		targetPoses[slot] = skeleton->getRestPose();
+		numTargets++;
 	}
 
 	template <typename TAnimationClip>
 	void CrossFadeController<TAnimationClip>::update(float deltaTime)
 	{
-		if (animationClip == nullptr || !bWasSkeletonSet)
+		updateTicks(secondsToTicks(deltaTime));
+	}
+
+	template <typename TAnimationClip>
+	void CrossFadeController<TAnimationClip>::updateTicks(int64_t deltaTicks)
+	{
+		if (animationClip == nullptr || skeleton == nullptr)
 		{
 			return;
 		}
 
-		// Set the current animation as the target animation and remove the fade object if an
-		// animation has finished fading.Only one target is removed per frame.If you want to
-		// remove all the faded-out targets, change the loop to go backward
-		uint32_t numTargets = static_cast<uint32_t>(targets.size());
-
-		for (uint32_t i = 0; i < numTargets; i++)
+		// Set the current animation as the target animation once it has finished fading.
+		// Everything queued before it is fully blended out at that point, so the newest
+		// finished target retires itself and all older targets by advancing the ring head
+		for (uint32_t i = numTargets; i > 0; i--)
 		{
-			float duration = targets[i].duration;
+			CrossFadeTarget<TAnimationClip>& target = targets[getSlot(i - 1)];
 
-			if (targets[i].elapsed >= duration)
+			if (target.elapsed >= target.duration)
 			{
-				animationClip = targets[i].animationClip;
-				time = targets[i].time;
-				animationPose = targets[i].animationPose;
-				targets.erase(targets.begin() + i);
+				animationClip = target.animationClip;
+				tick = target.tick;
+				retireFadeTargets(i);
 				break;
 			}
 		}
 
-		numTargets = static_cast<uint32_t>(targets.size());
-		animationPose = skeleton.getRestPose();
-		time = animationClip->sample(animationPose, time + deltaTime);
+		animationPose = skeleton->getRestPose();
+		tick = animationClip->sampleAtTick(animationPose, tick + deltaTicks);
+
+		float deltaTime = ticksToSeconds(deltaTicks);
 
 		for (uint32_t i = 0; i < numTargets; i++)
 		{
-			CrossFadeTarget<TAnimationClip>& target = targets[i];
-			target.time = target.animationClip->sample(target.animationPose, target.time + deltaTime);
+			uint32_t slot = getSlot(i);
+			CrossFadeTarget<TAnimationClip>& target = targets[slot];
+			AnimationPose& targetPose = targetPoses[slot];
+
+			target.tick = target.animationClip->sampleAtTick(targetPose, target.tick + deltaTicks);
 
 			target.elapsed += deltaTime;
 			
@@ -115,7 +147,7 @@ namespace Animation
 				t = 1.0f;
 			}
 
-			blend(animationPose, animationPose, target.animationPose, t, -1);
+			blend(animationPose, animationPose, targetPose, t, -1);
 		}
 	}
 
@@ -136,4 +168,23 @@ namespace Animation
 	{
 		return animationClip;
 	}
+
+	template <typename TAnimationClip>
+	uint32_t CrossFadeController<TAnimationClip>::getNumFadeTargets() const
+	{
+		return numTargets;
+	}
+
+	template <typename TAnimationClip>
+	uint32_t CrossFadeController<TAnimationClip>::getSlot(uint32_t index) const
+	{
+		return (firstTarget + index) % MaxFadeTargets;
+	}
+
+	template <typename TAnimationClip>
+	void CrossFadeController<TAnimationClip>::retireFadeTargets(uint32_t count)
+	{
+		firstTarget = getSlot(count);
+		numTargets -= count;
+	}
 }
\ No newline at end of file
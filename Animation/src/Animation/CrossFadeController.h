@@ -5,29 +5,42 @@
 #include "AnimationClip.h"
 #include "CrossFadeTarget.h"
 
-#include <vector>
+#include <cstdint>
 
 namespace Animation
 {
+	// The controller references the skeleton passed to setSkeleton, which has to outlive it.
+	// Fade targets live in a fixed-size ring together with the poses they are sampled into,
+	// so play, fadeTo and update never touch the heap once the skeleton is set. Playback
+	// time is kept in ticks, so it doesn't drift no matter how long it runs.
 	template <typename TAnimationClip>
 	class CrossFadeController
 	{
 	public:
+		static constexpr uint32_t MaxFadeTargets = 8;
+
 		CrossFadeController();
 		CrossFadeController(const Skeleton& inSkeleton);
 		void setSkeleton(const Skeleton& inSkeleton);
 		void play(TAnimationClip* target);
 		void fadeTo(TAnimationClip* target, float fadeTime);
 		void update(float deltaTime);
+		void updateTicks(int64_t deltaTicks);
 		AnimationPose& getCurrentAnimationPose();
 		const AnimationPose& getCurrentAnimationPose() const;
 		TAnimationClip* getCurrentAnimationClip();
+		uint32_t getNumFadeTargets() const;
+	protected:
+		uint32_t getSlot(uint32_t index) const;
+		void retireFadeTargets(uint32_t count);
 	protected:
-		std::vector<CrossFadeTarget<TAnimationClip>> targets;
+		CrossFadeTarget<TAnimationClip> targets[MaxFadeTargets];
+		AnimationPose targetPoses[MaxFadeTargets];
+		uint32_t firstTarget;
+		uint32_t numTargets;
 		TAnimationClip* animationClip;
-		float time;
+		int64_t tick;
 		AnimationPose animationPose;
-		Skeleton skeleton;
-		bool bWasSkeletonSet;
+		const Skeleton* skeleton;
 	};
 }
\ No newline at end of file
@@ -1,33 +1,30 @@
 #pragma once
 
-#include "AnimationPose.h"
 #include "AnimationClip.h"
 
-#include <memory>
-
 namespace Animation
 {
+	// The pose a target is sampled into lives in the controller's pose pool,
+	// in the slot that matches the target's slot, so targets never own a pose.
 	template <typename TAnimationClip>
 	struct CrossFadeTarget
 	{
 		inline CrossFadeTarget() :
 			animationClip(nullptr),
-			time(0.0f),
+			tick(0),
 			duration(0.0f), 
 			elapsed(0.0f)
 		{}
 		
-		inline CrossFadeTarget(TAnimationClip* target, const AnimationPose& inAnimationPose, float inDuration)
+		inline CrossFadeTarget(TAnimationClip* target, float inDuration)
 		: animationClip(target),
-		  time(target->getStartTime()),
-		  animationPose(inAnimationPose),
+		  tick(target->getStartTick()),
 		  duration(inDuration),
 		  elapsed(0.0f)
 		{}
 		
-		AnimationPose animationPose;
 		TAnimationClip* animationClip;
-		float time;
+		int64_t tick;
 		float duration;
 		float elapsed;
 	};
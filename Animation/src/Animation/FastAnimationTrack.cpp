@@ -55,7 +55,7 @@ namespace Animation
 	}
 
 	template <typename T, int32_t N>
-	int32_t FastAnimationTrack<T, N>::frameIndex(float time, bool bLooping) const
+	int32_t FastAnimationTrack<T, N>::frameIndex(float trackTime) const
 	{
 		// The FrameIndex function is responsible for finding the frame right before a given time.
 		// The optimized FastTrack class uses a lookup array instead of looping through every
@@ -69,47 +69,41 @@ namespace Animation
 			return -1;
 		}
 
-		float adjustedTime = time;
-
-		if (bLooping)
+		if (trackTime <= keyframes[0].time)
 		{
-			float startTime = AnimationTrack<T, N>::keyframes[0].time;
-			float endTime = AnimationTrack<T, N>::keyframes[size - 1].time;
-			float duration = endTime - startTime;
-			
-			adjustedTime = Math::FMod(adjustedTime - startTime, duration);
-
-			if (adjustedTime < 0.0f)
-			{
-				adjustedTime += duration;
-			}
-			adjustedTime += startTime;
+			return 0;
 		}
-		else
-		{
-			if (time <= keyframes[0].time)
-			{
-				return 0;
-			}
 
-			if (time >= keyframes[size - 2].time)
-			{
-				return static_cast<int32_t>(size) - 2;
-			}
+		if (trackTime >= keyframes[size - 2].time)
+		{
+			return static_cast<int32_t>(size) - 2;
 		}
 		
-		float duration = AnimationTrack<T, N>::getEndTime() - AnimationTrack<T, N>::getStartTime();
+		uint32_t numSamples = static_cast<uint32_t>(sampledFrames.size());
 
-		float normalized = adjustedTime / duration;
-		uint32_t numSamples = static_cast<uint32_t>(duration * 60.0f);
-		uint32_t index = static_cast<uint32_t>(normalized * numSamples);
+		// Tracks shorter than two samples have no table
+		if (numSamples < 2)
+		{
+			return AnimationTrack<T, N>::frameIndex(trackTime);
+		}
 
-		if (index >= sampledFrames.size())
+		// The inverse of the sample times updateIndexLookupTable uses, the table starts at
+		// the first key and not at time 0
+		float startTime = AnimationTrack<T, N>::getStartTime();
+		float duration = AnimationTrack<T, N>::getEndTime() - startTime;
+		float normalized = (trackTime - startTime) / duration;
+		uint32_t index = Min(static_cast<uint32_t>(normalized * (numSamples - 1)), numSamples - 1);
+
+		// The sample before trackTime can still be before a key that is before trackTime
+		int32_t frame = static_cast<int32_t>(sampledFrames[index]);
+		int32_t lastFrame = static_cast<int32_t>(size) - 2;
+
+		while (frame < lastFrame && trackTime >= keyframes[frame + 1].time)
 		{
-			return -1;
+			frame++;
 		}
 
-		return sampledFrames[index];
+		return frame;
 	}
 	
 	template FastAnimationTrack<float, 1> optimizeAnimationTrack(AnimationTrack<float, 1>& input);
@@ -121,6 +115,7 @@ namespace Animation
 	{
 		FastAnimationTrack<T, N> result;
 		result.setInterpolation(input.getInterpolation());
+		result.setQuaternionInterpolation(input.getQuaternionInterpolation());
 
 		uint32_t frameCount = input.frameCount();
 		result.resize(frameCount);
@@ -132,6 +127,15 @@ namespace Animation
 
 		result.updateIndexLookupTable();
 
+		if (input.isPreconditioned())
+		{
+			result.precondition();
+		}
+		else
+		{
+			result.updateHermiteSegments();
+		}
+
 		return result;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "InertializationController.h"
+
+#include <Math/Math.h>
+
+namespace Animation
+{
+	template InertializationController<AnimationClip>;
+	template InertializationController<FastAnimationClip>;
+
+	namespace InertializationHelpers
+	{
+		// Angle and axis of a rotation, taking the shortest arc
+		inline float toAxisAngle(const Quaternion& quaternion, Vector3& outAxis)
+		{
+			Quaternion shortest = quaternion.w < 0.0f ? -quaternion : quaternion;
+
+			float w = Min(shortest.w, 1.0f);
+			float sinHalfAngle = Sqrt(1.0f - w * w);
+
+			if (sinHalfAngle < Epsilon)
+			{
+				outAxis = Vector3::X;
+				return 0.0f;
+			}
+
+			outAxis = Vector3(shortest.x, shortest.y, shortest.z) * (1.0f / sinHalfAngle);
+			return 2.0f * ACos(w);
+		}
+
+		inline void setVectorOffset(const Vector3& source, const Vector3& previous, const Vector3& destination,
+									float inverseDeltaTime, float fadeTime, Vector3& outAxis, InertializationCurve& outCurve)
+		{
+			Vector3 offset = source - destination;
+			Vector3 velocity = (source - previous) * inverseDeltaTime;
+			float offsetLength = length(offset);
+
+			outAxis = offsetLength > 0.0f ? offset * (1.0f / offsetLength) : Vector3::X;
+			outCurve.set(offsetLength, dot(velocity, outAxis), fadeTime);
+		}
+	}
+
+	template <typename TAnimationClip>
+	InertializationController<TAnimationClip>::InertializationController()
+	{
+		animationClip = nullptr;
+		tick = 0;
+		elapsed = 0.0f;
+		duration = 0.0f;
+		lastDeltaTime = 0.0f;
+		bInertializing = false;
+		skeleton = nullptr;
+	}
+
+	template <typename TAnimationClip>
+	InertializationController<TAnimationClip>::InertializationController(const Skeleton& inSkeleton)
+	{
+		animationClip = nullptr;
+		tick = 0;
+		elapsed = 0.0f;
+		duration = 0.0f;
+		lastDeltaTime = 0.0f;
+		bInertializing = false;
+		setSkeleton(inSkeleton);
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::setSkeleton(const Skeleton& inSkeleton)
+	{
+		skeleton = &inSkeleton;
+		animationPose = skeleton->getRestPose();
+		previousAnimationPose = animationPose;
+		targetAnimationPose = animationPose;
+		offsets.resize(animationPose.getSize());
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::play(TAnimationClip* target)
+	{
+		animationClip = target;
+		animationPose = skeleton->getRestPose();
+		previousAnimationPose = animationPose;
+		targetAnimationPose = animationPose;
+		tick = target->getStartTick();
+		elapsed = 0.0f;
+		duration = 0.0f;
+		lastDeltaTime = 0.0f;
+		bInertializing = false;
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::fadeTo(TAnimationClip* target, float fadeTime)
+	{
+		if (animationClip == nullptr)
+		{
+			play(target);
+			return;
+		}
+
+		if (animationClip == target)
+		{
+			return;
+		}
+
+		// The destination becomes the current clip right away. Whatever the pose was doing
+		// before (including an unfinished transition) is captured in the offsets. Starting
+		// from the rest pose drops the joints only the previous clip animated, updates then
+		// sample on top of it.
+		animationClip = target;
+		tick = target->getStartTick();
+		targetAnimationPose = skeleton->getRestPose();
+		animationClip->sampleAtTick(targetAnimationPose, tick);
+
+		recordOffsets(fadeTime);
+
+		elapsed = 0.0f;
+		duration = fadeTime;
+		bInertializing = true;
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::update(float deltaTime)
+	{
+		updateTicks(secondsToTicks(deltaTime));
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::updateTicks(int64_t deltaTicks)
+	{
+		if (animationClip == nullptr || skeleton == nullptr)
+		{
+			return;
+		}
+
+		previousAnimationPose = animationPose;
+
+		// Joints without a track still hold the rest pose from play or fadeTo
+		tick = animationClip->sampleAtTick(targetAnimationPose, tick + deltaTicks);
+
+		float deltaTime = ticksToSeconds(deltaTicks);
+
+		if (bInertializing)
+		{
+			elapsed += deltaTime;
+
+			if (elapsed >= duration)
+			{
+				bInertializing = false;
+			}
+		}
+
+		if (bInertializing)
+		{
+			applyOffsets();
+		}
+		else
+		{
+			animationPose = targetAnimationPose;
+		}
+
+		lastDeltaTime = deltaTime;
+	}
+
+	template <typename TAnimationClip>
+	AnimationPose& InertializationController<TAnimationClip>::getCurrentAnimationPose()
+	{
+		return animationPose;
+	}
+
+	template <typename TAnimationClip>
+	const AnimationPose& InertializationController<TAnimationClip>::getCurrentAnimationPose() const
+	{
+		return animationPose;
+	}
+
+	template <typename TAnimationClip>
+	TAnimationClip* InertializationController<TAnimationClip>::getCurrentAnimationClip()
+	{
+		return animationClip;
+	}
+
+	template <typename TAnimationClip>
+	bool InertializationController<TAnimationClip>::isInertializing() const
+	{
+		return bInertializing;
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::recordOffsets(float fadeTime)
+	{
+		uint32_t numJoints = animationPose.getSize();
+
+		if (offsets.size() != numJoints)
+		{
+			offsets.resize(numJoints);
+		}
+
+		float inverseDeltaTime = lastDeltaTime > 0.0f ? 1.0f / lastDeltaTime : 0.0f;
+
+		for (uint32_t i = 0; i < numJoints; i++)
+		{
+			const Transform& source = animationPose.getLocalTransform(i);
+			const Transform& previous = previousAnimationPose.getLocalTransform(i);
+			const Transform& destination = targetAnimationPose.getLocalTransform(i);
+			InertializationOffset& offset = offsets[i];
+
+			InertializationHelpers::setVectorOffset(source.position, previous.position, destination.position,
+													inverseDeltaTime, fadeTime, offset.positionAxis, offset.position);
+
+			InertializationHelpers::setVectorOffset(source.scale, previous.scale, destination.scale,
+													inverseDeltaTime, fadeTime, offset.scaleAxis, offset.scale);
+
+			// Rotation offset applied on top of the destination: destination * offset == source
+			Quaternion rotationOffset = inverse(destination.rotation) * source.rotation;
+			float angle = InertializationHelpers::toAxisAngle(rotationOffset, offset.rotationAxis);
+
+			Vector3 velocityAxis;
+			float velocityAngle = InertializationHelpers::toAxisAngle(inverse(previous.rotation) * source.rotation, velocityAxis);
+			Vector3 angularVelocity = velocityAxis * (velocityAngle * inverseDeltaTime);
+
+			offset.rotation.set(angle, dot(angularVelocity, offset.rotationAxis), fadeTime);
+		}
+	}
+
+	template <typename TAnimationClip>
+	void InertializationController<TAnimationClip>::applyOffsets()
+	{
+		uint32_t numJoints = targetAnimationPose.getSize();
+
+		for (uint32_t i = 0; i < numJoints; i++)
+		{
+			const InertializationOffset& offset = offsets[i];
+			Transform result = targetAnimationPose.getLocalTransform(i);
+
+			result.position = result.position + offset.positionAxis * offset.position.evaluate(elapsed);
+			result.scale = result.scale + offset.scaleAxis * offset.scale.evaluate(elapsed);
+
+			float angle = offset.rotation.evaluate(elapsed);
+
+			if (angle != 0.0f)
+			{
+				result.rotation = normalized(result.rotation * angleAxis(angle, offset.rotationAxis));
+			}
+
+			animationPose.setLocalTransform(i, result);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Skeleton.h"
+#include "AnimationPose.h"
+#include "AnimationClip.h"
+#include "InertializationOffset.h"
+
+#include <vector>
+
+namespace Animation
+{
+	// Drop-in alternative to CrossFadeController. Instead of sampling and blending every
+	// pending clip, a transition records the offset (and its velocity) between the current
+	// pose and the destination clip and decays that offset to zero. Only the destination
+	// clip is sampled, no matter how many transitions overlap. Like CrossFadeController it
+	// references the skeleton passed to setSkeleton, which has to outlive it, and keeps
+	// playback time in ticks.
+	template <typename TAnimationClip>
+	class InertializationController
+	{
+	public:
+		InertializationController();
+		InertializationController(const Skeleton& inSkeleton);
+		void setSkeleton(const Skeleton& inSkeleton);
+		void play(TAnimationClip* target);
+		void fadeTo(TAnimationClip* target, float fadeTime);
+		void update(float deltaTime);
+		void updateTicks(int64_t deltaTicks);
+		AnimationPose& getCurrentAnimationPose();
+		const AnimationPose& getCurrentAnimationPose() const;
+		TAnimationClip* getCurrentAnimationClip();
+		bool isInertializing() const;
+	protected:
+		void recordOffsets(float fadeTime);
+		void applyOffsets();
+	protected:
+		std::vector<InertializationOffset> offsets;
+		TAnimationClip* animationClip;
+		int64_t tick;
+		float elapsed;
+		float duration;
+		float lastDeltaTime;
+		bool bInertializing;
+		AnimationPose animationPose;
+		AnimationPose previousAnimationPose;
+		AnimationPose targetAnimationPose;
+		const Skeleton* skeleton;
+	};
+}
\ No newline at end of file
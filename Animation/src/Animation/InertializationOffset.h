@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Math/Math.h>
+#include <Math/Vector3.h>
+
+using namespace Math;
+
+namespace Animation
+{
+	// Quintic decay of a scalar offset (David Bollo, "Inertialization: High-Performance
+	// Animation Transitions in Gears of War"). The curve starts at x0 with velocity v0 and
+	// reaches zero with zero velocity and acceleration at the end of the blend.
+	struct InertializationCurve
+	{
+		inline InertializationCurve() :
+			x0(0.0f), v0(0.0f), a0(0.0f),
+			A(0.0f), B(0.0f), C(0.0f),
+			duration(0.0f)
+		{}
+
+		inline void set(float inX0, float inV0, float inDuration)
+		{
+			x0 = inX0;
+			v0 = inV0;
+			duration = inDuration;
+
+			if (x0 < Epsilon || duration <= 0.0f)
+			{
+				x0 = 0.0f;
+				v0 = 0.0f;
+				a0 = 0.0f;
+				A = B = C = 0.0f;
+				return;
+			}
+
+			// Moving away from the destination would overshoot, so drop that velocity
+			if (v0 > 0.0f)
+			{
+				v0 = 0.0f;
+			}
+
+			// Shorten the blend if the offset would cross zero before it ends
+			if (v0 < 0.0f)
+			{
+				duration = Min(duration, -5.0f * x0 / v0);
+			}
+
+			float duration2 = duration * duration;
+			float duration3 = duration2 * duration;
+
+			a0 = Max((-8.0f * v0 * duration - 20.0f * x0) / duration2, 0.0f);
+
+			A = -(a0 * duration2 + 6.0f * v0 * duration + 12.0f * x0) / (2.0f * duration3 * duration2);
+			B = (3.0f * a0 * duration2 + 16.0f * v0 * duration + 30.0f * x0) / (2.0f * duration2 * duration2);
+			C = -(3.0f * a0 * duration2 + 12.0f * v0 * duration + 20.0f * x0) / (2.0f * duration3);
+		}
+
+		inline float evaluate(float t) const
+		{
+			if (t >= duration)
+			{
+				return 0.0f;
+			}
+
+			return (((((A * t + B) * t + C) * t + 0.5f * a0) * t + v0) * t + x0);
+		}
+
+		float x0;
+		float v0;
+		float a0;
+		float A;
+		float B;
+		float C;
+		float duration;
+	};
+
+	// Per-joint offset between the pose at transition time and the destination clip.
+	// Position and scale are decayed along the offset direction, rotation around the
+	// axis of the offset rotation.
+	struct InertializationOffset
+	{
+		inline InertializationOffset() :
+			positionAxis(Vector3::X),
+			rotationAxis(Vector3::X),
+			scaleAxis(Vector3::X)
+		{}
+
+		Vector3 positionAxis;
+		Vector3 rotationAxis;
+		Vector3 scaleAxis;
+		InertializationCurve position;
+		InertializationCurve rotation;
+		InertializationCurve scale;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "PoseCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+namespace Animation
+{
+	template PoseCache<AnimationClip>;
+	template PoseCache<FastAnimationClip>;
+
+	template <typename TAnimationClip>
+	PoseCache<TAnimationClip>::PoseCache()
+	{
+		numEntries = 0;
+		maxEntries = 0;
+		timeQuantum = 1.0f / 60.0f;
+		numHits = 0;
+		numMisses = 0;
+	}
+
+	template <typename TAnimationClip>
+	PoseCache<TAnimationClip>::PoseCache(uint32_t capacity, float inTimeQuantum)
+	{
+		numEntries = 0;
+		maxEntries = 0;
+		timeQuantum = inTimeQuantum;
+		numHits = 0;
+		numMisses = 0;
+		setCapacity(capacity);
+	}
+
+	template <typename TAnimationClip>
+	void PoseCache<TAnimationClip>::setCapacity(uint32_t capacity)
+	{
+		entries.reset(capacity > 0 ? new Entry[capacity] : nullptr);
+		maxEntries = capacity;
+		numEntries = 0;
+
+		// Keep the table at most half full so probe sequences stay short
+		uint32_t tableSize = 1;
+
+		while (tableSize < capacity * 2)
+		{
+			tableSize *= 2;
+		}
+
+		table.assign(tableSize, -1);
+	}
+
+	template <typename TAnimationClip>
+	uint32_t PoseCache<TAnimationClip>::getCapacity() const
+	{
+		return maxEntries;
+	}
+
+	template <typename TAnimationClip>
+	void PoseCache<TAnimationClip>::setTimeQuantum(float inTimeQuantum)
+	{
+		timeQuantum = inTimeQuantum;
+		beginFrame();
+	}
+
+	template <typename TAnimationClip>
+	float PoseCache<TAnimationClip>::getTimeQuantum() const
+	{
+		return timeQuantum;
+	}
+
+	template <typename TAnimationClip>
+	void PoseCache<TAnimationClip>::beginFrame()
+	{
+		numEntries = 0;
+		std::fill(table.begin(), table.end(), -1);
+	}
+
+	template <typename TAnimationClip>
+	float PoseCache<TAnimationClip>::sample(const TAnimationClip& animationClip, AnimationPose& outAnimationPose, float time, const std::vector<bool>* activeJoints)
+	{
+		if (maxEntries == 0 || timeQuantum <= 0.0f || animationClip.getDuration() == 0.0f)
+		{
+			return activeJoints != nullptr ? animationClip.sample(outAnimationPose, time, *activeJoints) : animationClip.sample(outAnimationPose, time);
+		}
+
+		float adjustedTime = animationClip.adjustTimeToFitRange(time);
+		int32_t quantizedTime = static_cast<int32_t>(std::floor(adjustedTime / timeQuantum + 0.5f));
+
+		bool bAdded = false;
+		Entry* entry = findOrAddEntry(&animationClip, activeJoints, quantizedTime, bAdded);
+
+		if (entry == nullptr)
+		{
+			numMisses++;
+			return activeJoints != nullptr ? animationClip.sample(outAnimationPose, time, *activeJoints) : animationClip.sample(outAnimationPose, time);
+		}
+
+		if (bAdded)
+		{
+			numMisses++;
+
+			float quantized = quantizedTime * timeQuantum;
+
+			entry->animationPose = outAnimationPose;
+
+			if (activeJoints != nullptr)
+			{
+				animationClip.sample(entry->animationPose, quantized, *activeJoints);
+			}
+			else
+			{
+				animationClip.sample(entry->animationPose, quantized);
+			}
+
+			entry->bReady.store(true, std::memory_order_release);
+		}
+		else
+		{
+			numHits++;
+
+			// Another thread may still be sampling this entry
+			while (!entry->bReady.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		outAnimationPose = entry->animationPose;
+
+		// The caller keeps advancing from the exact time, not the quantized one
+		return adjustedTime;
+	}
+
+	template <typename TAnimationClip>
+	uint64_t PoseCache<TAnimationClip>::getNumHits() const
+	{
+		return numHits;
+	}
+
+	template <typename TAnimationClip>
+	uint64_t PoseCache<TAnimationClip>::getNumMisses() const
+	{
+		return numMisses;
+	}
+
+	template <typename TAnimationClip>
+	float PoseCache<TAnimationClip>::getHitRate() const
+	{
+		uint64_t hits = numHits;
+		uint64_t total = hits + numMisses;
+
+		return total > 0 ? static_cast<float>(hits) / total : 0.0f;
+	}
+
+	template <typename TAnimationClip>
+	void PoseCache<TAnimationClip>::resetStats()
+	{
+		numHits = 0;
+		numMisses = 0;
+	}
+
+	template <typename TAnimationClip>
+	typename PoseCache<TAnimationClip>::Entry* PoseCache<TAnimationClip>::findOrAddEntry(const TAnimationClip* animationClip, const std::vector<bool>* activeJoints, int32_t quantizedTime, bool& bOutAdded)
+	{
+		size_t hash = std::hash<const void*>()(animationClip);
+		hash ^= std::hash<const void*>()(activeJoints) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<int32_t>()(quantizedTime) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+		uint32_t mask = static_cast<uint32_t>(table.size()) - 1;
+		uint32_t slot = static_cast<uint32_t>(hash) & mask;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		for (;; slot = (slot + 1) & mask)
+		{
+			int32_t index = table[slot];
+
+			if (index < 0)
+			{
+				break;
+			}
+
+			Entry& entry = entries[index];
+
+			if (entry.animationClip == animationClip && entry.activeJoints == activeJoints && entry.quantizedTime == quantizedTime)
+			{
+				bOutAdded = false;
+				return &entry;
+			}
+		}
+
+		if (numEntries == maxEntries)
+		{
+			return nullptr;
+		}
+
+		Entry& entry = entries[numEntries];
+		entry.animationClip = animationClip;
+		entry.activeJoints = activeJoints;
+		entry.quantizedTime = quantizedTime;
+		entry.bReady.store(false, std::memory_order_relaxed);
+
+		table[slot] = static_cast<int32_t>(numEntries);
+		numEntries++;
+
+		bOutAdded = true;
+		return &entry;
+	}
+}
\ No newline at end of file
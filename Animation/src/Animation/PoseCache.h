@@ -0,0 +1,70 @@
+#pragma once
+
+#include "AnimationPose.h"
+#include "AnimationClip.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Animation
+{
+	// Shares sampled local poses between callers asking for the same clip at (almost) the
+	// same time. Requests are keyed by clip, time rounded to the time quantum and joint
+	// mask, the first one samples and the others copy its result. The poses are sampled
+	// on top of the rest pose, so the output pose passed to sample is expected to hold it,
+	// as it does when sampling from scratch.
+	//
+	// beginFrame drops every entry and should be called once per frame. When the cache is
+	// full, requests fall back to sampling the clip directly. sample can be called from
+	// several threads at once.
+	template <typename TAnimationClip>
+	class PoseCache
+	{
+	public:
+		PoseCache();
+		PoseCache(uint32_t capacity, float inTimeQuantum);
+
+		void setCapacity(uint32_t capacity);
+		uint32_t getCapacity() const;
+		void setTimeQuantum(float inTimeQuantum);
+		float getTimeQuantum() const;
+
+		void beginFrame();
+
+		// Same as TAnimationClip::sample, activeJoints is the optional joint mask
+		float sample(const TAnimationClip& animationClip, AnimationPose& outAnimationPose, float time, const std::vector<bool>* activeJoints = nullptr);
+
+		uint64_t getNumHits() const;
+		uint64_t getNumMisses() const;
+		float getHitRate() const;
+		void resetStats();
+
+	protected:
+		struct Entry
+		{
+			const TAnimationClip* animationClip;
+			const std::vector<bool>* activeJoints;
+			int32_t quantizedTime;
+			std::atomic<bool> bReady;
+			AnimationPose animationPose;
+		};
+
+		Entry* findOrAddEntry(const TAnimationClip* animationClip, const std::vector<bool>* activeJoints, int32_t quantizedTime, bool& bOutAdded);
+
+	protected:
+		std::unique_ptr<Entry[]> entries;
+		uint32_t numEntries;
+		uint32_t maxEntries;
+
+		// Open addressing table of entry indices, -1 for empty slots
+		std::vector<int32_t> table;
+
+		float timeQuantum;
+		std::mutex mutex;
+		std::atomic<uint64_t> numHits;
+		std::atomic<uint64_t> numMisses;
+	};
+}
\ No newline at end of file
@@ -109,6 +109,8 @@ namespace Animation
 			uint32_t newJointId = static_cast<uint32_t>(boneMap[jointId]);
 			animationClip.setJointIdAtIndex(i, newJointId);
 		}
+
+		animationClip.sortTracks();
 	}
 	
 	void rearrangeFastAnimationClip(AnimationClip& animationClip, BoneMap& boneMap)
@@ -124,6 +126,8 @@ namespace Animation
 			uint32_t newJointId = static_cast<uint32_t>(boneMap[jointId]);
 			animationClip.setJointIdAtIndex(i, newJointId);
 		}
+
+		animationClip.sortTracks();
 	}
 
 	void rearrangeSkeletalMesh(SkeletalMesh& skeletalMesh, BoneMap& boneMap)
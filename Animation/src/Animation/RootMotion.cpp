@@ -0,0 +1,317 @@
+#include "RootMotion.h"
+
+#include <Math/Math.h>
+#include <Math/Transform.h>
+
+#include <cmath>
+
+namespace Animation
+{
+	namespace RootMotionHelpers
+	{
+		// Around the up axis, the way angleAxis(yaw, Vector3::Y) rotates a vector
+		inline void rotate(float x, float z, float yaw, float& outX, float& outZ)
+		{
+			float cosine = Cos(yaw);
+			float sine = Sin(yaw);
+
+			outX = x * cosine + z * sine;
+			outZ = z * cosine - x * sine;
+		}
+
+		inline float wrapAngle(float angle)
+		{
+			return angle - 2.0f * PI * std::floor((angle + PI) / (2.0f * PI));
+		}
+
+		// Frames are rigid motions on the ground plane, a applied after b
+		template <typename TFrame>
+		inline TFrame compose(const TFrame& a, const TFrame& b)
+		{
+			TFrame result;
+			rotate(b.x, b.z, a.yaw, result.x, result.z);
+			result.x += a.x;
+			result.z += a.z;
+			result.yaw = a.yaw + b.yaw;
+
+			return result;
+		}
+
+		template <typename TFrame>
+		inline TFrame inverse(const TFrame& frame)
+		{
+			TFrame result;
+			rotate(-frame.x, -frame.z, -frame.yaw, result.x, result.z);
+			result.yaw = -frame.yaw;
+
+			return result;
+		}
+
+		// count loops of frame in closed form. With the plane as complex numbers z + ix the
+		// translation is the geometric series x * (1 - e^(i count yaw)) / (1 - e^(i yaw)).
+		template <typename TFrame>
+		inline TFrame repeat(const TFrame& frame, int64_t count)
+		{
+			if (count < 0)
+			{
+				return inverse(repeat(frame, -count));
+			}
+
+			float n = static_cast<float>(count);
+
+			TFrame result;
+			result.yaw = frame.yaw * n;
+
+			float denominatorReal = 1.0f - Cos(frame.yaw);
+			float denominatorImaginary = -Sin(frame.yaw);
+			float denominatorLength = denominatorReal * denominatorReal + denominatorImaginary * denominatorImaginary;
+
+			// Without turning the loops simply add up
+			if (denominatorLength < 1e-8f)
+			{
+				result.x = frame.x * n;
+				result.z = frame.z * n;
+				return result;
+			}
+
+			float numeratorReal = 1.0f - Cos(result.yaw);
+			float numeratorImaginary = -Sin(result.yaw);
+
+			float factorReal = (numeratorReal * denominatorReal + numeratorImaginary * denominatorImaginary) / denominatorLength;
+			float factorImaginary = (numeratorImaginary * denominatorReal - numeratorReal * denominatorImaginary) / denominatorLength;
+
+			result.z = frame.z * factorReal - frame.x * factorImaginary;
+			result.x = frame.z * factorImaginary + frame.x * factorReal;
+
+			return result;
+		}
+	}
+
+	Quaternion RootMotionDelta::getRotation() const
+	{
+		return angleAxis(yaw, Vector3::Y);
+	}
+
+	RootMotionTrack::RootMotionTrack()
+	{
+		jointId = 0;
+		frameRate = 30.0f;
+		startTime = 0.0f;
+		duration = 0.0f;
+		bLooping = true;
+	}
+
+	bool RootMotionTrack::extract(AnimationClip& animationClip, const AnimationPose& restPose, uint32_t inJointId, float inFrameRate)
+	{
+		if (animationClip.getDuration() <= 0.0f || inFrameRate <= 0.0f)
+		{
+			return false;
+		}
+
+		jointId = inJointId;
+		frameRate = inFrameRate;
+		startTime = animationClip.getStartTime();
+		duration = animationClip.getDuration();
+		bLooping = animationClip.isLooping();
+
+		uint32_t numFrames = static_cast<uint32_t>(std::ceil(duration * frameRate)) + 1;
+		int32_t parentId = restPose.getParent(jointId);
+
+		std::vector<Transform> globalTransforms(numFrames);
+		std::vector<Transform> parentTransforms(numFrames);
+		std::vector<float> times(numFrames);
+
+		// Sampled without looping, the last frame has to be the end of the clip and not
+		// wrap back to its start
+		animationClip.setLooping(false);
+
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			times[frame] = startTime + duration * static_cast<float>(frame) / (numFrames - 1);
+			globalTransforms[frame] = animationClip.sampleGlobalTransform(restPose, times[frame], jointId);
+
+			if (parentId >= 0)
+			{
+				parentTransforms[frame] = animationClip.sampleGlobalTransform(restPose, times[frame], parentId);
+			}
+		}
+
+		animationClip.setLooping(bLooping);
+
+		// The yaw is the twist of the rotation around the up axis, unwrapped so turning over
+		// several frames keeps adding up. Translations are turned into the frame the root
+		// faces on the first frame, which needn't be yaw 0.
+		frames.resize(numFrames);
+
+		const Vector3& firstPosition = globalTransforms[0].position;
+		const Quaternion& firstRotation = globalTransforms[0].rotation;
+		float initialYaw = 2.0f * std::atan2(firstRotation.y, firstRotation.w);
+		float previousYaw = 0.0f;
+		float yaw = 0.0f;
+
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			const Transform& globalTransform = globalTransforms[frame];
+			float frameYaw = 2.0f * std::atan2(globalTransform.rotation.y, globalTransform.rotation.w);
+
+			if (frame > 0)
+			{
+				yaw += RootMotionHelpers::wrapAngle(frameYaw - previousYaw);
+			}
+
+			previousYaw = frameYaw;
+
+			RootMotionHelpers::rotate(globalTransform.position.x - firstPosition.x, globalTransform.position.z - firstPosition.z,
+									  -initialYaw, frames[frame].x, frames[frame].z);
+			frames[frame].yaw = yaw;
+		}
+
+		// Take the motion out of the root, it stays where and how it was on the first frame
+		// apart from the height and the rotations that aren't yaw
+		AnimationTransformTrack& transformTrack = animationClip[jointId];
+		VectorTrack& positionTrack = transformTrack.getPositionTrack();
+		QuaternionTrack& rotationTrack = transformTrack.getRotationTrack();
+
+		positionTrack.resize(numFrames);
+		positionTrack.setInterpolation(Interpolation::Linear);
+		rotationTrack.resize(numFrames);
+		rotationTrack.setInterpolation(Interpolation::Linear);
+
+		Quaternion previousRotation;
+
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			const Transform& globalTransform = globalTransforms[frame];
+			Quaternion inverseYaw = angleAxis(-frames[frame].yaw, Vector3::Y);
+
+			Transform inPlace(Vector3(firstPosition.x, globalTransform.position.y, firstPosition.z),
+							  normalized(globalTransform.rotation * inverseYaw),
+							  globalTransform.scale);
+
+			Transform localTransform = parentId >= 0 ? combine(inverse(parentTransforms[frame]), inPlace) : inPlace;
+
+			// Keep the keys in one hemisphere, linear tracks interpolate them as they are
+			if (frame > 0 && dot(localTransform.rotation, previousRotation) < 0.0f)
+			{
+				localTransform.rotation = -localTransform.rotation;
+			}
+
+			previousRotation = localTransform.rotation;
+
+			// Linear keys, the tangents stay zero
+			AnimationKeyFrame<3>& positionKey = positionTrack[frame];
+			positionKey = AnimationKeyFrame<3>();
+			positionKey.time = times[frame];
+			positionKey.value[0] = localTransform.position.x;
+			positionKey.value[1] = localTransform.position.y;
+			positionKey.value[2] = localTransform.position.z;
+
+			AnimationKeyFrame<4>& rotationKey = rotationTrack[frame];
+			rotationKey = AnimationKeyFrame<4>();
+			rotationKey.time = times[frame];
+			rotationKey.value[0] = localTransform.rotation.x;
+			rotationKey.value[1] = localTransform.rotation.y;
+			rotationKey.value[2] = localTransform.rotation.z;
+			rotationKey.value[3] = localTransform.rotation.w;
+		}
+
+		positionTrack.updateHermiteSegments();
+		rotationTrack.updateHermiteSegments();
+
+		return true;
+	}
+
+	uint32_t RootMotionTrack::getJointId() const
+	{
+		return jointId;
+	}
+
+	uint32_t RootMotionTrack::getNumFrames() const
+	{
+		return static_cast<uint32_t>(frames.size());
+	}
+
+	float RootMotionTrack::getFrameRate() const
+	{
+		return frameRate;
+	}
+
+	float RootMotionTrack::getStartTime() const
+	{
+		return startTime;
+	}
+
+	float RootMotionTrack::getDuration() const
+	{
+		return duration;
+	}
+
+	bool RootMotionTrack::isLooping() const
+	{
+		return bLooping;
+	}
+
+	void RootMotionTrack::setLooping(bool bInLooping)
+	{
+		bLooping = bInLooping;
+	}
+
+	RootMotionDelta RootMotionTrack::getRootMotionDelta(float time0, float time1) const
+	{
+		RootMotionDelta result;
+
+		if (frames.size() < 2)
+		{
+			return result;
+		}
+
+		int64_t loop0 = 0;
+		int64_t loop1 = 0;
+		Frame frame0 = sampleFrame(time0, loop0);
+		Frame frame1 = sampleFrame(time1, loop1);
+
+		// Back to the start of the loop of time0, over the whole loops, then on to time1
+		Frame loops = RootMotionHelpers::repeat(frames.back(), loop1 - loop0);
+		Frame delta = RootMotionHelpers::compose(RootMotionHelpers::inverse(frame0), RootMotionHelpers::compose(loops, frame1));
+
+		result.translation = Vector3(delta.x, 0.0f, delta.z);
+		result.yaw = delta.yaw;
+
+		return result;
+	}
+
+	RootMotionDelta RootMotionTrack::getTrajectory(float time) const
+	{
+		return getRootMotionDelta(startTime, time);
+	}
+
+	RootMotionTrack::Frame RootMotionTrack::sampleFrame(float time, int64_t& outLoop) const
+	{
+		float clipTime = time - startTime;
+		outLoop = 0;
+
+		if (bLooping)
+		{
+			float loop = std::floor(clipTime / duration);
+			outLoop = static_cast<int64_t>(loop);
+			clipTime -= loop * duration;
+		}
+
+		clipTime = Min(Max(clipTime, 0.0f), duration);
+
+		uint32_t lastFrame = static_cast<uint32_t>(frames.size()) - 1;
+		float framePosition = clipTime / duration * lastFrame;
+		uint32_t frame = Min(static_cast<uint32_t>(framePosition), lastFrame - 1);
+		float t = framePosition - frame;
+
+		const Frame& from = frames[frame];
+		const Frame& to = frames[frame + 1];
+
+		Frame result;
+		result.x = from.x + (to.x - from.x) * t;
+		result.z = from.z + (to.z - from.z) * t;
+		result.yaw = from.yaw + (to.yaw - from.yaw) * t;
+
+		return result;
+	}
+}
\ No newline at end of file
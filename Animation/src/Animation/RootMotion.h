@@ -0,0 +1,84 @@
+#pragma once
+
+#include "AnimationPose.h"
+#include "AnimationClip.h"
+
+#include <Math/Vector3.h>
+#include <Math/Quaternion.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace Math;
+
+namespace Animation
+{
+	// Movement on the ground plane (y up) and turn around the up axis. A delta is expressed
+	// in the frame the character had at its start, an agent at position p facing yaw moves
+	// with p += rotation(yaw) * translation and yaw += delta yaw.
+	struct RootMotionDelta
+	{
+		inline RootMotionDelta() :
+			translation(Vector3::Zero),
+			yaw(0.0f)
+		{}
+
+		Vector3 translation;
+		float yaw;
+
+		Quaternion getRotation() const;
+	};
+
+	// Root motion of a clip, the horizontal movement and yaw of its root joint integrated
+	// at a fixed rate. extract removes it from the clip, which then plays in place, and keeps
+	// the trajectory relative to the first frame. Deltas between any two times are a lookup
+	// of the two frames around each plus the motion of whole loops in between, so moving a
+	// capsule doesn't need a pose.
+	class RootMotionTrack
+	{
+	public:
+		RootMotionTrack();
+
+		// Samples the global transform of the root joint, restPose holds the joints without
+		// a track. Its position and rotation tracks are replaced by linear ones at the same
+		// rate with the motion taken out. Returns false if the clip has no duration.
+		bool extract(AnimationClip& animationClip, const AnimationPose& restPose, uint32_t inJointId, float inFrameRate = 30.0f);
+
+		uint32_t getJointId() const;
+		uint32_t getNumFrames() const;
+		float getFrameRate() const;
+		float getStartTime() const;
+		float getDuration() const;
+
+		// Looping clips keep moving over the loops, the others stop at their ends, like
+		// TAnimationClip::sample. Taken from the clip on extract.
+		bool isLooping() const;
+		void setLooping(bool bInLooping);
+
+		// Motion from time0 to time1, clip times as passed to sample
+		RootMotionDelta getRootMotionDelta(float time0, float time1) const;
+
+		// Motion since the start of the clip, the trajectory of the root in the space of the
+		// first frame
+		RootMotionDelta getTrajectory(float time) const;
+
+	protected:
+		struct Frame
+		{
+			float x;
+			float z;
+			float yaw;
+		};
+
+		// Trajectory within one loop and the number of whole loops before time
+		Frame sampleFrame(float time, int64_t& outLoop) const;
+
+	protected:
+		std::vector<Frame> frames;
+		uint32_t jointId;
+		float frameRate;
+		float startTime;
+		float duration;
+		bool bLooping;
+	};
+}
\ No newline at end of file
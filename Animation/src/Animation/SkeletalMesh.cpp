@@ -181,21 +181,21 @@ namespace Animation
 		skinnedPosition.resize(numVertices);
 		skinnedNormal.resize(numVertices);
 		
-		animationPose.getMatrixPalette(animationPosePalette);
-
-		std::vector<Matrix4> inversePosePalette = skeleton.getInverseBindPose();
+		// Skinning matrices once per joint rather than four times per vertex
+		animationPosePalette.resize(animationPose.getSize());
+		animationPose.getSkinningPalette(skeleton.getAffineInverseBindPose(), animationPosePalette.data());
 
 		for (uint32_t i = 0; i < numVertices; i++)
 		{
 			Vector4i& jointIds = influenceJoints[i];
 			Vector4& weight = weights[i];
 
-			Matrix4 matrix0 = (animationPosePalette[jointIds.x] * inversePosePalette[jointIds.x]) * weight.x;
-			Matrix4 matrix1 = (animationPosePalette[jointIds.y] * inversePosePalette[jointIds.y]) * weight.y;
-			Matrix4 matrix2 = (animationPosePalette[jointIds.z] * inversePosePalette[jointIds.z]) * weight.z;
-			Matrix4 matrix3 = (animationPosePalette[jointIds.w] * inversePosePalette[jointIds.w]) * weight.w;
+			Matrix3x4 matrix0 = animationPosePalette[jointIds.x] * weight.x;
+			Matrix3x4 matrix1 = animationPosePalette[jointIds.y] * weight.y;
+			Matrix3x4 matrix2 = animationPosePalette[jointIds.z] * weight.z;
+			Matrix3x4 matrix3 = animationPosePalette[jointIds.w] * weight.w;
 
-			Matrix4 skinMatrix = matrix0 + matrix1 + matrix2 + matrix3;
+			Matrix3x4 skinMatrix = matrix0 + matrix1 + matrix2 + matrix3;
 
 			skinnedPosition[i] = transformPoint(skinMatrix, positions[i]);
 			skinnedNormal[i] = transformVector(skinMatrix, normals[i]);
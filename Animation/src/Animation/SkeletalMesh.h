@@ -77,7 +77,7 @@ namespace Animation
 		// as well as matrix palette for CPU skinning
 		std::vector<Vector3> skinnedPosition;
 		std::vector<Vector3> skinnedNormal;
-		std::vector<Matrix4> animationPosePalette;
+		std::vector<Matrix3x4> animationPosePalette;
 
 		bool bHasAnimation;
 	};
@@ -36,6 +36,11 @@ namespace Animation
 		return inverseBindPose;
 	}
 
+	const std::vector<Matrix3x4>& Skeleton::getAffineInverseBindPose() const
+	{
+		return affineInverseBindPose;
+	}
+
 	void Skeleton::getInverseBindPose(std::vector<DualQuaternion>& outInverseBindPose)
 	{
 		uint32_t size = bindPose.getSize();
@@ -63,11 +68,14 @@ namespace Animation
 	{
 		uint32_t size = bindPose.getSize();
 		inverseBindPose.resize(size);
+		affineInverseBindPose.resize(size);
 
+		// Bind poses are rotation, scale and translation, no need for the general inverse
 		for (uint32_t i = 0; i < size; i++)
 		{
 			Transform world = bindPose.getGlobalTransform(i);
-			inverseBindPose[i] = inverse(transformToMatrix4(world));
+			affineInverseBindPose[i] = inverse(transformToMatrix3x4(world));
+			inverseBindPose[i] = toMatrix4(affineInverseBindPose[i]);
 		}
 	}
 }
\ No newline at end of file
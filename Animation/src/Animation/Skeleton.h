@@ -3,6 +3,7 @@
 #include "AnimationPose.h"
 
 #include <Math/Matrix4.h>
+#include <Math/Matrix3x4.h>
 #include <Math/DualQuaternion.h>
 
 #include <string>
@@ -23,6 +24,7 @@ namespace Animation
 		const AnimationPose& getBindPose() const;
 		const AnimationPose& getRestPose() const;
 		const std::vector<Matrix4>& getInverseBindPose() const;
+		const std::vector<Matrix3x4>& getAffineInverseBindPose() const;
 		void getInverseBindPose(std::vector<DualQuaternion>& outInverseBindPose);
 		const std::vector<std::string>& getJointNames() const;
 		const std::string& getJointName(uint32_t index) const;
@@ -34,6 +36,7 @@ namespace Animation
 		AnimationPose restPose;
 		AnimationPose bindPose;
 		std::vector<Matrix4> inverseBindPose;
+		std::vector<Matrix3x4> affineInverseBindPose;
 		std::vector<std::string> jointNames;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,317 @@
+#include "SkeletonLOD.h"
+
+#include <spdlog/spdlog.h>
+
+#include <regex>
+
+namespace Animation
+{
+	SkeletonLOD::SkeletonLOD()
+	{
+	}
+
+	SkeletonLOD::SkeletonLOD(const Skeleton& skeleton)
+	{
+		set(skeleton, std::vector<bool>(skeleton.getRestPose().getSize(), true));
+	}
+
+	SkeletonLOD::SkeletonLOD(const Skeleton& skeleton, const std::vector<bool>& inActiveJoints)
+	{
+		set(skeleton, inActiveJoints);
+	}
+
+	void SkeletonLOD::set(const Skeleton& skeleton, const std::vector<bool>& inActiveJoints)
+	{
+		const AnimationPose& restPose = skeleton.getRestPose();
+		uint32_t size = restPose.getSize();
+
+		activeJoints.resize(size);
+		remappedJoints.resize(size);
+		activeJointIndices.clear();
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			// A joint stays active only if none of its ancestors was dropped
+			bool bActive = restPose.getParent(i) < 0 || (i < inActiveJoints.size() && inActiveJoints[i]);
+
+			for (int32_t parent = restPose.getParent(i); bActive && parent >= 0; parent = restPose.getParent(parent))
+			{
+				bActive = restPose.getParent(parent) < 0 || (static_cast<uint32_t>(parent) < inActiveJoints.size() && inActiveJoints[parent]);
+			}
+
+			activeJoints[i] = bActive;
+
+			if (bActive)
+			{
+				activeJointIndices.push_back(i);
+			}
+		}
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			int32_t joint = static_cast<int32_t>(i);
+
+			while (!activeJoints[joint])
+			{
+				joint = restPose.getParent(joint);
+			}
+
+			remappedJoints[i] = static_cast<uint32_t>(joint);
+		}
+	}
+
+	uint32_t SkeletonLOD::getSize() const
+	{
+		return static_cast<uint32_t>(activeJoints.size());
+	}
+
+	uint32_t SkeletonLOD::getNumActiveJoints() const
+	{
+		return static_cast<uint32_t>(activeJointIndices.size());
+	}
+
+	bool SkeletonLOD::isJointActive(uint32_t index) const
+	{
+		return activeJoints[index];
+	}
+
+	uint32_t SkeletonLOD::getRemappedJoint(uint32_t index) const
+	{
+		return remappedJoints[index];
+	}
+
+	const std::vector<bool>& SkeletonLOD::getActiveJoints() const
+	{
+		return activeJoints;
+	}
+
+	void SkeletonLOD::getSkinningPalette(const AnimationPose& animationPose, const std::vector<Matrix3x4>& inverseBindPose, Matrix3x4* out) const
+	{
+		uint32_t numActiveJoints = getNumActiveJoints();
+
+		// Global matrices of the active joints first, their parents are active as well
+		for (uint32_t i = 0; i < numActiveJoints; i++)
+		{
+			uint32_t joint = activeJointIndices[i];
+			int32_t parent = animationPose.getParent(joint);
+
+			if (parent > static_cast<int32_t>(joint))
+			{
+				out[joint] = transformToMatrix3x4(animationPose.getGlobalTransform(joint));
+			}
+			else if (parent >= 0)
+			{
+				out[joint] = out[parent] * transformToMatrix3x4(animationPose.getLocalTransform(joint));
+			}
+			else
+			{
+				out[joint] = transformToMatrix3x4(animationPose.getLocalTransform(joint));
+			}
+		}
+
+		for (uint32_t i = 0; i < numActiveJoints; i++)
+		{
+			uint32_t joint = activeJointIndices[i];
+			out[joint] = out[joint] * inverseBindPose[joint];
+		}
+
+		uint32_t size = getSize();
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			if (!activeJoints[i])
+			{
+				out[i] = out[remappedJoints[i]];
+			}
+		}
+	}
+
+	void SkeletonLOD::getSkinningPalette(const AnimationPose& animationPose, const std::vector<Matrix3x4>& inverseBindPose, Matrix4* out) const
+	{
+		uint32_t numActiveJoints = getNumActiveJoints();
+
+		// Global matrices of the active joints first, their parents are active as well
+		for (uint32_t i = 0; i < numActiveJoints; i++)
+		{
+			uint32_t joint = activeJointIndices[i];
+			int32_t parent = animationPose.getParent(joint);
+
+			if (parent > static_cast<int32_t>(joint))
+			{
+				out[joint] = transformToMatrix4(animationPose.getGlobalTransform(joint));
+			}
+			else if (parent >= 0)
+			{
+				out[joint] = multiplyAffine(out[parent], transformToMatrix3x4(animationPose.getLocalTransform(joint)));
+			}
+			else
+			{
+				out[joint] = transformToMatrix4(animationPose.getLocalTransform(joint));
+			}
+		}
+
+		for (uint32_t i = 0; i < numActiveJoints; i++)
+		{
+			uint32_t joint = activeJointIndices[i];
+			out[joint] = multiplyAffine(out[joint], inverseBindPose[joint]);
+		}
+
+		uint32_t size = getSize();
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			if (!activeJoints[i])
+			{
+				out[i] = out[remappedJoints[i]];
+			}
+		}
+	}
+
+	void SkeletonLOD::getSkinningPalette(const AnimationPose& animationPose, const std::vector<Matrix3x4>& inverseBindPose, std::vector<Matrix4>& out) const
+	{
+		if (out.size() != getSize())
+		{
+			out.resize(getSize());
+		}
+
+		if (getSize() != 0)
+		{
+			getSkinningPalette(animationPose, inverseBindPose, &out[0]);
+		}
+	}
+
+	SkeletonLOD createSkeletonLODByDepth(const Skeleton& skeleton, uint32_t maxDepth)
+	{
+		const AnimationPose& restPose = skeleton.getRestPose();
+		uint32_t size = restPose.getSize();
+		std::vector<bool> activeJoints(size);
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			uint32_t depth = 0;
+
+			for (int32_t parent = restPose.getParent(i); parent >= 0; parent = restPose.getParent(parent))
+			{
+				depth++;
+			}
+
+			activeJoints[i] = depth <= maxDepth;
+		}
+
+		return SkeletonLOD(skeleton, activeJoints);
+	}
+
+	SkeletonLOD createSkeletonLODByName(const Skeleton& skeleton, const std::string& pattern)
+	{
+		const std::vector<std::string>& jointNames = skeleton.getJointNames();
+		uint32_t size = skeleton.getRestPose().getSize();
+		std::vector<bool> activeJoints(size);
+		std::regex expression;
+
+		try
+		{
+			expression.assign(pattern);
+		}
+		catch (const std::regex_error& error)
+		{
+			spdlog::error("Invalid joint name pattern {0}: {1}\n", pattern, error.what());
+			return SkeletonLOD(skeleton);
+		}
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			activeJoints[i] = i >= jointNames.size() || !std::regex_search(jointNames[i], expression);
+		}
+
+		return SkeletonLOD(skeleton, activeJoints);
+	}
+
+	SkeletonLOD createSkeletonLODByWeight(const Skeleton& skeleton, const std::vector<SkeletalMesh>& meshes, float minWeight)
+	{
+		const AnimationPose& restPose = skeleton.getRestPose();
+		uint32_t size = restPose.getSize();
+		std::vector<float> jointWeights(size, 0.0f);
+		float totalWeight = 0.0f;
+
+		for (const auto& mesh : meshes)
+		{
+			const std::vector<Vector4>& weights = mesh.getWeights();
+			const std::vector<Vector4i>& influenceJoints = mesh.getInfluenceJoints();
+			uint32_t numVertices = static_cast<uint32_t>(weights.size());
+
+			for (uint32_t i = 0; i < numVertices; i++)
+			{
+				for (uint32_t j = 0; j < 4; j++)
+				{
+					int32_t joint = influenceJoints[i].elements[j];
+
+					if (joint >= 0 && static_cast<uint32_t>(joint) < size)
+					{
+						jointWeights[joint] += weights[i].elements[j];
+						totalWeight += weights[i].elements[j];
+					}
+				}
+			}
+		}
+
+		// A joint is kept if it, or anything below it, is heavy enough. Children are
+		// propagated to their parents until nothing changes, which doesn't depend on the
+		// joint order.
+		std::vector<bool> activeJoints(size);
+		float threshold = minWeight * totalWeight;
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			activeJoints[i] = jointWeights[i] >= threshold;
+		}
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			if (!activeJoints[i])
+			{
+				continue;
+			}
+
+			for (int32_t parent = restPose.getParent(i); parent >= 0 && !activeJoints[parent]; parent = restPose.getParent(parent))
+			{
+				activeJoints[parent] = true;
+			}
+		}
+
+		return SkeletonLOD(skeleton, activeJoints);
+	}
+
+	void remapSkeletalMesh(SkeletalMesh& skeletalMesh, const SkeletonLOD& skeletonLOD)
+	{
+		std::vector<Vector4>& weights = skeletalMesh.getWeights();
+		std::vector<Vector4i>& influenceJoints = skeletalMesh.getInfluenceJoints();
+		uint32_t numVertices = static_cast<uint32_t>(influenceJoints.size());
+		uint32_t size = skeletonLOD.getSize();
+
+		for (uint32_t i = 0; i < numVertices; i++)
+		{
+			Vector4i& joints = influenceJoints[i];
+			Vector4& weight = weights[i];
+
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				if (joints.elements[j] < 0 || static_cast<uint32_t>(joints.elements[j]) >= size)
+				{
+					continue;
+				}
+
+				joints.elements[j] = static_cast<int32_t>(skeletonLOD.getRemappedJoint(joints.elements[j]));
+
+				for (uint32_t k = 0; k < j; k++)
+				{
+					if (joints.elements[k] == joints.elements[j] && weight.elements[j] != 0.0f)
+					{
+						weight.elements[k] += weight.elements[j];
+						weight.elements[j] = 0.0f;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Skeleton.h"
+#include "SkeletalMesh.h"
+#include "AnimationPose.h"
+
+#include <Math/Matrix4.h>
+#include <Math/Matrix3x4.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Math;
+
+namespace Animation
+{
+	// Subset of the joints of a skeleton that is animated at one level of detail. Only whole
+	// subtrees are dropped: a joint is active only if its parent is, and root joints are
+	// always active. An inactive joint is remapped to its closest active ancestor, whose
+	// skinning matrix it shares.
+	class SkeletonLOD
+	{
+	public:
+		SkeletonLOD();
+		SkeletonLOD(const Skeleton& skeleton);
+		SkeletonLOD(const Skeleton& skeleton, const std::vector<bool>& inActiveJoints);
+
+		void set(const Skeleton& skeleton, const std::vector<bool>& inActiveJoints);
+
+		uint32_t getSize() const;
+		uint32_t getNumActiveJoints() const;
+		bool isJointActive(uint32_t index) const;
+		uint32_t getRemappedJoint(uint32_t index) const;
+		const std::vector<bool>& getActiveJoints() const;
+
+		// Skinning palette (global pose * inverse bind pose) where only the active joints
+		// are computed, the inactive ones copy the entry of the joint they are remapped to
+		void getSkinningPalette(const AnimationPose& animationPose, const std::vector<Matrix3x4>& inverseBindPose, Matrix3x4* out) const;
+		void getSkinningPalette(const AnimationPose& animationPose, const std::vector<Matrix3x4>& inverseBindPose, Matrix4* out) const;
+		void getSkinningPalette(const AnimationPose& animationPose, const std::vector<Matrix3x4>& inverseBindPose, std::vector<Matrix4>& out) const;
+
+	protected:
+		std::vector<bool> activeJoints;
+		std::vector<uint32_t> activeJointIndices;
+		std::vector<uint32_t> remappedJoints;
+	};
+
+	// Keeps the joints at most maxDepth parents away from a root
+	SkeletonLOD createSkeletonLODByDepth(const Skeleton& skeleton, uint32_t maxDepth);
+
+	// Drops the joints whose name matches the regular expression, and their children. An
+	// invalid expression is logged and drops nothing.
+	SkeletonLOD createSkeletonLODByName(const Skeleton& skeleton, const std::string& pattern);
+
+	// Drops the subtrees whose joints each carry less than minWeight of the total skinning
+	// weight of the meshes, e.g. 0.001 for a tenth of a percent
+	SkeletonLOD createSkeletonLODByWeight(const Skeleton& skeleton, const std::vector<SkeletalMesh>& meshes, float minWeight);
+
+	// Points the influences of the mesh at the joints they are remapped to, merging the
+	// weights of influences that end up on the same joint. The OpenGL buffers have to be
+	// updated afterwards.
+	void remapSkeletalMesh(SkeletalMesh& skeletalMesh, const SkeletonLOD& skeletonLOD);
+}
\ No newline at end of file
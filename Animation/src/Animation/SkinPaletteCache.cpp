@@ -0,0 +1,293 @@
+#include "SkinPaletteCache.h"
+
+#include <Math/Math.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace Animation
+{
+	template SkinPaletteCache<AnimationClip>;
+	template SkinPaletteCache<FastAnimationClip>;
+
+	template <typename TAnimationClip>
+	SkinPaletteCache<TAnimationClip>::SkinPaletteCache()
+	{
+		skeleton = nullptr;
+		frameRate = 30.0f;
+		memoryBudget = 64 * 1024 * 1024;
+		memoryUsage = 0;
+		useCounter = 0;
+		numBakes = 0;
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::setSkeleton(const Skeleton& inSkeleton)
+	{
+		skeleton = &inSkeleton;
+		animationPose = skeleton->getRestPose();
+		clear();
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::setFrameRate(float inFrameRate)
+	{
+		frameRate = inFrameRate;
+		clear();
+	}
+
+	template <typename TAnimationClip>
+	float SkinPaletteCache<TAnimationClip>::getFrameRate() const
+	{
+		return frameRate;
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::setMemoryBudget(size_t inMemoryBudget)
+	{
+		memoryBudget = inMemoryBudget;
+		evictUntilFits(0);
+	}
+
+	template <typename TAnimationClip>
+	size_t SkinPaletteCache<TAnimationClip>::getMemoryBudget() const
+	{
+		return memoryBudget;
+	}
+
+	template <typename TAnimationClip>
+	size_t SkinPaletteCache<TAnimationClip>::getMemoryUsage() const
+	{
+		return memoryUsage;
+	}
+
+	template <typename TAnimationClip>
+	size_t SkinPaletteCache<TAnimationClip>::getBakedSize(const TAnimationClip& animationClip) const
+	{
+		uint32_t numFrames = static_cast<uint32_t>(std::ceil(animationClip.getDuration() * frameRate)) + 1;
+
+		return static_cast<size_t>(numFrames) * animationPose.getSize() * FloatsPerJoint * sizeof(float);
+	}
+
+	template <typename TAnimationClip>
+	uint64_t SkinPaletteCache<TAnimationClip>::getNumBakes() const
+	{
+		return numBakes;
+	}
+
+	template <typename TAnimationClip>
+	const BakedSkinPalette* SkinPaletteCache<TAnimationClip>::bake(const TAnimationClip& animationClip)
+	{
+		auto found = bakedClips.find(&animationClip);
+
+		if (found != bakedClips.end())
+		{
+			found->second.lastUse = ++useCounter;
+			return &found->second;
+		}
+
+		if (skeleton == nullptr || frameRate <= 0.0f)
+		{
+			return nullptr;
+		}
+
+		uint32_t numJoints = animationPose.getSize();
+		float duration = animationClip.getDuration();
+		uint32_t numFrames = static_cast<uint32_t>(std::ceil(duration * frameRate)) + 1;
+		size_t size = getBakedSize(animationClip);
+
+		if (size > memoryBudget)
+		{
+			return nullptr;
+		}
+
+		evictUntilFits(size);
+
+		BakedSkinPalette& baked = bakedClips[&animationClip];
+		baked.frames.resize(static_cast<size_t>(numFrames) * numJoints * FloatsPerJoint);
+		baked.numFrames = numFrames;
+		baked.numJoints = numJoints;
+		baked.startTime = animationClip.getStartTime();
+		baked.duration = duration;
+		baked.lastUse = ++useCounter;
+
+		const std::vector<Matrix3x4>& inverseBindPose = skeleton->getAffineInverseBindPose();
+		palette.resize(numJoints);
+
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			// Spread the frames over the whole clip so the last one lands on the end time
+			float t = numFrames > 1 ? static_cast<float>(frame) / (numFrames - 1) : 0.0f;
+
+			animationPose = skeleton->getRestPose();
+			animationClip.sample(animationPose, baked.startTime + duration * t);
+			animationPose.getSkinningPalette(inverseBindPose, palette.data());
+
+			// A Matrix3x4 is exactly the three rows stored per joint
+			float* out = &baked.frames[static_cast<size_t>(frame) * numJoints * FloatsPerJoint];
+			std::memcpy(out, palette.data(), sizeof(Matrix3x4) * numJoints);
+		}
+
+		memoryUsage += size;
+		numBakes++;
+
+		return &baked;
+	}
+
+	template <typename TAnimationClip>
+	const BakedSkinPalette* SkinPaletteCache<TAnimationClip>::findBakedClip(const TAnimationClip& animationClip) const
+	{
+		auto found = bakedClips.find(&animationClip);
+
+		return found != bakedClips.end() ? &found->second : nullptr;
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::evict(const TAnimationClip& animationClip)
+	{
+		auto found = bakedClips.find(&animationClip);
+
+		if (found != bakedClips.end())
+		{
+			memoryUsage -= found->second.frames.size() * sizeof(float);
+			bakedClips.erase(found);
+		}
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::clear()
+	{
+		bakedClips.clear();
+		memoryUsage = 0;
+	}
+
+	template <typename TAnimationClip>
+	bool SkinPaletteCache<TAnimationClip>::samplePalette(const TAnimationClip& animationClip, float time, Matrix4* out) const
+	{
+		const float* frame0 = nullptr;
+		const float* frame1 = nullptr;
+		float t = 0.0f;
+		const BakedSkinPalette* baked = findFrames(animationClip, time, frame0, frame1, t);
+
+		if (baked == nullptr)
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < baked->numJoints; i++)
+		{
+			Matrix4& skin = out[i];
+
+			for (uint32_t row = 0; row < 3; row++)
+			{
+				for (uint32_t column = 0; column < 4; column++)
+				{
+					skin.elements[column * 4 + row] = *frame0 + (*frame1 - *frame0) * t;
+					frame0++;
+					frame1++;
+				}
+			}
+
+			skin.m30 = 0.0f;
+			skin.m31 = 0.0f;
+			skin.m32 = 0.0f;
+			skin.m33 = 1.0f;
+		}
+
+		return true;
+	}
+
+	template <typename TAnimationClip>
+	bool SkinPaletteCache<TAnimationClip>::samplePalette(const TAnimationClip& animationClip, float time, Matrix3x4* out) const
+	{
+		// Every joint is stored as the rows of a Matrix3x4
+		return samplePalette(animationClip, time, out->elements);
+	}
+
+	template <typename TAnimationClip>
+	bool SkinPaletteCache<TAnimationClip>::samplePalette(const TAnimationClip& animationClip, float time, float* out) const
+	{
+		const float* frame0 = nullptr;
+		const float* frame1 = nullptr;
+		float t = 0.0f;
+		const BakedSkinPalette* baked = findFrames(animationClip, time, frame0, frame1, t);
+
+		if (baked == nullptr)
+		{
+			return false;
+		}
+
+		uint32_t numFloats = baked->numJoints * FloatsPerJoint;
+
+		for (uint32_t i = 0; i < numFloats; i++)
+		{
+			out[i] = frame0[i] + (frame1[i] - frame0[i]) * t;
+		}
+
+		return true;
+	}
+
+	template <typename TAnimationClip>
+	const BakedSkinPalette* SkinPaletteCache<TAnimationClip>::findFrames(const TAnimationClip& animationClip, float time, const float*& outFrame0, const float*& outFrame1, float& outT) const
+	{
+		const BakedSkinPalette* baked = findBakedClip(animationClip);
+
+		if (baked == nullptr || baked->numFrames == 0)
+		{
+			return nullptr;
+		}
+
+		touch(*baked);
+
+		float position = 0.0f;
+
+		if (baked->duration > 0.0f)
+		{
+			float adjustedTime = animationClip.adjustTimeToFitRange(time);
+			position = (adjustedTime - baked->startTime) / baked->duration * (baked->numFrames - 1);
+		}
+
+		uint32_t lastFrame = baked->numFrames - 1;
+		uint32_t frame = static_cast<uint32_t>(Max(position, 0.0f));
+		frame = Min(frame, lastFrame);
+		uint32_t nextFrame = Min(frame + 1, lastFrame);
+
+		size_t stride = static_cast<size_t>(baked->numJoints) * FloatsPerJoint;
+		outFrame0 = &baked->frames[frame * stride];
+		outFrame1 = &baked->frames[nextFrame * stride];
+		outT = Min(Max(position - frame, 0.0f), 1.0f);
+
+		return baked;
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::evictUntilFits(size_t size)
+	{
+		while (memoryUsage + size > memoryBudget && !bakedClips.empty())
+		{
+			auto leastRecentlyUsed = bakedClips.begin();
+
+			for (auto it = bakedClips.begin(); it != bakedClips.end(); ++it)
+			{
+				if (it->second.lastUse < leastRecentlyUsed->second.lastUse)
+				{
+					leastRecentlyUsed = it;
+				}
+			}
+
+			memoryUsage -= leastRecentlyUsed->second.frames.size() * sizeof(float);
+			bakedClips.erase(leastRecentlyUsed);
+		}
+	}
+
+	template <typename TAnimationClip>
+	void SkinPaletteCache<TAnimationClip>::touch(const BakedSkinPalette& baked) const
+	{
+		// Only bump the counter when another clip was used since, instances sampling the
+		// same clip one after the other share one increment instead of contending on it
+		if (baked.lastUse.load(std::memory_order_relaxed) != useCounter.load(std::memory_order_relaxed))
+		{
+			baked.lastUse.store(useCounter.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+	}
+}
\ No newline at end of file
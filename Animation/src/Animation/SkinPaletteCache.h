@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Skeleton.h"
+#include "AnimationPose.h"
+#include "AnimationClip.h"
+
+#include <Math/Matrix4.h>
+#include <Math/Matrix3x4.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Animation
+{
+	// Skinning palettes of a clip (global pose * inverse bind pose) evaluated at a fixed
+	// rate. Every joint is stored as the top three rows of its matrix, 12 floats.
+	struct BakedSkinPalette
+	{
+		inline BakedSkinPalette() :
+			numFrames(0),
+			numJoints(0),
+			startTime(0.0f),
+			duration(0.0f),
+			lastUse(0)
+		{}
+
+		std::vector<float> frames;
+		uint32_t numFrames;
+		uint32_t numJoints;
+		float startTime;
+		float duration;
+
+		// Updated by the const sampling functions, possibly from several threads at once
+		mutable std::atomic<uint64_t> lastUse;
+	};
+
+	// CPU-side counterpart to bakeAnimationToTexture: trades memory for sampling. Clips are
+	// baked on first use and played back with two palette reads and a lerp per joint.
+	// When the baked clips exceed the memory budget, the least recently used ones are
+	// evicted, both bake and samplePalette count as a use. Baking and eviction aren't
+	// thread safe, findBakedClip and samplePalette on already baked clips are.
+	template <typename TAnimationClip>
+	class SkinPaletteCache
+	{
+	public:
+		static constexpr uint32_t FloatsPerJoint = 12;
+
+		SkinPaletteCache();
+
+		void setSkeleton(const Skeleton& inSkeleton);
+		void setFrameRate(float inFrameRate);
+		float getFrameRate() const;
+		void setMemoryBudget(size_t inMemoryBudget);
+		size_t getMemoryBudget() const;
+		size_t getMemoryUsage() const;
+
+		// Memory bake takes for the clip, whether it's baked or not
+		size_t getBakedSize(const TAnimationClip& animationClip) const;
+
+		// Clips baked since the cache was created, cache hits of bake not included
+		uint64_t getNumBakes() const;
+
+		// Bakes the clip unless it's already cached and marks it as used. Returns nullptr if
+		// the clip alone doesn't fit in the budget.
+		const BakedSkinPalette* bake(const TAnimationClip& animationClip);
+		const BakedSkinPalette* findBakedClip(const TAnimationClip& animationClip) const;
+
+		void evict(const TAnimationClip& animationClip);
+		void clear();
+
+		// time is wrapped or clamped like TAnimationClip::sample does. Returns false if the
+		// clip isn't baked.
+		bool samplePalette(const TAnimationClip& animationClip, float time, Matrix4* out) const;
+		bool samplePalette(const TAnimationClip& animationClip, float time, Matrix3x4* out) const;
+		bool samplePalette(const TAnimationClip& animationClip, float time, float* out) const;
+
+	protected:
+		const BakedSkinPalette* findFrames(const TAnimationClip& animationClip, float time, const float*& outFrame0, const float*& outFrame1, float& outT) const;
+		void evictUntilFits(size_t size);
+		void touch(const BakedSkinPalette& baked) const;
+
+	protected:
+		const Skeleton* skeleton;
+		float frameRate;
+		size_t memoryBudget;
+		size_t memoryUsage;
+		mutable std::atomic<uint64_t> useCounter;
+		uint64_t numBakes;
+		std::unordered_map<const TAnimationClip*, BakedSkinPalette> bakedClips;
+		AnimationPose animationPose;
+		std::vector<Matrix3x4> palette;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "VertexAnimationBaker.h"
+
+#include <Math/Math.h>
+
+#include <cmath>
+
+namespace Animation
+{
+	template void bakeVertexAnimation<AnimationClip>(const SkeletalMesh& mesh, const Skeleton& skeleton, const AnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture);
+	template void bakeVertexAnimation<FastAnimationClip>(const SkeletalMesh& mesh, const Skeleton& skeleton, const FastAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture);
+	template void bakeVertexAnimation<AnimationClip>(const SkeletalMesh& mesh, const Skeleton& skeleton, const AnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture, Util::JobSystem& jobSystem);
+	template void bakeVertexAnimation<FastAnimationClip>(const SkeletalMesh& mesh, const Skeleton& skeleton, const FastAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture, Util::JobSystem& jobSystem);
+
+	namespace VertexAnimationBakerHelpers
+	{
+		// Per-thread scratch data of the baker
+		struct BakeContext
+		{
+			AnimationPose pose;
+			std::vector<Matrix3x4> palette;
+		};
+
+		template <typename TAnimationClip>
+		inline void setupTexture(const SkeletalMesh& mesh, const TAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture)
+		{
+			float duration = animationClip.getDuration();
+			uint32_t numFrames = static_cast<uint32_t>(std::ceil(duration * Max(frameRate, 0.0f))) + 1;
+
+			texture.resize(static_cast<uint32_t>(mesh.getPositions().size()), numFrames);
+			texture.setClipInfo(animationClip.getName(), duration, animationClip.isLooping());
+		}
+
+		template <typename TAnimationClip>
+		inline void bakeFrame(const SkeletalMesh& mesh, const Skeleton& skeleton, const TAnimationClip& animationClip, uint32_t frame,
+							  VertexAnimationTexture& texture, BakeContext& context)
+		{
+			uint32_t numFrames = texture.getNumFrames();
+			float t = numFrames > 1 ? static_cast<float>(frame) / (numFrames - 1) : 0.0f;
+			float time = animationClip.getStartTime() + animationClip.getDuration() * t;
+
+			context.pose = skeleton.getRestPose();
+			animationClip.sample(context.pose, time);
+			context.palette.resize(context.pose.getSize());
+			context.pose.getSkinningPalette(skeleton.getAffineInverseBindPose(), context.palette.data());
+
+			const std::vector<Vector3>& positions = mesh.getPositions();
+			const std::vector<Vector3>& normals = mesh.getNormals();
+			const std::vector<Vector4>& weights = mesh.getWeights();
+			const std::vector<Vector4i>& influenceJoints = mesh.getInfluenceJoints();
+
+			uint32_t numVertices = texture.getNumVertices();
+			bool bHasNormals = normals.size() == positions.size();
+			bool bSkinned = weights.size() == positions.size() && influenceJoints.size() == positions.size();
+
+			for (uint32_t i = 0; i < numVertices; i++)
+			{
+				Vector3 normal = bHasNormals ? normals[i] : Vector3::Y;
+
+				if (!bSkinned)
+				{
+					texture.setVertex(frame, i, positions[i], normal);
+					continue;
+				}
+
+				const Vector4i& jointIds = influenceJoints[i];
+				const Vector4& weight = weights[i];
+
+				Matrix3x4 skinMatrix = context.palette[jointIds.x] * weight.x +
+									 context.palette[jointIds.y] * weight.y +
+									 context.palette[jointIds.z] * weight.z +
+									 context.palette[jointIds.w] * weight.w;
+
+				texture.setVertex(frame, i, transformPoint(skinMatrix, positions[i]), normalized(transformVector(skinMatrix, normal)));
+			}
+		}
+	}
+
+	template <typename TAnimationClip>
+	void bakeVertexAnimation(const SkeletalMesh& mesh, const Skeleton& skeleton, const TAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture)
+	{
+		VertexAnimationBakerHelpers::setupTexture(mesh, animationClip, frameRate, texture);
+
+		VertexAnimationBakerHelpers::BakeContext context;
+		uint32_t numFrames = texture.getNumFrames();
+
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			VertexAnimationBakerHelpers::bakeFrame(mesh, skeleton, animationClip, frame, texture, context);
+		}
+
+		texture.updateBounds();
+		texture.uploadTextureDataToGPU();
+	}
+
+	template <typename TAnimationClip>
+	void bakeVertexAnimation(const SkeletalMesh& mesh, const Skeleton& skeleton, const TAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture, Util::JobSystem& jobSystem)
+	{
+		VertexAnimationBakerHelpers::setupTexture(mesh, animationClip, frameRate, texture);
+
+		std::vector<VertexAnimationBakerHelpers::BakeContext> contexts(jobSystem.getNumWorkers());
+
+		// Frames write disjoint rows, so they can be baked in any order
+		jobSystem.parallelFor(texture.getNumFrames(), 4, [&](uint32_t begin, uint32_t end, uint32_t workerIndex)
+		{
+			for (uint32_t frame = begin; frame < end; frame++)
+			{
+				VertexAnimationBakerHelpers::bakeFrame(mesh, skeleton, animationClip, frame, texture, contexts[workerIndex]);
+			}
+		});
+
+		texture.updateBounds();
+		texture.uploadTextureDataToGPU();
+	}
+}
\ No newline at end of file
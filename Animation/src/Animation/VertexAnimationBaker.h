@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Skeleton.h"
+#include "SkeletalMesh.h"
+#include "AnimationClip.h"
+#include "VertexAnimationTexture.h"
+
+#include <Utils/JobSystem.h>
+
+namespace Animation
+{
+	// Runs the mesh through CPU skinning (matrix palette, four influences) at frameRate
+	// samples per second, the frames spread evenly so the last one lands on the end of the
+	// clip, and stores the skinned positions, normals and the bounds of every frame
+	template <typename TAnimationClip>
+	void bakeVertexAnimation(const SkeletalMesh& mesh, const Skeleton& skeleton, const TAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture);
+	template <typename TAnimationClip>
+	void bakeVertexAnimation(const SkeletalMesh& mesh, const Skeleton& skeleton, const TAnimationClip& animationClip, float frameRate, VertexAnimationTexture& texture, Util::JobSystem& jobSystem);
+}
\ No newline at end of file
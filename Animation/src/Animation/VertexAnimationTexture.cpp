@@ -0,0 +1,458 @@
+#include "VertexAnimationTexture.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <spdlog/spdlog.h>
+
+#include <Math/Math.h>
+
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+namespace Animation
+{
+	namespace VertexAnimationTextureHelpers
+	{
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t numVertices;
+			uint32_t numFrames;
+			uint32_t width;
+			uint32_t rowsPerFrame;
+			float duration;
+			uint32_t bLooping;
+			uint32_t nameLength;
+		};
+
+		inline int16_t toSnorm16(float value)
+		{
+			value = Min(Max(value, -1.0f), 1.0f);
+			return static_cast<int16_t>(std::lround(value * 32767.0f));
+		}
+
+		inline float fromSnorm16(int16_t value)
+		{
+			return Max(static_cast<float>(value) / 32767.0f, -1.0f);
+		}
+	}
+
+	VertexAnimationTexture::VertexAnimationTexture()
+	{
+		duration = 0.0f;
+		bLooping = false;
+		numVertices = 0;
+		numFrames = 0;
+		width = 0;
+		rowsPerFrame = 0;
+		glGenTextures(1, &positionHandle);
+		glGenTextures(1, &normalHandle);
+	}
+
+	VertexAnimationTexture::VertexAnimationTexture(const VertexAnimationTexture& other)
+	{
+		duration = 0.0f;
+		bLooping = false;
+		numVertices = 0;
+		numFrames = 0;
+		width = 0;
+		rowsPerFrame = 0;
+		glGenTextures(1, &positionHandle);
+		glGenTextures(1, &normalHandle);
+
+		*this = other;
+	}
+
+	VertexAnimationTexture::~VertexAnimationTexture()
+	{
+		glDeleteTextures(1, &positionHandle);
+		glDeleteTextures(1, &normalHandle);
+	}
+
+	VertexAnimationTexture& VertexAnimationTexture::operator=(const VertexAnimationTexture& other)
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
+		positions = other.positions;
+		normals = other.normals;
+		bounds = other.bounds;
+		name = other.name;
+		duration = other.duration;
+		bLooping = other.bLooping;
+		numVertices = other.numVertices;
+		numFrames = other.numFrames;
+		width = other.width;
+		rowsPerFrame = other.rowsPerFrame;
+
+		return *this;
+	}
+
+	bool VertexAnimationTexture::save(const std::string& path)
+	{
+		std::ofstream file;
+
+		file.open(path, std::ios::out | std::ios::binary);
+
+		if (!file.is_open())
+		{
+			spdlog::error("Couldn't open {0}\n", path);
+			return false;
+		}
+
+		VertexAnimationTextureHelpers::FileHeader header;
+		header.magic = FileMagic;
+		header.version = FileVersion;
+		header.numVertices = numVertices;
+		header.numFrames = numFrames;
+		header.width = width;
+		header.rowsPerFrame = rowsPerFrame;
+		header.duration = duration;
+		header.bLooping = bLooping ? 1 : 0;
+		header.nameLength = static_cast<uint32_t>(name.size());
+
+		file.write((char*)&header, sizeof(VertexAnimationTextureHelpers::FileHeader));
+		file.write(name.data(), name.size());
+
+		if (!bounds.empty())
+		{
+			file.write((char*)&bounds[0], sizeof(VertexAnimationBounds) * bounds.size());
+		}
+
+		if (!positions.empty())
+		{
+			file.write((char*)&positions[0], sizeof(float) * positions.size());
+			file.write((char*)&normals[0], sizeof(int16_t) * normals.size());
+		}
+
+		file.close();
+
+		return true;
+	}
+
+	bool VertexAnimationTexture::load(const std::string& path)
+	{
+		std::ifstream file;
+
+		file.open(path, std::ios::in | std::ios::binary);
+
+		if (!file.is_open())
+		{
+			spdlog::error("Couldn't open {0}\n", path);
+			return false;
+		}
+
+		VertexAnimationTextureHelpers::FileHeader header;
+		file.read((char*)&header, sizeof(VertexAnimationTextureHelpers::FileHeader));
+
+		if (!file.good() || header.magic != FileMagic)
+		{
+			spdlog::error("{0} isn't a vertex animation texture\n", path);
+			return false;
+		}
+
+		if (header.version != FileVersion)
+		{
+			spdlog::error("{0} has version {1}, expected {2}\n", path, header.version, FileVersion);
+			return false;
+		}
+
+		if (header.width == 0 || header.rowsPerFrame != (header.numVertices + header.width - 1) / header.width || header.nameLength > 4096)
+		{
+			spdlog::error("{0} is corrupt\n", path);
+			return false;
+		}
+
+		name.resize(header.nameLength);
+
+		if (header.nameLength > 0)
+		{
+			file.read(&name[0], header.nameLength);
+		}
+
+		duration = header.duration;
+		bLooping = header.bLooping != 0;
+
+		resize(header.numVertices, header.numFrames, header.width);
+
+		if (!bounds.empty())
+		{
+			file.read((char*)&bounds[0], sizeof(VertexAnimationBounds) * bounds.size());
+		}
+
+		if (!positions.empty())
+		{
+			file.read((char*)&positions[0], sizeof(float) * positions.size());
+			file.read((char*)&normals[0], sizeof(int16_t) * normals.size());
+		}
+
+		if (!file.good())
+		{
+			spdlog::error("Couldn't read the vertex animation data of {0}\n", path);
+			return false;
+		}
+
+		uploadTextureDataToGPU();
+
+		return true;
+	}
+
+	void VertexAnimationTexture::uploadTextureDataToGPU()
+	{
+		uint32_t height = getHeight();
+
+		glBindTexture(GL_TEXTURE_2D, positionHandle);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, positions.empty() ? nullptr : &positions[0]);
+
+		// Vertices aren't continuous, neighbouring texels must never be blended
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glBindTexture(GL_TEXTURE_2D, normalHandle);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16_SNORM, width, height, 0, GL_RG, GL_SHORT, normals.empty() ? nullptr : &normals[0]);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void VertexAnimationTexture::resize(uint32_t inNumVertices, uint32_t inNumFrames, uint32_t maxWidth)
+	{
+		numVertices = inNumVertices;
+		numFrames = inNumFrames;
+		width = Max(Min(numVertices, maxWidth), 1u);
+		rowsPerFrame = (numVertices + width - 1) / width;
+
+		size_t numTexels = static_cast<size_t>(width) * getHeight();
+		positions.assign(numTexels * 3, 0.0f);
+		normals.assign(numTexels * 2, 0);
+		bounds.assign(numFrames, VertexAnimationBounds());
+	}
+
+	uint32_t VertexAnimationTexture::getNumVertices() const
+	{
+		return numVertices;
+	}
+
+	uint32_t VertexAnimationTexture::getNumFrames() const
+	{
+		return numFrames;
+	}
+
+	uint32_t VertexAnimationTexture::getWidth() const
+	{
+		return width;
+	}
+
+	uint32_t VertexAnimationTexture::getRowsPerFrame() const
+	{
+		return rowsPerFrame;
+	}
+
+	uint32_t VertexAnimationTexture::getHeight() const
+	{
+		return rowsPerFrame * numFrames;
+	}
+
+	void VertexAnimationTexture::setClipInfo(const std::string& inName, float inDuration, bool bInLooping)
+	{
+		name = inName;
+		duration = inDuration;
+		bLooping = bInLooping;
+	}
+
+	const std::string& VertexAnimationTexture::getName() const
+	{
+		return name;
+	}
+
+	float VertexAnimationTexture::getDuration() const
+	{
+		return duration;
+	}
+
+	bool VertexAnimationTexture::isLooping() const
+	{
+		return bLooping;
+	}
+
+	float VertexAnimationTexture::getFrame(float time) const
+	{
+		if (numFrames < 2 || duration <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float t = time / duration;
+
+		if (bLooping)
+		{
+			t = t - std::floor(t);
+		}
+		else
+		{
+			t = Min(Max(t, 0.0f), 1.0f);
+		}
+
+		return t * (numFrames - 1);
+	}
+
+	void VertexAnimationTexture::setVertex(uint32_t frame, uint32_t vertex, const Vector3& position, const Vector3& normal)
+	{
+		size_t index = getTexelIndex(frame, vertex);
+
+		positions[index * 3 + 0] = position.x;
+		positions[index * 3 + 1] = position.y;
+		positions[index * 3 + 2] = position.z;
+
+		Vector2 encoded = octahedralEncode(normal);
+
+		normals[index * 2 + 0] = VertexAnimationTextureHelpers::toSnorm16(encoded.x);
+		normals[index * 2 + 1] = VertexAnimationTextureHelpers::toSnorm16(encoded.y);
+	}
+
+	Vector3 VertexAnimationTexture::getPosition(uint32_t frame, uint32_t vertex) const
+	{
+		size_t index = getTexelIndex(frame, vertex);
+
+		return Vector3(positions[index * 3 + 0], positions[index * 3 + 1], positions[index * 3 + 2]);
+	}
+
+	Vector3 VertexAnimationTexture::getNormal(uint32_t frame, uint32_t vertex) const
+	{
+		size_t index = getTexelIndex(frame, vertex);
+
+		Vector2 encoded(VertexAnimationTextureHelpers::fromSnorm16(normals[index * 2 + 0]),
+						VertexAnimationTextureHelpers::fromSnorm16(normals[index * 2 + 1]));
+
+		return octahedralDecode(encoded);
+	}
+
+	Vector3 VertexAnimationTexture::getPosition(float time, uint32_t vertex) const
+	{
+		float frame = getFrame(time);
+
+		uint32_t frame0 = static_cast<uint32_t>(frame);
+		uint32_t frame1 = Min(frame0 + 1, numFrames > 0 ? numFrames - 1 : 0);
+
+		return lerp(getPosition(frame0, vertex), getPosition(frame1, vertex), frame - frame0);
+	}
+
+	const std::vector<float>& VertexAnimationTexture::getPositions() const
+	{
+		return positions;
+	}
+
+	const std::vector<int16_t>& VertexAnimationTexture::getNormals() const
+	{
+		return normals;
+	}
+
+	void VertexAnimationTexture::updateBounds()
+	{
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			Vector3 minimum(FLT_MAX);
+			Vector3 maximum(-FLT_MAX);
+
+			for (uint32_t vertex = 0; vertex < numVertices; vertex++)
+			{
+				Vector3 position = getPosition(frame, vertex);
+
+				for (uint32_t i = 0; i < 3; i++)
+				{
+					minimum.elements[i] = Min(minimum.elements[i], position.elements[i]);
+					maximum.elements[i] = Max(maximum.elements[i], position.elements[i]);
+				}
+			}
+
+			bounds[frame].minimum = numVertices > 0 ? minimum : Vector3::Zero;
+			bounds[frame].maximum = numVertices > 0 ? maximum : Vector3::Zero;
+		}
+	}
+
+	const VertexAnimationBounds& VertexAnimationTexture::getBounds(uint32_t frame) const
+	{
+		return bounds[frame];
+	}
+
+	const std::vector<VertexAnimationBounds>& VertexAnimationTexture::getBounds() const
+	{
+		return bounds;
+	}
+
+	VertexAnimationBounds VertexAnimationTexture::getBounds(float time) const
+	{
+		if (bounds.empty())
+		{
+			return VertexAnimationBounds();
+		}
+
+		float frame = getFrame(time);
+
+		uint32_t frame0 = static_cast<uint32_t>(frame);
+		uint32_t frame1 = Min(frame0 + 1, numFrames - 1);
+
+		VertexAnimationBounds result = bounds[frame0];
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			result.minimum.elements[i] = Min(result.minimum.elements[i], bounds[frame1].minimum.elements[i]);
+			result.maximum.elements[i] = Max(result.maximum.elements[i], bounds[frame1].maximum.elements[i]);
+		}
+
+		return result;
+	}
+
+	size_t VertexAnimationTexture::getGPUMemorySize() const
+	{
+		return positions.size() * sizeof(float) + normals.size() * sizeof(int16_t);
+	}
+
+	void VertexAnimationTexture::bind(uint32_t positionUniformIndex, uint32_t positionTextureIndex, uint32_t normalUniformIndex, uint32_t normalTextureIndex)
+	{
+		glActiveTexture(GL_TEXTURE0 + positionTextureIndex);
+		glBindTexture(GL_TEXTURE_2D, positionHandle);
+		glUniform1i(positionUniformIndex, positionTextureIndex);
+
+		glActiveTexture(GL_TEXTURE0 + normalTextureIndex);
+		glBindTexture(GL_TEXTURE_2D, normalHandle);
+		glUniform1i(normalUniformIndex, normalTextureIndex);
+	}
+
+	void VertexAnimationTexture::unbind(uint32_t positionTextureIndex, uint32_t normalTextureIndex)
+	{
+		glActiveTexture(GL_TEXTURE0 + positionTextureIndex);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0 + normalTextureIndex);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	uint32_t VertexAnimationTexture::getPositionHandle() const
+	{
+		return positionHandle;
+	}
+
+	uint32_t VertexAnimationTexture::getNormalHandle() const
+	{
+		return normalHandle;
+	}
+
+	size_t VertexAnimationTexture::getTexelIndex(uint32_t frame, uint32_t vertex) const
+	{
+		size_t row = static_cast<size_t>(frame) * rowsPerFrame + vertex / width;
+
+		return row * width + vertex % width;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Math/Vector2.h>
+#include <Math/Vector3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Math;
+
+namespace Animation
+{
+	struct VertexAnimationBounds
+	{
+		inline VertexAnimationBounds() :
+			minimum(Vector3::Zero),
+			maximum(Vector3::Zero)
+		{}
+
+		Vector3 minimum;
+		Vector3 maximum;
+	};
+
+	// Pre-skinned vertices of a mesh playing a clip, sampled at a fixed rate. Positions are
+	// RGB32F texels and normals octahedral encoded RG16_SNORM texels, the same layout in two
+	// textures. Every frame takes rowsPerFrame rows of width texels, vertex v of frame f sits
+	// at (v % width, f * rowsPerFrame + v / width). Playback is a texture fetch per vertex,
+	// the per-frame bounds are there for culling.
+	class VertexAnimationTexture
+	{
+	public:
+		// "VATX"
+		static constexpr uint32_t FileMagic = 0x58544156;
+		static constexpr uint32_t FileVersion = 1;
+		static constexpr uint32_t DefaultMaxWidth = 4096;
+
+		VertexAnimationTexture();
+		VertexAnimationTexture(const VertexAnimationTexture& other);
+		VertexAnimationTexture& operator=(const VertexAnimationTexture& other);
+		~VertexAnimationTexture();
+
+		bool save(const std::string& path);
+		bool load(const std::string& path);
+
+		void uploadTextureDataToGPU();
+
+		void resize(uint32_t inNumVertices, uint32_t inNumFrames, uint32_t maxWidth = DefaultMaxWidth);
+
+		uint32_t getNumVertices() const;
+		uint32_t getNumFrames() const;
+		uint32_t getWidth() const;
+		uint32_t getRowsPerFrame() const;
+		uint32_t getHeight() const;
+
+		// Clip the frames were sampled from, evenly spread over its duration
+		void setClipInfo(const std::string& inName, float inDuration, bool bInLooping);
+		const std::string& getName() const;
+		float getDuration() const;
+		bool isLooping() const;
+
+		// Fractional frame at a time since the start of the clip. Looping clips wrap, the
+		// others clamp.
+		float getFrame(float time) const;
+
+		void setVertex(uint32_t frame, uint32_t vertex, const Vector3& position, const Vector3& normal);
+		Vector3 getPosition(uint32_t frame, uint32_t vertex) const;
+		Vector3 getNormal(uint32_t frame, uint32_t vertex) const;
+
+		// Vertex interpolated between the two nearest frames
+		Vector3 getPosition(float time, uint32_t vertex) const;
+
+		const std::vector<float>& getPositions() const;
+		const std::vector<int16_t>& getNormals() const;
+
+		// Recomputes the bounds of every frame from the positions
+		void updateBounds();
+		const VertexAnimationBounds& getBounds(uint32_t frame) const;
+		const std::vector<VertexAnimationBounds>& getBounds() const;
+
+		// Union of the bounds of the two frames around time
+		VertexAnimationBounds getBounds(float time) const;
+
+		size_t getGPUMemorySize() const;
+
+		void bind(uint32_t positionUniformIndex, uint32_t positionTextureIndex, uint32_t normalUniformIndex, uint32_t normalTextureIndex);
+		void unbind(uint32_t positionTextureIndex, uint32_t normalTextureIndex);
+
+		uint32_t getPositionHandle() const;
+		uint32_t getNormalHandle() const;
+
+	protected:
+		size_t getTexelIndex(uint32_t frame, uint32_t vertex) const;
+
+	protected:
+		std::vector<float> positions;
+		std::vector<int16_t> normals;
+		std::vector<VertexAnimationBounds> bounds;
+		std::string name;
+		float duration;
+		bool bLooping;
+		uint32_t numVertices;
+		uint32_t numFrames;
+		uint32_t width;
+		uint32_t rowsPerFrame;
+		uint32_t positionHandle;
+		uint32_t normalHandle;
+	};
+}
\ No newline at end of file
@@ -138,7 +138,9 @@ void DemoApplication::prepareRenderResources()
 
 	if (bPrecomputeSkin)
 	{
-		skinnedMeshShader = std::make_shared<Shader>("Assets/Shaders/PrecomputeSkinnedMesh.vert.spv", "Assets/Shaders/PrecomputeSkinnedMesh.frag.spv");
+		// The skinning palette goes up as 3x4 rows in a storage buffer, see updatePrecomputedGPUSkin
+		skinnedMeshShader = std::make_shared<Shader>("Assets/Shaders/AffineSkinning.vert.spv", "Assets/Shaders/PrecomputeSkinnedMesh.frag.spv");
+		skinningPaletteBuffer = std::make_shared<PaletteBuffer>(PaletteBufferType::ShaderStorage);
 	}
 	else
 	{
@@ -417,6 +419,7 @@ void DemoApplication::prepareAnimationDebugData()
 	GPUAnimationInfo.animationPosePalette.resize(restPose.getSize());
 	CPUAnimationInfo.animationPose = restPose;
 	CPUAnimationInfo.animationPosePalette.resize(restPose.getSize());
+	skinningPalette.resize(restPose.getSize());
 	
 	//CPUSkinnedMeshes[0].hasAnimation() = false;
 	//GPUSkinnedMeshes[0].hasAnimation() = false;
@@ -613,10 +616,17 @@ void DemoApplication::render()
 
 		Uniform<Vector3>::set(skinnedMeshShader->getUniform("lightDirection"), Vector3(1.0f, 1.0f, 1.0f));
 
-		Uniform<Matrix4>::set(skinnedMeshShader->getUniform("animationPose"), GPUAnimationInfo.animationPosePalette);
+		if (bPrecomputeSkin)
+		{
+			// One character, its palette starts at the first joint of the buffer
+			glUniform1ui(skinnedMeshShader->getUniform("paletteOffset"), 0);
+			glUniform1ui(skinnedMeshShader->getUniform("jointCount"), skinningPaletteBuffer->getNumJoints());
 
-		if (!bPrecomputeSkin)
+			skinningPaletteBuffer->bind(0);
+		}
+		else
 		{
+			Uniform<Matrix4>::set(skinnedMeshShader->getUniform("animationPose"), GPUAnimationInfo.animationPosePalette);
 			Uniform<Matrix4>::set(skinnedMeshShader->getUniform("inverseBindPose"), skeleton.getInverseBindPose());
 		}
 
@@ -633,6 +643,11 @@ void DemoApplication::render()
 
 		displayTexture->unbind(0);
 
+		if (bPrecomputeSkin)
+		{
+			skinningPaletteBuffer->unbind(0);
+		}
+
 		skinnedMeshShader->unbind();
 
 		restPoseDebugDraw->Draw(DebugDrawMode::Lines, Vector3(1.0f, 0.0f, 0.0f), mvp);
@@ -751,12 +766,10 @@ void DemoApplication::updateGPUSkin()
 void DemoApplication::updatePrecomputedGPUSkin()
 {
 	GPUAnimationInfo.animationPose.getMatrixPalette(GPUAnimationInfo.animationPosePalette);
-	std::vector<Matrix4> inverseBindPose = skeleton.getInverseBindPose();
 
-	for (int32_t i = 0; i < GPUAnimationInfo.animationPosePalette.size(); i++)
-	{
-		GPUAnimationInfo.animationPosePalette[i] = GPUAnimationInfo.animationPosePalette[i] * inverseBindPose[i];
-	}
+	// Multiplied by the inverse bind pose while packing, 48 bytes a joint go up
+	packPalette(GPUAnimationInfo.animationPosePalette.data(), skeleton.getAffineInverseBindPose().data(), static_cast<uint32_t>(skinningPalette.size()), skinningPalette.data());
+	skinningPaletteBuffer->set(skinningPalette);
 }
 
 void DemoApplication::updateImGui()
@@ -6,12 +6,14 @@
 
 #include "Math/Vector2.h"
 #include "Math/Vector3.h"
+#include "Math/Matrix3x4.h"
 
 #include "Renderer/Shader.h"
 #include "Renderer/Attribute.h"
 #include "Renderer/IndexBuffer.h"
 #include "Renderer/Texture.h"
 #include "Renderer/DebugDraw.h"
+#include "Renderer/PaletteBuffer.h"
 
 #include <Animation/SkeletalMesh.h>
 #include "Animation/AnimationPose.h"
@@ -84,6 +86,7 @@ protected:
 	std::shared_ptr<Shader> shader;
 	std::shared_ptr<Shader> meshShader;
 	std::shared_ptr<Shader> skinnedMeshShader;
+	std::shared_ptr<PaletteBuffer> skinningPaletteBuffer;
 	std::shared_ptr<Attribute<Vector3>> vertexPositions;
 	std::shared_ptr<Attribute<Vector3>> vertexNormals;
 	std::shared_ptr<Attribute<Vector2>> vertexTexCoords;
@@ -109,6 +112,7 @@ protected:
 	int32_t currentFrame = 0;
 	AnimationInstance GPUAnimationInfo;
 	AnimationInstance CPUAnimationInfo;
+	std::vector<Matrix3x4> skinningPalette;
 
 	// Our state
 	bool bShowDemoWindow = true;
@@ -129,6 +129,8 @@ namespace GLTFHelpers
 				keyframe.out[component] = bIsSamplerCubic ? values[baseIndex + offset++] : 0.0f;
 			}
 		}
+
+		result.updateHermiteSegments();
 	}
 
 	void meshFromAttribute(SkeletalMesh& outMesh, cgltf_attribute& attribute, cgltf_skin* skin, cgltf_node* nodes, uint32_t nodeCount)
@@ -8,4 +8,14 @@ namespace Math
 		Linear,
 		Cubic
 	};
+
+	// How linear rotation tracks blend two keys. Nlerp slows down in the middle of large
+	// gaps between keys, FastSlerp corrects t with a polynomial and stays within 8e-4
+	// radians of Slerp at about the cost of Nlerp. Slerp is exact and the slowest.
+	enum class QuaternionInterpolation
+	{
+		Nlerp,
+		FastSlerp,
+		Slerp
+	};
 }
\ No newline at end of file
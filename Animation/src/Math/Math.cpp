@@ -1,5 +1,7 @@
 #include "Math.h"
 
+#include <cstring>
+
 namespace Math
 {
 	bool FloatEqual(float a, float b)
@@ -11,4 +13,101 @@ namespace Math
 	{
 		return !FloatEqual(a, a);
 	}
+
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(float));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		uint32_t floatExponent = (bits >> 23) & 0xff;
+		uint32_t mantissa = bits & 0x7fffff;
+		int32_t exponent = static_cast<int32_t>(floatExponent) - 127 + 15;
+
+		// Infinity and NaN
+		if (floatExponent == 0xff)
+		{
+			return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+		}
+
+		// Too large, becomes infinity
+		if (exponent >= 31)
+		{
+			return static_cast<uint16_t>(sign | 0x7c00);
+		}
+
+		// Too small for a normal half, becomes subnormal or zero
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+			{
+				return static_cast<uint16_t>(sign);
+			}
+
+			mantissa |= 0x800000;
+
+			uint32_t shift = static_cast<uint32_t>(14 - exponent);
+			uint32_t half = mantissa >> shift;
+
+			if ((mantissa >> (shift - 1)) & 1)
+			{
+				half++;
+			}
+
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+
+		// A carry out of the mantissa correctly bumps the exponent
+		if (mantissa & 0x1000)
+		{
+			half++;
+		}
+
+		return static_cast<uint16_t>(half);
+	}
+
+	float HalfToFloat(uint16_t value)
+	{
+		uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+		int32_t exponent = (value >> 10) & 0x1f;
+		uint32_t mantissa = value & 0x3ff;
+		uint32_t bits = 0;
+
+		if (exponent == 0)
+		{
+			if (mantissa == 0)
+			{
+				bits = sign;
+			}
+			else
+			{
+				// Subnormal, normalize it
+				exponent = 1;
+
+				while ((mantissa & 0x400) == 0)
+				{
+					mantissa <<= 1;
+					exponent--;
+				}
+
+				mantissa &= 0x3ff;
+				bits = sign | (static_cast<uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+			}
+		}
+		else if (exponent == 31)
+		{
+			bits = sign | 0x7f800000 | (mantissa << 13);
+		}
+		else
+		{
+			bits = sign | (static_cast<uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+		}
+
+		float result = 0.0f;
+		std::memcpy(&result, &bits, sizeof(float));
+
+		return result;
+	}
 }
\ No newline at end of file
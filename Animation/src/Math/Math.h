@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 
 namespace Math
@@ -26,6 +27,10 @@ namespace Math
 	
 	bool FloatEqual(float a, float b);
 	bool FloatNotEqual(float a, float b);
+
+	// IEEE 754 half precision conversions, rounding to nearest
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
 	
 	inline float Sin(float angle) { return std::sinf(angle); }
 	inline float Cos(float angle) { return std::cosf(angle); }
@@ -0,0 +1,149 @@
+#include "Matrix3x4.h"
+#include "Math.h"
+#include "SIMD.h"
+
+namespace Math
+{
+	Matrix3x4 Matrix3x4::Identity = Matrix3x4();
+
+	Matrix3x4 operator+(const Matrix3x4& a, const Matrix3x4& b)
+	{
+		return Matrix3x4(a.m00 + b.m00, a.m01 + b.m01, a.m02 + b.m02, a.m03 + b.m03,
+						 a.m10 + b.m10, a.m11 + b.m11, a.m12 + b.m12, a.m13 + b.m13,
+						 a.m20 + b.m20, a.m21 + b.m21, a.m22 + b.m22, a.m23 + b.m23);
+	}
+
+	Matrix3x4 operator*(const Matrix3x4& matrix, float scalar)
+	{
+		return Matrix3x4(matrix.m00 * scalar, matrix.m01 * scalar, matrix.m02 * scalar, matrix.m03 * scalar,
+						 matrix.m10 * scalar, matrix.m11 * scalar, matrix.m12 * scalar, matrix.m13 * scalar,
+						 matrix.m20 * scalar, matrix.m21 * scalar, matrix.m22 * scalar, matrix.m23 * scalar);
+	}
+
+	Matrix3x4 operator*(const Matrix3x4& a, const Matrix3x4& b)
+	{
+		SIMD::Float4 b0 = SIMD::load(&b.elements[0]);
+		SIMD::Float4 b1 = SIMD::load(&b.elements[4]);
+		SIMD::Float4 b2 = SIMD::load(&b.elements[8]);
+
+		// The implicit last row of b is (0, 0, 0, 1), it only adds the translation of a
+		SIMD::Float4 b3 = SIMD::set(0.0f, 0.0f, 0.0f, 1.0f);
+
+		Matrix3x4 result;
+
+		for (int row = 0; row < 3; row++)
+		{
+			const float* left = &a.elements[row * 4];
+
+			SIMD::Float4 out = SIMD::mul(SIMD::splat(left[0]), b0);
+			out = SIMD::madd(SIMD::splat(left[1]), b1, out);
+			out = SIMD::madd(SIMD::splat(left[2]), b2, out);
+			out = SIMD::madd(SIMD::splat(left[3]), b3, out);
+
+			SIMD::store(&result.elements[row * 4], out);
+		}
+
+		return result;
+	}
+
+	Matrix4 multiplyAffine(const Matrix4& a, const Matrix3x4& b)
+	{
+		// Matrix4 is column major, every column of the result is a sum of the columns of a
+		SIMD::Float4 a0 = SIMD::load(&a.elements[0]);
+		SIMD::Float4 a1 = SIMD::load(&a.elements[4]);
+		SIMD::Float4 a2 = SIMD::load(&a.elements[8]);
+		SIMD::Float4 a3 = SIMD::load(&a.elements[12]);
+
+		Matrix4 result;
+
+		for (int column = 0; column < 3; column++)
+		{
+			SIMD::Float4 out = SIMD::mul(SIMD::splat(b.elements[column]), a0);
+			out = SIMD::madd(SIMD::splat(b.elements[4 + column]), a1, out);
+			out = SIMD::madd(SIMD::splat(b.elements[8 + column]), a2, out);
+
+			SIMD::store(&result.elements[column * 4], out);
+		}
+
+		SIMD::Float4 translation = SIMD::madd(SIMD::splat(b.m03), a0, a3);
+		translation = SIMD::madd(SIMD::splat(b.m13), a1, translation);
+		translation = SIMD::madd(SIMD::splat(b.m23), a2, translation);
+
+		SIMD::store(&result.elements[12], translation);
+
+		return result;
+	}
+
+	Vector3 transformVector(const Matrix3x4& matrix, const Vector3& vector)
+	{
+		return Vector3(matrix.m00 * vector.x + matrix.m01 * vector.y + matrix.m02 * vector.z,
+					   matrix.m10 * vector.x + matrix.m11 * vector.y + matrix.m12 * vector.z,
+					   matrix.m20 * vector.x + matrix.m21 * vector.y + matrix.m22 * vector.z);
+	}
+
+	Vector3 transformPoint(const Matrix3x4& matrix, const Vector3& point)
+	{
+		return Vector3(matrix.m00 * point.x + matrix.m01 * point.y + matrix.m02 * point.z + matrix.m03,
+					   matrix.m10 * point.x + matrix.m11 * point.y + matrix.m12 * point.z + matrix.m13,
+					   matrix.m20 * point.x + matrix.m21 * point.y + matrix.m22 * point.z + matrix.m23);
+	}
+
+	Matrix3x4 inverse(const Matrix3x4& matrix)
+	{
+		// Column i is the rotated axis scaled by s_i, so row i of the inverse is that column
+		// divided by s_i^2
+		Matrix3x4 result;
+
+		for (int column = 0; column < 3; column++)
+		{
+			float x = matrix.elements[0 * 4 + column];
+			float y = matrix.elements[1 * 4 + column];
+			float z = matrix.elements[2 * 4 + column];
+			float squaredScale = x * x + y * y + z * z;
+			float inverseSquaredScale = squaredScale > Epsilon * Epsilon ? 1.0f / squaredScale : 0.0f;
+
+			result.elements[column * 4 + 0] = x * inverseSquaredScale;
+			result.elements[column * 4 + 1] = y * inverseSquaredScale;
+			result.elements[column * 4 + 2] = z * inverseSquaredScale;
+		}
+
+		Vector3 translation = transformVector(result, Vector3(matrix.m03, matrix.m13, matrix.m23));
+
+		result.m03 = -translation.x;
+		result.m13 = -translation.y;
+		result.m23 = -translation.z;
+
+		return result;
+	}
+
+	Matrix3x4 toMatrix3x4(const Matrix4& matrix)
+	{
+		return Matrix3x4(matrix.m00, matrix.m01, matrix.m02, matrix.m03,
+						 matrix.m10, matrix.m11, matrix.m12, matrix.m13,
+						 matrix.m20, matrix.m21, matrix.m22, matrix.m23);
+	}
+
+	Matrix4 toMatrix4(const Matrix3x4& matrix)
+	{
+		return Matrix4(matrix.m00, matrix.m10, matrix.m20, 0.0f,
+					   matrix.m01, matrix.m11, matrix.m21, 0.0f,
+					   matrix.m02, matrix.m12, matrix.m22, 0.0f,
+					   matrix.m03, matrix.m13, matrix.m23, 1.0f);
+	}
+
+	void packPalette(const Matrix4* palette, uint32_t numJoints, Matrix3x4* out)
+	{
+		for (uint32_t i = 0; i < numJoints; i++)
+		{
+			out[i] = toMatrix3x4(palette[i]);
+		}
+	}
+
+	void packPalette(const Matrix4* pose, const Matrix3x4* inverseBindPose, uint32_t numJoints, Matrix3x4* out)
+	{
+		for (uint32_t i = 0; i < numJoints; i++)
+		{
+			out[i] = toMatrix3x4(pose[i]) * inverseBindPose[i];
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Matrix4.h"
+
+#include <cstdint>
+
+namespace Math
+{
+	// Affine matrix, the top three rows of a Matrix4 whose last row is (0, 0, 0, 1). Stored
+	// row major so a palette of them can go to the GPU as three vec4 per joint. Composing
+	// two of them takes 36 multiplies instead of 64.
+	struct Matrix3x4
+	{
+		union
+		{
+			float elements[12];
+
+			struct
+			{
+				float m00; float m01; float m02; float m03;
+				float m10; float m11; float m12; float m13;
+				float m20; float m21; float m22; float m23;
+			};
+		};
+
+		inline Matrix3x4() :
+			m00(1.0f), m01(0.0f), m02(0.0f), m03(0.0f),
+			m10(0.0f), m11(1.0f), m12(0.0f), m13(0.0f),
+			m20(0.0f), m21(0.0f), m22(1.0f), m23(0.0f) {}
+
+		inline Matrix3x4(float inM00, float inM01, float inM02, float inM03,
+						 float inM10, float inM11, float inM12, float inM13,
+						 float inM20, float inM21, float inM22, float inM23) :
+						 m00(inM00), m01(inM01), m02(inM02), m03(inM03),
+						 m10(inM10), m11(inM11), m12(inM12), m13(inM13),
+						 m20(inM20), m21(inM21), m22(inM22), m23(inM23) {}
+
+		static Matrix3x4 Identity;
+	};
+
+	Matrix3x4 operator+(const Matrix3x4& a, const Matrix3x4& b);
+	Matrix3x4 operator*(const Matrix3x4& matrix, float scalar);
+	Matrix3x4 operator*(const Matrix3x4& a, const Matrix3x4& b);
+
+	// a * b for an affine a, written straight into a Matrix4. Palettes kept as Matrix4
+	// compose with it without converting back and forth.
+	Matrix4 multiplyAffine(const Matrix4& a, const Matrix3x4& b);
+
+	Vector3 transformVector(const Matrix3x4& matrix, const Vector3& vector);
+	Vector3 transformPoint(const Matrix3x4& matrix, const Vector3& point);
+
+	// Inverse of rotation * scale + translation: the transposed rotation with the scale
+	// divided out, then the translation. Matrices with shear need inverse(Matrix4).
+	Matrix3x4 inverse(const Matrix3x4& matrix);
+
+	Matrix3x4 toMatrix3x4(const Matrix4& matrix);
+	Matrix4 toMatrix4(const Matrix3x4& matrix);
+
+	// Rows of a palette of affine Matrix4 for upload, 48 bytes a joint instead of 64. The
+	// second form multiplies a pose palette by the inverse bind pose on the way, the GPU
+	// then blends the skinning matrices without any matrix product.
+	void packPalette(const Matrix4* palette, uint32_t numJoints, Matrix3x4* out);
+	void packPalette(const Matrix4* pose, const Matrix3x4* inverseBindPose, uint32_t numJoints, Matrix3x4* out);
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Quaternion.h"
 #include "Math.h"
 
+#include <cmath>
+
 namespace Math
 {
 	Quaternion Quaternion::Identity = Quaternion();
@@ -204,7 +206,16 @@ namespace Math
 		}
 		
 		Quaternion delta = inverse(start) * end;
-		return normalized((delta ^ t) * start);
+		return normalized(start * (delta ^ t));
+	}
+
+	Quaternion fastSlerp(const Quaternion& start, const Quaternion& end, float t)
+	{
+		float cosine = dot(start, end);
+		float sign = std::copysign(1.0f, cosine);
+		float factor = fastSlerpFactor(FastAbs(cosine), t);
+
+		return normalized(start * (1.0f - factor) + end * (factor * sign));
 	}
 
 	Quaternion lookRotation(const Vector3& direction, const Vector3& up)
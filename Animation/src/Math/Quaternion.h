@@ -31,6 +31,19 @@ namespace Math
 		inline Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
 		inline Quaternion(float inX, float inY, float inZ, float inW) : x(inX), y(inY), z(inZ), w(inW) {}
 	};
+
+	// t for a normalized lerp between two quaternions whose dot product is cosine (positive),
+	// so the result moves at a nearly constant angular velocity like slerp. Inline, the
+	// batched version in SIMD.cpp evaluates it per element.
+	inline float fastSlerpFactor(float cosine, float t)
+	{
+		float a = 1.0904f + cosine * (-3.2452f + cosine * (3.55645f - cosine * 1.43519f));
+		float b = 0.848013f + cosine * (-1.06021f + cosine * 0.215638f);
+		float centered = t - 0.5f;
+		float k = a * centered * centered + b;
+
+		return t + t * centered * (t - 1.0f) * k;
+	}
 	
 	Quaternion angleAxis(float angle, const Vector3& axis);
 	Quaternion fromTo(const Vector3& from, const Vector3& to);
@@ -59,6 +72,9 @@ namespace Math
 	Quaternion nlerp(const Quaternion& from, const Quaternion& to, float t);
 	Quaternion operator^(const Quaternion& quaternion, float power);
 	Quaternion slerp(const Quaternion& start, const Quaternion& end, float t);
+
+	// nlerp with a corrected t, see fastSlerpFactor. Takes the shorter arc.
+	Quaternion fastSlerp(const Quaternion& start, const Quaternion& end, float t);
 	Quaternion lookRotation(const Vector3& direction, const Vector3& up);
 	Matrix4 quaternionToMatrix4(const Quaternion& quaternion);
 	Quaternion matrix4ToQuaternion(const Matrix4& matrix);
@@ -0,0 +1,105 @@
+#include "SIMD.h"
+
+#include <cmath>
+
+namespace Math
+{
+	void mul4x4xN(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			Matrix4A left = load(a[i]);
+
+			// Column j of the result is a times column j of b. All of b is loaded before
+			// storing, out may be b.
+			SIMD::Float4 b0 = SIMD::load(b[i].elements + 0);
+			SIMD::Float4 b1 = SIMD::load(b[i].elements + 4);
+			SIMD::Float4 b2 = SIMD::load(b[i].elements + 8);
+			SIMD::Float4 b3 = SIMD::load(b[i].elements + 12);
+
+			SIMD::store(out[i].elements + 0, transform(left, b0));
+			SIMD::store(out[i].elements + 4, transform(left, b1));
+			SIMD::store(out[i].elements + 8, transform(left, b2));
+			SIMD::store(out[i].elements + 12, transform(left, b3));
+		}
+	}
+
+	void quatMulN(const Quaternion* a, const Quaternion* b, Quaternion* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			QuaternionA result = QuaternionA(SIMD::load(a[i].elements)) * QuaternionA(SIMD::load(b[i].elements));
+			SIMD::store(out[i].elements, result.value);
+		}
+	}
+
+	void nlerpN(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, size_t count)
+	{
+		SIMD::Float4 factor = SIMD::splat(t);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			SIMD::Float4 source = SIMD::load(from[i].elements);
+			SIMD::Float4 mixed = SIMD::madd(SIMD::sub(SIMD::load(to[i].elements), source), factor, source);
+
+			SIMD::store(out[i].elements, SIMD::div(mixed, SIMD::sqrt(SIMD::dot4(mixed, mixed))));
+		}
+	}
+
+	void nlerpN(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			SIMD::Float4 source = SIMD::load(from[i].elements);
+			SIMD::Float4 mixed = SIMD::madd(SIMD::sub(SIMD::load(to[i].elements), source), SIMD::splat(t[i]), source);
+
+			SIMD::store(out[i].elements, SIMD::div(mixed, SIMD::sqrt(SIMD::dot4(mixed, mixed))));
+		}
+	}
+
+	void fastSlerpN(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			SIMD::Float4 source = SIMD::load(from[i].elements);
+			SIMD::Float4 target = SIMD::load(to[i].elements);
+			float cosine = SIMD::getX(SIMD::dot4(source, target));
+
+			// Branchless, the hemisphere of random data is unpredictable
+			float sign = std::copysign(1.0f, cosine);
+			float factor = fastSlerpFactor(std::fabs(cosine), t);
+
+			SIMD::Float4 mixed = SIMD::madd(target, SIMD::splat(factor * sign), SIMD::mul(source, SIMD::splat(1.0f - factor)));
+
+			SIMD::store(out[i].elements, SIMD::div(mixed, SIMD::sqrt(SIMD::dot4(mixed, mixed))));
+		}
+	}
+
+	void fastSlerpN(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			SIMD::Float4 source = SIMD::load(from[i].elements);
+			SIMD::Float4 target = SIMD::load(to[i].elements);
+			float cosine = SIMD::getX(SIMD::dot4(source, target));
+
+			// Branchless, the hemisphere of random data is unpredictable
+			float sign = std::copysign(1.0f, cosine);
+			float factor = fastSlerpFactor(std::fabs(cosine), t[i]);
+
+			SIMD::Float4 mixed = SIMD::madd(target, SIMD::splat(factor * sign), SIMD::mul(source, SIMD::splat(1.0f - factor)));
+
+			SIMD::store(out[i].elements, SIMD::div(mixed, SIMD::sqrt(SIMD::dot4(mixed, mixed))));
+		}
+	}
+
+	void transformPointsN(const Matrix4& matrix, const Vector3* points, Vector3* out, size_t count)
+	{
+		Matrix4A m = load(matrix);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			out[i] = store(transformPoint(m, load(points[i])));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,369 @@
+#pragma once
+
+#include "Math.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Quaternion.h"
+#include "Matrix4.h"
+#include "Transform.h"
+
+#include <cmath>
+#include <cstddef>
+
+// SSE2 on x86/x64, NEON on 64 bit ARM, plain floats everywhere else
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MATH_SIMD_SSE 1
+	#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+	#define MATH_SIMD_NEON 1
+	#include <arm_neon.h>
+#else
+	#define MATH_SIMD_SCALAR 1
+#endif
+
+namespace Math
+{
+	// Lane-wise operations on four floats. Everything is inline so it can vanish into the
+	// calling loop.
+	namespace SIMD
+	{
+#if defined(MATH_SIMD_SSE)
+		typedef __m128 Float4;
+
+		inline Float4 load(const float* data) { return _mm_loadu_ps(data); }
+		inline void store(float* data, Float4 value) { _mm_storeu_ps(data, value); }
+		inline Float4 set(float x, float y, float z, float w) { return _mm_set_ps(w, z, y, x); }
+		inline Float4 splat(float value) { return _mm_set1_ps(value); }
+		inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+		inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+		inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+		inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+		inline Float4 sqrt(Float4 value) { return _mm_sqrt_ps(value); }
+		inline float getX(Float4 value) { return _mm_cvtss_f32(value); }
+
+		template <int X, int Y, int Z, int W>
+		inline Float4 swizzle(Float4 value) { return _mm_shuffle_ps(value, value, _MM_SHUFFLE(W, Z, Y, X)); }
+#elif defined(MATH_SIMD_NEON)
+		typedef float32x4_t Float4;
+
+		inline Float4 load(const float* data) { return vld1q_f32(data); }
+		inline void store(float* data, Float4 value) { vst1q_f32(data, value); }
+		inline Float4 set(float x, float y, float z, float w) { const float values[4] = { x, y, z, w }; return vld1q_f32(values); }
+		inline Float4 splat(float value) { return vdupq_n_f32(value); }
+		inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+		inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+		inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+		inline Float4 div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+		inline Float4 sqrt(Float4 value) { return vsqrtq_f32(value); }
+		inline float getX(Float4 value) { return vgetq_lane_f32(value, 0); }
+
+		template <int X, int Y, int Z, int W>
+		inline Float4 swizzle(Float4 value)
+		{
+	#if defined(__clang__) || defined(__GNUC__)
+			return __builtin_shufflevector(value, value, X, Y, Z, W);
+	#else
+			float values[4];
+			vst1q_f32(values, value);
+			return set(values[X], values[Y], values[Z], values[W]);
+	#endif
+		}
+#else
+		struct Float4
+		{
+			float elements[4];
+		};
+
+		inline Float4 set(float x, float y, float z, float w) { Float4 result = { { x, y, z, w } }; return result; }
+		inline Float4 load(const float* data) { return set(data[0], data[1], data[2], data[3]); }
+		inline void store(float* data, Float4 value) { for (int i = 0; i < 4; i++) { data[i] = value.elements[i]; } }
+		inline Float4 splat(float value) { return set(value, value, value, value); }
+		inline Float4 add(Float4 a, Float4 b) { return set(a.elements[0] + b.elements[0], a.elements[1] + b.elements[1], a.elements[2] + b.elements[2], a.elements[3] + b.elements[3]); }
+		inline Float4 sub(Float4 a, Float4 b) { return set(a.elements[0] - b.elements[0], a.elements[1] - b.elements[1], a.elements[2] - b.elements[2], a.elements[3] - b.elements[3]); }
+		inline Float4 mul(Float4 a, Float4 b) { return set(a.elements[0] * b.elements[0], a.elements[1] * b.elements[1], a.elements[2] * b.elements[2], a.elements[3] * b.elements[3]); }
+		inline Float4 div(Float4 a, Float4 b) { return set(a.elements[0] / b.elements[0], a.elements[1] / b.elements[1], a.elements[2] / b.elements[2], a.elements[3] / b.elements[3]); }
+		inline Float4 sqrt(Float4 value) { return set(std::sqrt(value.elements[0]), std::sqrt(value.elements[1]), std::sqrt(value.elements[2]), std::sqrt(value.elements[3])); }
+		inline float getX(Float4 value) { return value.elements[0]; }
+
+		template <int X, int Y, int Z, int W>
+		inline Float4 swizzle(Float4 value) { return set(value.elements[X], value.elements[Y], value.elements[Z], value.elements[W]); }
+#endif
+
+		// a * b + c
+		inline Float4 madd(Float4 a, Float4 b, Float4 c) { return add(mul(a, b), c); }
+
+		template <int Lane>
+		inline Float4 splatLane(Float4 value) { return swizzle<Lane, Lane, Lane, Lane>(value); }
+
+		// Dot product of all four lanes, in every lane
+		inline Float4 dot4(Float4 a, Float4 b)
+		{
+			Float4 product = mul(a, b);
+			Float4 sum = add(product, swizzle<1, 0, 3, 2>(product));
+
+			return add(sum, swizzle<2, 3, 0, 1>(sum));
+		}
+
+		// Cross product of xyz, w becomes 0 if both w are 0
+		inline Float4 cross3(Float4 a, Float4 b)
+		{
+			Float4 a1 = swizzle<1, 2, 0, 3>(a);
+			Float4 b1 = swizzle<1, 2, 0, 3>(b);
+			Float4 result = sub(mul(a, b1), mul(a1, b));
+
+			return swizzle<1, 2, 0, 3>(result);
+		}
+	}
+
+	// 16 byte aligned counterparts of Vector3, Quaternion, Matrix4 and Transform for hot
+	// loops. They live alongside the regular types, convert with the load and store
+	// functions below and keep the conventions of the regular types: quaternion a * b
+	// applies a first and then b (the Hamilton product b * a), matrices are column major.
+	struct alignas(16) Vector3A
+	{
+		inline Vector3A() : value(SIMD::splat(0.0f)) {}
+		inline explicit Vector3A(SIMD::Float4 inValue) : value(inValue) {}
+		inline Vector3A(float x, float y, float z) : value(SIMD::set(x, y, z, 0.0f)) {}
+
+		SIMD::Float4 value;
+	};
+
+	struct alignas(16) QuaternionA
+	{
+		inline QuaternionA() : value(SIMD::set(0.0f, 0.0f, 0.0f, 1.0f)) {}
+		inline explicit QuaternionA(SIMD::Float4 inValue) : value(inValue) {}
+		inline QuaternionA(float x, float y, float z, float w) : value(SIMD::set(x, y, z, w)) {}
+
+		SIMD::Float4 value;
+	};
+
+	struct alignas(16) Matrix4A
+	{
+		inline Matrix4A()
+		{
+			columns[0] = SIMD::set(1.0f, 0.0f, 0.0f, 0.0f);
+			columns[1] = SIMD::set(0.0f, 1.0f, 0.0f, 0.0f);
+			columns[2] = SIMD::set(0.0f, 0.0f, 1.0f, 0.0f);
+			columns[3] = SIMD::set(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+
+		SIMD::Float4 columns[4];
+	};
+
+	struct alignas(16) TransformA
+	{
+		Vector3A position;
+		QuaternionA rotation;
+		Vector3A scale;
+
+		inline TransformA() : scale(1.0f, 1.0f, 1.0f) {}
+	};
+
+	// Conversions
+	inline Vector3A load(const Vector3& v) { return Vector3A(v.x, v.y, v.z); }
+	inline QuaternionA load(const Quaternion& q) { return QuaternionA(SIMD::load(q.elements)); }
+
+	inline Matrix4A load(const Matrix4& m)
+	{
+		Matrix4A result;
+
+		for (int i = 0; i < 4; i++)
+		{
+			result.columns[i] = SIMD::load(m.elements + i * 4);
+		}
+
+		return result;
+	}
+
+	inline TransformA load(const Transform& t)
+	{
+		TransformA result;
+		result.position = load(t.position);
+		result.rotation = load(t.rotation);
+		result.scale = load(t.scale);
+
+		return result;
+	}
+
+	inline Vector3 store(const Vector3A& v)
+	{
+		alignas(16) float values[4];
+		SIMD::store(values, v.value);
+
+		return Vector3(values[0], values[1], values[2]);
+	}
+
+	inline Quaternion store(const QuaternionA& q)
+	{
+		Quaternion result;
+		SIMD::store(result.elements, q.value);
+
+		return result;
+	}
+
+	inline Matrix4 store(const Matrix4A& m)
+	{
+		Matrix4 result;
+
+		for (int i = 0; i < 4; i++)
+		{
+			SIMD::store(result.elements + i * 4, m.columns[i]);
+		}
+
+		return result;
+	}
+
+	inline Transform store(const TransformA& t)
+	{
+		Transform result;
+		result.position = store(t.position);
+		result.rotation = store(t.rotation);
+		result.scale = store(t.scale);
+
+		return result;
+	}
+
+	// Vector3A
+	inline Vector3A operator+(const Vector3A& a, const Vector3A& b) { return Vector3A(SIMD::add(a.value, b.value)); }
+	inline Vector3A operator-(const Vector3A& a, const Vector3A& b) { return Vector3A(SIMD::sub(a.value, b.value)); }
+	inline Vector3A operator*(const Vector3A& a, const Vector3A& b) { return Vector3A(SIMD::mul(a.value, b.value)); }
+	inline Vector3A operator*(const Vector3A& v, float scalar) { return Vector3A(SIMD::mul(v.value, SIMD::splat(scalar))); }
+	inline Vector3A operator*(float scalar, const Vector3A& v) { return v * scalar; }
+
+	inline float dot(const Vector3A& a, const Vector3A& b) { return SIMD::getX(SIMD::dot4(a.value, b.value)); }
+	inline Vector3A cross(const Vector3A& a, const Vector3A& b) { return Vector3A(SIMD::cross3(a.value, b.value)); }
+	inline float length(const Vector3A& v) { return std::sqrt(dot(v, v)); }
+
+	inline Vector3A lerp(const Vector3A& source, const Vector3A& target, float t)
+	{
+		return Vector3A(SIMD::madd(SIMD::sub(target.value, source.value), SIMD::splat(t), source.value));
+	}
+
+	inline Vector3A normalized(const Vector3A& v)
+	{
+		SIMD::Float4 squaredLength = SIMD::dot4(v.value, v.value);
+
+		if (SIMD::getX(squaredLength) < Epsilon)
+		{
+			return v;
+		}
+
+		return Vector3A(SIMD::div(v.value, SIMD::sqrt(squaredLength)));
+	}
+
+	// QuaternionA
+	inline QuaternionA operator+(const QuaternionA& a, const QuaternionA& b) { return QuaternionA(SIMD::add(a.value, b.value)); }
+	inline QuaternionA operator*(const QuaternionA& q, float scalar) { return QuaternionA(SIMD::mul(q.value, SIMD::splat(scalar))); }
+
+	inline QuaternionA operator*(const QuaternionA& a, const QuaternionA& b)
+	{
+		// Hamilton product b * a, the order Quaternion uses
+		const SIMD::Float4 p = b.value;
+		const SIMD::Float4 q = a.value;
+
+		SIMD::Float4 result = SIMD::mul(SIMD::splatLane<3>(p), q);
+		result = SIMD::madd(SIMD::mul(SIMD::splatLane<0>(p), SIMD::swizzle<3, 2, 1, 0>(q)), SIMD::set(1.0f, -1.0f, 1.0f, -1.0f), result);
+		result = SIMD::madd(SIMD::mul(SIMD::splatLane<1>(p), SIMD::swizzle<2, 3, 0, 1>(q)), SIMD::set(1.0f, 1.0f, -1.0f, -1.0f), result);
+		result = SIMD::madd(SIMD::mul(SIMD::splatLane<2>(p), SIMD::swizzle<1, 0, 3, 2>(q)), SIMD::set(-1.0f, 1.0f, 1.0f, -1.0f), result);
+
+		return QuaternionA(result);
+	}
+
+	inline Vector3A operator*(const QuaternionA& q, const Vector3A& v)
+	{
+		// 2 * dot(u, v) * u + (s * s - dot(u, u)) * v + 2 * s * cross(u, v)
+		SIMD::Float4 u = SIMD::mul(q.value, SIMD::set(1.0f, 1.0f, 1.0f, 0.0f));
+		SIMD::Float4 s = SIMD::splatLane<3>(q.value);
+		SIMD::Float4 two = SIMD::splat(2.0f);
+
+		SIMD::Float4 result = SIMD::mul(SIMD::mul(two, SIMD::dot4(u, v.value)), u);
+		result = SIMD::madd(SIMD::sub(SIMD::mul(s, s), SIMD::dot4(u, u)), v.value, result);
+		result = SIMD::madd(SIMD::mul(two, s), SIMD::cross3(u, v.value), result);
+
+		return Vector3A(result);
+	}
+
+	inline float dot(const QuaternionA& a, const QuaternionA& b) { return SIMD::getX(SIMD::dot4(a.value, b.value)); }
+
+	inline QuaternionA normalized(const QuaternionA& q)
+	{
+		return QuaternionA(SIMD::div(q.value, SIMD::sqrt(SIMD::dot4(q.value, q.value))));
+	}
+
+	inline QuaternionA nlerp(const QuaternionA& from, const QuaternionA& to, float t)
+	{
+		return normalized(QuaternionA(SIMD::madd(SIMD::sub(to.value, from.value), SIMD::splat(t), from.value)));
+	}
+
+	// Matrix4A
+	inline SIMD::Float4 transform(const Matrix4A& m, SIMD::Float4 v)
+	{
+		SIMD::Float4 result = SIMD::mul(m.columns[0], SIMD::splatLane<0>(v));
+		result = SIMD::madd(m.columns[1], SIMD::splatLane<1>(v), result);
+		result = SIMD::madd(m.columns[2], SIMD::splatLane<2>(v), result);
+
+		return SIMD::madd(m.columns[3], SIMD::splatLane<3>(v), result);
+	}
+
+	inline Matrix4A operator*(const Matrix4A& a, const Matrix4A& b)
+	{
+		Matrix4A result;
+
+		for (int i = 0; i < 4; i++)
+		{
+			result.columns[i] = transform(a, b.columns[i]);
+		}
+
+		return result;
+	}
+
+	inline Vector3A transformPoint(const Matrix4A& m, const Vector3A& point)
+	{
+		SIMD::Float4 result = SIMD::mul(m.columns[0], SIMD::splatLane<0>(point.value));
+		result = SIMD::madd(m.columns[1], SIMD::splatLane<1>(point.value), result);
+		result = SIMD::madd(m.columns[2], SIMD::splatLane<2>(point.value), result);
+
+		return Vector3A(SIMD::add(result, m.columns[3]));
+	}
+
+	inline Vector3A transformVector(const Matrix4A& m, const Vector3A& vector)
+	{
+		SIMD::Float4 result = SIMD::mul(m.columns[0], SIMD::splatLane<0>(vector.value));
+		result = SIMD::madd(m.columns[1], SIMD::splatLane<1>(vector.value), result);
+
+		return Vector3A(SIMD::madd(m.columns[2], SIMD::splatLane<2>(vector.value), result));
+	}
+
+	// TransformA
+	inline TransformA combine(const TransformA& a, const TransformA& b)
+	{
+		TransformA result;
+		result.scale = a.scale * b.scale;
+		result.rotation = b.rotation * a.rotation;
+		result.position = a.position + a.rotation * (a.scale * b.position);
+
+		return result;
+	}
+
+	inline Vector3A transformPoint(const TransformA& t, const Vector3A& point)
+	{
+		return t.rotation * (t.scale * point) + t.position;
+	}
+
+	inline Vector3A transformVector(const TransformA& t, const Vector3A& vector)
+	{
+		return t.rotation * (t.scale * vector);
+	}
+
+	// Batched versions of the operations above on arrays of the regular types, so callers
+	// don't have to convert. The arrays may be unaligned, out may alias an input.
+	void mul4x4xN(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t count);
+	void quatMulN(const Quaternion* a, const Quaternion* b, Quaternion* out, size_t count);
+	void nlerpN(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, size_t count);
+	void nlerpN(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count);
+
+	// fastSlerp of every pair, the shorter arc
+	void fastSlerpN(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, size_t count);
+	void fastSlerpN(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count);
+	void transformPointsN(const Matrix4& matrix, const Vector3* points, Vector3* out, size_t count);
+}
\ No newline at end of file
@@ -69,6 +69,21 @@ namespace Math
 					   position.x, position.y, position.z, 1.0f); // Position
 	}
 
+	Matrix3x4 transformToMatrix3x4(const Transform& transform)
+	{
+		// Rotation matrix of the unit quaternion, the columns scaled
+		const Quaternion& q = transform.rotation;
+		const Vector3& scale = transform.scale;
+
+		float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		return Matrix3x4((1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy - wz) * scale.y, 2.0f * (xz + wy) * scale.z, transform.position.x,
+						 2.0f * (xy + wz) * scale.x, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz - wx) * scale.z, transform.position.y,
+						 2.0f * (xz - wy) * scale.x, 2.0f * (yz + wx) * scale.y, (1.0f - 2.0f * (xx + yy)) * scale.z, transform.position.z);
+	}
+
 	Transform matrix4ToTransform(const Matrix4& matrtix)
 	{
 		Transform result;
@@ -2,6 +2,7 @@
 
 #include "Vector3.h"
 #include "Quaternion.h"
+#include "Matrix3x4.h"
 
 namespace Math
 {
@@ -20,6 +21,7 @@ namespace Math
 	Transform inverse(const Transform& transform);
 	Transform lerp(const Transform& source, const Transform& target, float t);
 	Matrix4 transformToMatrix4(const Transform& transform);
+	Matrix3x4 transformToMatrix3x4(const Transform& transform);
 	Transform matrix4ToTransform(const Matrix4& matrtix);
 	Vector3 transformPoint(const Transform& transform, const Vector3& point);
 	Vector3 transformVector(const Transform& transform, const Vector3& vector);
@@ -193,4 +193,41 @@ namespace Math
 
 		return normalized(linear);
 	}
-}
+
+	Vector2 octahedralEncode(const Vector3& v)
+	{
+		float sum = FastAbs(v.x) + FastAbs(v.y) + FastAbs(v.z);
+
+		if (sum < Epsilon)
+		{
+			return Vector2(0.0f, 0.0f);
+		}
+
+		float x = v.x / sum;
+		float y = v.y / sum;
+
+		// Fold the lower hemisphere over the diagonals
+		if (v.z < 0.0f)
+		{
+			float foldedX = (1.0f - FastAbs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float foldedY = (1.0f - FastAbs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		return Vector2(x, y);
+	}
+
+	Vector3 octahedralDecode(const Vector2& v)
+	{
+		Vector3 result(v.x, v.y, 1.0f - FastAbs(v.x) - FastAbs(v.y));
+
+		if (result.z < 0.0f)
+		{
+			result.x = (1.0f - FastAbs(v.y)) * (v.x >= 0.0f ? 1.0f : -1.0f);
+			result.y = (1.0f - FastAbs(v.x)) * (v.y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		return normalized(result);
+	}
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Vector2.h"
+
 #include <iostream>
 #include <sstream>
 
@@ -61,4 +63,8 @@ namespace Math
 	Vector3 lerp(const Vector3& source, const Vector3& target, float t);
 	Vector3 slerp(const Vector3& source, const Vector3& target, float t);
 	Vector3 nlerp(const Vector3& source, const Vector3& target, float t);
+
+	// Octahedral mapping of a unit vector onto [-1, 1]^2 and back, a compact way to store normals
+	Vector2 octahedralEncode(const Vector3& v);
+	Vector3 octahedralDecode(const Vector2& v);
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "PaletteBuffer.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <spdlog/spdlog.h>
+
+namespace Renderer
+{
+	namespace PaletteBufferHelpers
+	{
+		inline GLenum getTarget(PaletteBufferType type)
+		{
+			return type == PaletteBufferType::Uniform ? GL_UNIFORM_BUFFER : GL_SHADER_STORAGE_BUFFER;
+		}
+	}
+
+	constexpr uint32_t PaletteBuffer::MaxUniformJoints;
+
+	PaletteBuffer::PaletteBuffer(PaletteBufferType inType)
+	{
+		glGenBuffers(1, &handle);
+		type = inType;
+		numJoints = 0;
+		capacity = 0;
+	}
+
+	PaletteBuffer::~PaletteBuffer()
+	{
+		glDeleteBuffers(1, &handle);
+	}
+
+	void PaletteBuffer::set(const Matrix3x4* palette, uint32_t inNumJoints)
+	{
+		if (type == PaletteBufferType::Uniform && inNumJoints > MaxUniformJoints)
+		{
+			spdlog::error("Palette of {} joints exceeds the {} joints of a uniform buffer", inNumJoints, MaxUniformJoints);
+			inNumJoints = MaxUniformJoints;
+		}
+
+		numJoints = inNumJoints;
+
+		GLenum target = PaletteBufferHelpers::getTarget(type);
+		uint32_t size = sizeof(Matrix3x4);
+
+		glBindBuffer(target, handle);
+
+		if (numJoints > capacity)
+		{
+			// A uniform block is declared with its full size, the buffer has to cover it
+			capacity = type == PaletteBufferType::Uniform ? MaxUniformJoints : numJoints;
+			glBufferData(target, size * capacity, nullptr, GL_DYNAMIC_DRAW);
+		}
+
+		if (numJoints > 0)
+		{
+			glBufferSubData(target, 0, size * numJoints, palette);
+		}
+
+		glBindBuffer(target, 0);
+	}
+
+	void PaletteBuffer::set(const std::vector<Matrix3x4>& palette)
+	{
+		set(palette.data(), (uint32_t)palette.size());
+	}
+
+	void PaletteBuffer::bind(uint32_t bindingIndex)
+	{
+		glBindBufferBase(PaletteBufferHelpers::getTarget(type), bindingIndex, handle);
+	}
+
+	void PaletteBuffer::unbind(uint32_t bindingIndex)
+	{
+		glBindBufferBase(PaletteBufferHelpers::getTarget(type), bindingIndex, 0);
+	}
+}
\ No newline at end of file
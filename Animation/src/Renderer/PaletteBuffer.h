@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Math/Matrix3x4.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace Math;
+
+namespace Renderer
+{
+	enum class PaletteBufferType
+	{
+		Uniform,
+		ShaderStorage
+	};
+
+	// Skinning palette on the GPU, three vec4 rows per joint as AffineSkinning.vert reads it.
+	// A uniform buffer holds at most MaxUniformJoints joints, a shader storage buffer has no
+	// limit and can hold the palettes of many instances one after the other.
+	class PaletteBuffer
+	{
+	public:
+		// Must match MAX_JOINTS of AffineSkinningUBO.vert, the most that fit 16 KB
+		static constexpr uint32_t MaxUniformJoints = 341;
+
+		PaletteBuffer(PaletteBufferType inType = PaletteBufferType::ShaderStorage);
+		~PaletteBuffer();
+
+		PaletteBuffer(const PaletteBuffer& paletteBuffer) = delete;
+		PaletteBuffer& operator=(const PaletteBuffer& paletteBuffer) = delete;
+
+		// The storage only grows, smaller palettes update it in place
+		void set(const Matrix3x4* palette, uint32_t inNumJoints);
+		void set(const std::vector<Matrix3x4>& palette);
+
+		void bind(uint32_t bindingIndex);
+		void unbind(uint32_t bindingIndex);
+
+		PaletteBufferType getType() const { return type; }
+		uint32_t getNumJoints() const { return numJoints; }
+		uint32_t getCapacity() const { return capacity; }
+		uint32_t getHandle() const { return handle; }
+
+		// Bytes of the last upload
+		uint32_t getUploadSize() const { return numJoints * sizeof(Matrix3x4); }
+	private:
+		PaletteBufferType type;
+		uint32_t handle;
+		uint32_t numJoints;
+		uint32_t capacity;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "Compression.h"
+
+#include <cstring>
+
+namespace Util
+{
+	namespace
+	{
+		constexpr uint32_t MinMatch = 4;
+		constexpr uint32_t HashBits = 16;
+		constexpr size_t MaxOffset = 65535;
+
+		// The format requires the last literals to be at least this long
+		constexpr size_t LastLiterals = 5;
+		constexpr size_t MatchSafeDistance = 12;
+
+		inline uint32_t read32(const uint8_t* source)
+		{
+			uint32_t value = 0;
+			std::memcpy(&value, source, sizeof(uint32_t));
+			return value;
+		}
+
+		inline uint32_t hash(uint32_t value)
+		{
+			return (value * 2654435761u) >> (32 - HashBits);
+		}
+
+		inline void writeLength(size_t length, std::vector<uint8_t>& out)
+		{
+			while (length >= 255)
+			{
+				out.push_back(255);
+				length -= 255;
+			}
+
+			out.push_back(static_cast<uint8_t>(length));
+		}
+
+		inline void writeSequence(const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength, std::vector<uint8_t>& out)
+		{
+			size_t tokenIndex = out.size();
+			uint8_t literalNibble = static_cast<uint8_t>(numLiterals < 15 ? numLiterals : 15);
+			out.push_back(static_cast<uint8_t>(literalNibble << 4));
+
+			if (numLiterals >= 15)
+			{
+				writeLength(numLiterals - 15, out);
+			}
+
+			out.insert(out.end(), literals, literals + numLiterals);
+
+			// The last sequence has no match
+			if (matchLength == 0)
+			{
+				return;
+			}
+
+			out.push_back(static_cast<uint8_t>(offset & 0xff));
+			out.push_back(static_cast<uint8_t>(offset >> 8));
+
+			size_t length = matchLength - MinMatch;
+			out[tokenIndex] |= static_cast<uint8_t>(length < 15 ? length : 15);
+
+			if (length >= 15)
+			{
+				writeLength(length - 15, out);
+			}
+		}
+
+		inline bool readLength(const uint8_t*& source, const uint8_t* sourceEnd, size_t& length)
+		{
+			uint8_t value = 255;
+
+			while (value == 255)
+			{
+				if (source >= sourceEnd)
+				{
+					return false;
+				}
+
+				value = *source++;
+				length += value;
+			}
+
+			return true;
+		}
+	}
+
+	size_t compressLZ(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& out)
+	{
+		size_t start = out.size();
+
+		if (sourceSize < MatchSafeDistance + 1)
+		{
+			writeSequence(source, sourceSize, 0, 0, out);
+			return out.size() - start;
+		}
+
+		std::vector<uint32_t> table(static_cast<size_t>(1) << HashBits, 0);
+
+		size_t anchor = 0;
+		size_t position = 1;
+		size_t matchLimit = sourceSize - LastLiterals;
+		size_t searchLimit = sourceSize - MatchSafeDistance;
+
+		table[hash(read32(source))] = 0;
+
+		while (position < searchLimit)
+		{
+			uint32_t value = read32(source + position);
+			uint32_t& entry = table[hash(value)];
+			size_t candidate = entry;
+			entry = static_cast<uint32_t>(position);
+
+			if (position - candidate > MaxOffset || read32(source + candidate) != value)
+			{
+				position++;
+				continue;
+			}
+
+			// Extend the match backwards over pending literals, then forwards
+			while (position > anchor && candidate > 0 && source[position - 1] == source[candidate - 1])
+			{
+				position--;
+				candidate--;
+			}
+
+			size_t length = MinMatch;
+
+			while (position + length < matchLimit && source[candidate + length] == source[position + length])
+			{
+				length++;
+			}
+
+			writeSequence(source + anchor, position - anchor, position - candidate, length, out);
+
+			position += length;
+			anchor = position;
+
+			if (position - 2 < searchLimit)
+			{
+				table[hash(read32(source + position - 2))] = static_cast<uint32_t>(position - 2);
+			}
+		}
+
+		writeSequence(source + anchor, sourceSize - anchor, 0, 0, out);
+
+		return out.size() - start;
+	}
+
+	bool decompressLZ(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+	{
+		const uint8_t* sourceEnd = source + sourceSize;
+		size_t written = 0;
+
+		while (source < sourceEnd)
+		{
+			uint8_t token = *source++;
+			size_t numLiterals = token >> 4;
+
+			if (numLiterals == 15 && !readLength(source, sourceEnd, numLiterals))
+			{
+				return false;
+			}
+
+			if (numLiterals > static_cast<size_t>(sourceEnd - source) || numLiterals > destinationSize - written)
+			{
+				return false;
+			}
+
+			std::memcpy(destination + written, source, numLiterals);
+			source += numLiterals;
+			written += numLiterals;
+
+			// The last sequence ends after its literals
+			if (source == sourceEnd)
+			{
+				break;
+			}
+
+			if (sourceEnd - source < 2)
+			{
+				return false;
+			}
+
+			size_t offset = source[0] | (static_cast<size_t>(source[1]) << 8);
+			source += 2;
+
+			size_t matchLength = token & 0x0f;
+
+			if (matchLength == 15 && !readLength(source, sourceEnd, matchLength))
+			{
+				return false;
+			}
+
+			matchLength += MinMatch;
+
+			if (offset == 0 || offset > written || matchLength > destinationSize - written)
+			{
+				return false;
+			}
+
+			// Byte by byte, matches may overlap the bytes they produce
+			const uint8_t* match = destination + written - offset;
+
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				destination[written + i] = match[i];
+			}
+
+			written += matchLength;
+		}
+
+		return written == destinationSize;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Util
+{
+	// Byte oriented LZ77 compression using the LZ4 block layout: every sequence is a token
+	// (literal and match length nibbles), the literals, a 16 bit offset and extra length
+	// bytes. Fast to decode, good enough for data with repeated runs like constant tracks.
+
+	// Appends the compressed data to out and returns its size
+	size_t compressLZ(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& out);
+
+	// Returns false if the data is corrupt or doesn't decompress to exactly destinationSize bytes
+	bool decompressLZ(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+}
\ No newline at end of file
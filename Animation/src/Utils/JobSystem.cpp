@@ -0,0 +1,321 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Util
+{
+	namespace
+	{
+		// Job system and worker index of a worker thread. The thread that creates a system
+		// is its worker 0 without being recorded here, it may own several systems.
+		thread_local const JobSystem* currentJobSystem = nullptr;
+		thread_local uint32_t currentWorkerIndex = 0;
+	}
+
+	JobQueue::JobQueue()
+	{
+		front = 0;
+		back = 0;
+	}
+
+	bool JobQueue::push(Job* job)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (back - front >= Capacity)
+		{
+			return false;
+		}
+
+		jobs[back % Capacity] = job;
+		back++;
+
+		return true;
+	}
+
+	Job* JobQueue::pop()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (back == front)
+		{
+			return nullptr;
+		}
+
+		back--;
+
+		return jobs[back % Capacity];
+	}
+
+	Job* JobQueue::steal()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (back == front)
+		{
+			return nullptr;
+		}
+
+		Job* job = jobs[front % Capacity];
+		front++;
+
+		return job;
+	}
+
+	JobSystem::JobSystem(uint32_t inNumWorkers)
+	{
+		numWorkers = inNumWorkers;
+
+		if (numWorkers == 0)
+		{
+			numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		workers.reset(new Worker[numWorkers]);
+
+		for (uint32_t i = 0; i < numWorkers; i++)
+		{
+			workers[i].jobs.reset(new Job[MaxJobsPerWorker]);
+		}
+
+		bRunning = true;
+		numQueuedJobs = 0;
+		ownerThread = std::this_thread::get_id();
+
+		threads.reserve(numWorkers - 1);
+
+		for (uint32_t i = 1; i < numWorkers; i++)
+		{
+			threads.emplace_back(&JobSystem::workerMain, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			bRunning = false;
+		}
+
+		wakeCondition.notify_all();
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	Job* JobSystem::createJob(const JobFunction& function)
+	{
+		Job* job = allocateJob();
+		job->function = function;
+		job->parent = nullptr;
+		job->unfinishedJobs = 1;
+		job->numContinuations = 0;
+
+		return job;
+	}
+
+	Job* JobSystem::createChildJob(Job* parent, const JobFunction& function)
+	{
+		parent->unfinishedJobs++;
+
+		Job* job = allocateJob();
+		job->function = function;
+		job->parent = parent;
+		job->unfinishedJobs = 1;
+		job->numContinuations = 0;
+
+		return job;
+	}
+
+	void JobSystem::addContinuation(Job* job, Job* continuation)
+	{
+		int32_t index = job->numContinuations++;
+
+		if (index < Job::MaxContinuations)
+		{
+			job->continuations[index] = continuation;
+		}
+		else
+		{
+			// Out of continuation slots, chain it behind the last one instead
+			job->numContinuations--;
+			addContinuation(job->continuations[Job::MaxContinuations - 1], continuation);
+		}
+	}
+
+	void JobSystem::run(Job* job)
+	{
+		uint32_t workerIndex = getWorkerIndex();
+		assert(workerIndex != InvalidWorkerIndex && "JobSystem used from a thread it doesn't own");
+
+		// A full queue runs the job right away rather than dropping it
+		if (!workers[workerIndex].queue.push(job))
+		{
+			execute(job, workerIndex);
+			return;
+		}
+
+		numQueuedJobs++;
+
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+		}
+
+		wakeCondition.notify_one();
+	}
+
+	void JobSystem::wait(const Job* job)
+	{
+		uint32_t workerIndex = getWorkerIndex();
+		assert(workerIndex != InvalidWorkerIndex && "JobSystem used from a thread it doesn't own");
+
+		while (!isFinished(job))
+		{
+			Job* next = getJob(workerIndex);
+
+			if (next != nullptr)
+			{
+				execute(next, workerIndex);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::isFinished(const Job* job) const
+	{
+		return job->unfinishedJobs.load() == 0;
+	}
+
+	uint32_t JobSystem::getNumWorkers() const
+	{
+		return numWorkers;
+	}
+
+	uint32_t JobSystem::getWorkerIndex() const
+	{
+		if (currentJobSystem == this)
+		{
+			return currentWorkerIndex;
+		}
+
+		if (std::this_thread::get_id() == ownerThread)
+		{
+			return 0;
+		}
+
+		return InvalidWorkerIndex;
+	}
+
+	Job* JobSystem::allocateJob()
+	{
+		uint32_t workerIndex = getWorkerIndex();
+		assert(workerIndex != InvalidWorkerIndex && "JobSystem used from a thread it doesn't own");
+
+		Worker& worker = workers[workerIndex];
+
+		// Skip the slots of jobs still in flight, a waiting thread that picks up more work
+		// can keep older jobs alive while the ring wraps around
+		for (uint32_t i = 0; i < MaxJobsPerWorker; i++)
+		{
+			Job* job = &worker.jobs[worker.nextJob % MaxJobsPerWorker];
+			worker.nextJob++;
+
+			if (job->unfinishedJobs.load() == 0)
+			{
+				return job;
+			}
+		}
+
+		assert(false && "more than MaxJobsPerWorker jobs in flight");
+		return nullptr;
+	}
+
+	Job* JobSystem::getJob(uint32_t workerIndex)
+	{
+		Job* job = workers[workerIndex].queue.pop();
+
+		if (job != nullptr)
+		{
+			numQueuedJobs--;
+			return job;
+		}
+
+		for (uint32_t i = 1; i < numWorkers; i++)
+		{
+			job = workers[(workerIndex + i) % numWorkers].queue.steal();
+
+			if (job != nullptr)
+			{
+				numQueuedJobs--;
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void JobSystem::execute(Job* job, uint32_t workerIndex)
+	{
+		if (job->function)
+		{
+			job->function(workerIndex);
+		}
+
+		finish(job);
+	}
+
+	void JobSystem::finish(Job* job)
+	{
+		// Read everything needed before the decrement, once the job is seen as finished its
+		// slot can be recycled by the worker that owns it
+		Job* parent = job->parent;
+		int32_t numContinuations = std::min(job->numContinuations.load(), Job::MaxContinuations);
+		Job* continuations[Job::MaxContinuations];
+
+		for (int32_t i = 0; i < numContinuations; i++)
+		{
+			continuations[i] = job->continuations[i];
+		}
+
+		if (--job->unfinishedJobs != 0)
+		{
+			return;
+		}
+
+		for (int32_t i = 0; i < numContinuations; i++)
+		{
+			run(continuations[i]);
+		}
+
+		if (parent != nullptr)
+		{
+			finish(parent);
+		}
+	}
+
+	void JobSystem::workerMain(uint32_t workerIndex)
+	{
+		currentJobSystem = this;
+		currentWorkerIndex = workerIndex;
+
+		while (bRunning)
+		{
+			Job* job = getJob(workerIndex);
+
+			if (job != nullptr)
+			{
+				execute(job, workerIndex);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wakeCondition.wait(lock, [this]() { return !bRunning || numQueuedJobs > 0; });
+		}
+	}
+}
\ No newline at end of file
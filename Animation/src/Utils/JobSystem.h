@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Util
+{
+	// Called with the index of the worker running the job, which can be used to pick
+	// per-worker scratch data
+	using JobFunction = std::function<void(uint32_t)>;
+
+	struct Job
+	{
+		static constexpr int32_t MaxContinuations = 8;
+
+		Job() : parent(nullptr), unfinishedJobs(0), numContinuations(0) {}
+
+		JobFunction function;
+		Job* parent;
+
+		// The job itself plus its unfinished children
+		std::atomic<int32_t> unfinishedJobs;
+
+		std::atomic<int32_t> numContinuations;
+		Job* continuations[MaxContinuations];
+	};
+
+	// Fixed size deque of jobs. The owning worker pushes and pops at the back (newest
+	// first, which keeps its data hot), other workers steal from the front.
+	class JobQueue
+	{
+	public:
+		static constexpr uint32_t Capacity = 4096;
+
+		JobQueue();
+
+		bool push(Job* job);
+		Job* pop();
+		Job* steal();
+
+	private:
+		std::mutex mutex;
+		Job* jobs[Capacity];
+		uint32_t front;
+		uint32_t back;
+	};
+
+	// Work-stealing job scheduler. Every worker thread, plus the thread that created the
+	// system (worker 0), owns a job queue and a job pool. Idle workers steal from the
+	// others, a thread waiting on a job runs other jobs until it is done.
+	//
+	// Jobs come from a per-worker ring, allocation skips the slots still in flight and a
+	// worker must not have more than MaxJobsPerWorker of them at once, which allocateJob
+	// asserts. parallelFor never uses more than MaxParallelForBatches, but a wait runs
+	// other jobs, so nested parallelFor calls can stack up that many per level.
+	// Jobs must be created, run and waited on from the creating thread or from inside
+	// other jobs of the same system. Other threads have no worker of their own and are
+	// rejected with an assert.
+	class JobSystem
+	{
+	public:
+		static constexpr uint32_t MaxJobsPerWorker = 4096;
+		static constexpr uint32_t MaxParallelForBatches = MaxJobsPerWorker / 4;
+		static constexpr uint32_t InvalidWorkerIndex = 0xffffffff;
+
+		// numWorkers includes the calling thread, 0 picks one per hardware thread
+		JobSystem(uint32_t numWorkers = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		Job* createJob(const JobFunction& function);
+
+		// The parent is only finished once all of its children are
+		Job* createChildJob(Job* parent, const JobFunction& function);
+
+		// Runs continuation once job and its children are finished. Has to be called
+		// before job is run.
+		void addContinuation(Job* job, Job* continuation);
+
+		void run(Job* job);
+		void wait(const Job* job);
+		bool isFinished(const Job* job) const;
+
+		uint32_t getNumWorkers() const;
+
+		// Worker of the calling thread, InvalidWorkerIndex for threads outside the system
+		uint32_t getWorkerIndex() const;
+
+		// Splits [0, count) into batches of batchSize and calls
+		// function(begin, end, workerIndex) for each of them in parallel. Returns once
+		// every batch is done. batchSize grows if count needs more than
+		// MaxParallelForBatches batches.
+		template <typename TFunction>
+		void parallelFor(uint32_t count, uint32_t batchSize, const TFunction& function);
+
+	private:
+		struct Worker
+		{
+			Worker() : nextJob(0) {}
+
+			JobQueue queue;
+			std::unique_ptr<Job[]> jobs;
+			uint32_t nextJob;
+		};
+
+		Job* allocateJob();
+		Job* getJob(uint32_t workerIndex);
+		void execute(Job* job, uint32_t workerIndex);
+		void finish(Job* job);
+		void workerMain(uint32_t workerIndex);
+
+	private:
+		uint32_t numWorkers;
+		std::thread::id ownerThread;
+		std::unique_ptr<Worker[]> workers;
+		std::vector<std::thread> threads;
+
+		std::atomic<bool> bRunning;
+		std::atomic<int32_t> numQueuedJobs;
+		std::mutex wakeMutex;
+		std::condition_variable wakeCondition;
+	};
+
+	template <typename TFunction>
+	void JobSystem::parallelFor(uint32_t count, uint32_t batchSize, const TFunction& function)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (batchSize == 0)
+		{
+			batchSize = 1;
+		}
+
+		// Keep the batches, plus the root, well within the job ring of this worker
+		uint32_t minBatchSize = (count - 1) / MaxParallelForBatches + 1;
+
+		if (batchSize < minBatchSize)
+		{
+			batchSize = minBatchSize;
+		}
+
+		Job* root = createJob(nullptr);
+
+		for (uint32_t begin = 0; begin < count; begin += batchSize)
+		{
+			uint32_t end = begin + batchSize < count ? begin + batchSize : count;
+
+			run(createChildJob(root, [&function, begin, end](uint32_t workerIndex)
+			{
+				function(begin, end, workerIndex);
+			}));
+		}
+
+		run(root);
+		wait(root);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationBaker.h>
+#include <Utils/JobSystem.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationBakerTestsHelpers
+{
+	const uint32_t TextureSize = 1024;
+
+	// The baker before it went through the hierarchy once per column, one
+	// getGlobalTransform per joint
+	void bakePerJoint(const Skeleton& skeleton, const AnimationClip& animationClip, AnimationTexture& texture)
+	{
+		AnimationPose pose = skeleton.getBindPose();
+		uint32_t textureWidth = texture.getSize();
+
+		for (uint32_t x = 0; x < textureWidth; x++)
+		{
+			float t = static_cast<float>(x) / (textureWidth - 1);
+			float time = animationClip.getStartTime() + animationClip.getDuration() * t;
+
+			animationClip.sample(pose, time);
+
+			for (uint32_t y = 0; y < pose.getSize() * 3; y += 3)
+			{
+				Transform node = pose.getGlobalTransform(y / 3);
+
+				texture.setTexel(x, y + 0, node.position);
+				texture.setTexel(x, y + 1, node.rotation);
+				texture.setTexel(x, y + 2, node.scale);
+			}
+		}
+
+		texture.uploadTextureDataToGPU();
+	}
+
+	float maxDifference(const AnimationTexture& a, uint32_t rowOffsetA, const AnimationTexture& b, uint32_t rowOffsetB, uint32_t numRows)
+	{
+		float difference = 0.0f;
+
+		for (uint32_t x = 0; x < a.getSize(); x++)
+		{
+			for (uint32_t y = 0; y < numRows; y++)
+			{
+				Vector4 texelA = a.getTexel(x, rowOffsetA + y);
+				Vector4 texelB = b.getTexel(x, rowOffsetB + y);
+
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					difference = std::fmax(difference, std::abs(texelA.elements[i] - texelB.elements[i]));
+				}
+			}
+		}
+
+		return difference;
+	}
+}
+
+TEST(AnimationBakerMatchesPerJointBake)
+{
+	using namespace AnimationBakerTestsHelpers;
+
+	if (!Tests::createGLContext())
+	{
+		return;
+	}
+
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+	std::vector<AnimationClip>& clips = Tests::getWomanClips();
+	uint32_t numRows = skeleton.getBindPose().getSize() * 3;
+
+	AnimationTexture expected;
+	expected.resize(TextureSize);
+	bakePerJoint(skeleton, clips[7], expected);
+
+	AnimationTexture texture;
+	texture.resize(TextureSize);
+	bakeAnimationToTexture(skeleton, clips[7], texture);
+
+	CHECK(maxDifference(texture, 0, expected, 0, numRows) < 1e-5f);
+
+	Util::JobSystem jobSystem(4);
+	AnimationTexture parallelTexture;
+	parallelTexture.resize(TextureSize);
+	bakeAnimationToTexture(skeleton, clips[7], parallelTexture, jobSystem);
+
+	CHECK(maxDifference(parallelTexture, 0, texture, 0, numRows) == 0.0f);
+
+	// The atlas is as wide as it is tall, enough rows for every clip
+	AnimationTexture atlas;
+	std::vector<uint32_t> rowOffsets;
+	bakeAnimationsToTexture(skeleton, clips, atlas, rowOffsets, jobSystem);
+
+	AnimationTexture atlasWide;
+	atlasWide.resize(atlas.getSize());
+	bakePerJoint(skeleton, clips[7], atlasWide);
+
+	CHECK(rowOffsets.size() == clips.size());
+	CHECK(maxDifference(atlas, rowOffsets[7], atlasWide, 0, numRows) < 1e-5f);
+}
+
+// Every clip of Woman.gltf into TextureSize columns, uploads included
+BENCHMARK(AnimationBakerBakeTime)
+{
+	using namespace AnimationBakerTestsHelpers;
+
+	if (!Tests::createGLContext())
+	{
+		return;
+	}
+
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+	std::vector<AnimationClip>& clips = Tests::getWomanClips();
+
+	AnimationTexture texture;
+	texture.resize(TextureSize);
+
+	double perJointTime = Tests::measure(5, [&]()
+	{
+		for (const AnimationClip& clip : clips)
+		{
+			bakePerJoint(skeleton, clip, texture);
+		}
+	});
+
+	double bakeTime = Tests::measure(5, [&]()
+	{
+		for (const AnimationClip& clip : clips)
+		{
+			bakeAnimationToTexture(skeleton, clip, texture);
+		}
+	});
+
+	Util::JobSystem jobSystem;
+
+	double parallelBakeTime = Tests::measure(5, [&]()
+	{
+		for (const AnimationClip& clip : clips)
+		{
+			bakeAnimationToTexture(skeleton, clip, texture, jobSystem);
+		}
+	});
+
+	spdlog::info("{} clips, {} columns: per joint {:.2f} ms, one hierarchy pass {:.2f} ms ({:.2f}x), {} workers {:.2f} ms ({:.2f}x)",
+		clips.size(), TextureSize, perJointTime, bakeTime, perJointTime / bakeTime,
+		jobSystem.getNumWorkers(), parallelBakeTime, perJointTime / parallelBakeTime);
+}
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationClip.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationClipTestsHelpers
+{
+	const uint32_t NumInstances = 1000;
+
+	// Times spread over a bit more than two loops of the clip, so some of them wrap
+	std::vector<float> createInstanceTimes(const FastAnimationClip& clip)
+	{
+		std::vector<float> times(NumInstances);
+
+		for (uint32_t i = 0; i < NumInstances; i++)
+		{
+			float t = std::fmod(i * 0.618034f, 1.0f);
+			times[i] = clip.getStartTime() + clip.getDuration() * 2.2f * t;
+		}
+
+		return times;
+	}
+
+	float maxDifference(const AnimationPose& a, const AnimationPose& b)
+	{
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < a.getSize(); i++)
+		{
+			const Transform& transformA = a.getLocalTransform(i);
+			const Transform& transformB = b.getLocalTransform(i);
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				difference = std::fmax(difference, std::abs(transformA.position.elements[j] - transformB.position.elements[j]));
+				difference = std::fmax(difference, std::abs(transformA.scale.elements[j] - transformB.scale.elements[j]));
+			}
+
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				difference = std::fmax(difference, std::abs(transformA.rotation.elements[j] - transformB.rotation.elements[j]));
+			}
+		}
+
+		return difference;
+	}
+
+	// Both hands and the head, whose chains share the spine
+	const std::vector<uint32_t> QueriedJoints = { 25, 26, 17 };
+
+	bool equal(const Transform& a, const Transform& b)
+	{
+		return std::memcmp(&a, &b, sizeof(Transform)) == 0;
+	}
+
+	// Compares sampleJoints and sampleGlobalTransform with sample at times that wrap
+	template <typename TAnimationClip>
+	void checkSampleJoints(const TAnimationClip& clip)
+	{
+		const AnimationPose& restPose = Tests::getWomanSkeleton().getRestPose();
+		uint32_t numJoints = restPose.getSize();
+
+		std::vector<bool> inChains(numJoints, false);
+
+		for (uint32_t jointId : QueriedJoints)
+		{
+			for (int32_t current = static_cast<int32_t>(jointId); current >= 0; current = restPose.getParent(current))
+			{
+				inChains[current] = true;
+			}
+		}
+
+		bool bJointsMatch = true;
+		bool bChainsMatch = true;
+		bool bOthersUntouched = true;
+		float maxGlobalDifference = 0.0f;
+
+		for (float t : { 0.0f, 0.37f, 0.81f, 1.6f })
+		{
+			float time = clip.getStartTime() + clip.getDuration() * t;
+
+			AnimationPose expected = restPose;
+			clip.sample(expected, time);
+
+			AnimationPose joints = restPose;
+			clip.sampleJoints(joints, time, QueriedJoints);
+
+			AnimationPose chains = restPose;
+			clip.sampleJoints(chains, time, QueriedJoints, true);
+
+			for (uint32_t i = 0; i < numJoints; i++)
+			{
+				bool bQueried = std::find(QueriedJoints.begin(), QueriedJoints.end(), i) != QueriedJoints.end();
+
+				bJointsMatch = bJointsMatch && equal(joints.getLocalTransform(i), bQueried ? expected.getLocalTransform(i) : restPose.getLocalTransform(i));
+				bChainsMatch = bChainsMatch && equal(chains.getLocalTransform(i), inChains[i] ? expected.getLocalTransform(i) : restPose.getLocalTransform(i));
+				bOthersUntouched = bOthersUntouched && (inChains[i] || equal(chains.getLocalTransform(i), restPose.getLocalTransform(i)));
+			}
+
+			for (uint32_t jointId : QueriedJoints)
+			{
+				Transform global = expected.getGlobalTransform(jointId);
+				Transform chainGlobal = chains.getGlobalTransform(jointId);
+				Transform sampledGlobal = clip.sampleGlobalTransform(restPose, time, jointId);
+
+				maxGlobalDifference = std::fmax(maxGlobalDifference, length(chainGlobal.position - global.position));
+				maxGlobalDifference = std::fmax(maxGlobalDifference, length(sampledGlobal.position - global.position));
+				maxGlobalDifference = std::fmax(maxGlobalDifference, 1.0f - std::abs(dot(sampledGlobal.rotation, global.rotation)));
+			}
+		}
+
+		CHECK(bJointsMatch);
+		CHECK(bChainsMatch);
+		CHECK(bOthersUntouched);
+		CHECK(maxGlobalDifference < 1e-4f);
+	}
+
+	const char* getName(QuaternionInterpolation quaternionInterpolation)
+	{
+		switch (quaternionInterpolation)
+		{
+		case QuaternionInterpolation::Nlerp:
+			return "Nlerp";
+		case QuaternionInterpolation::FastSlerp:
+			return "FastSlerp";
+		default:
+			return "Slerp";
+		}
+	}
+}
+
+TEST(FastAnimationClipSampleBatchMatchesSample)
+{
+	using namespace AnimationClipTestsHelpers;
+
+	const AnimationPose& bindPose = Tests::getWomanSkeleton().getBindPose();
+
+	for (QuaternionInterpolation quaternionInterpolation : { QuaternionInterpolation::Nlerp, QuaternionInterpolation::FastSlerp, QuaternionInterpolation::Slerp })
+	{
+		FastAnimationClip clip = Tests::getWomanFastClips()[7];
+		clip.setQuaternionInterpolation(quaternionInterpolation);
+
+		std::vector<float> times = createInstanceTimes(clip);
+		std::vector<AnimationPose> expected(NumInstances, bindPose);
+		std::vector<AnimationPose> poses(NumInstances, bindPose);
+
+		for (uint32_t i = 0; i < NumInstances; i++)
+		{
+			clip.sample(expected[i], times[i]);
+		}
+
+		clip.sampleBatch(times.data(), poses.data(), NumInstances);
+
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < NumInstances; i++)
+		{
+			difference = std::fmax(difference, maxDifference(poses[i], expected[i]));
+		}
+
+		CHECK(difference < 1e-5f);
+	}
+}
+
+TEST(AnimationClipSampleJointsMatchesSample)
+{
+	using namespace AnimationClipTestsHelpers;
+
+	for (uint32_t clip : { 0u, 5u, 7u })
+	{
+		checkSampleJoints(Tests::getWomanClips()[clip]);
+		checkSampleJoints(Tests::getWomanFastClips()[clip]);
+	}
+}
+
+TEST(AnimationClipTracksSortedByJointId)
+{
+	AnimationClip clip;
+
+	// Out of order, every track tagged with a key count that tells its joint
+	for (uint32_t jointId : { 7u, 2u, 9u, 0u, 4u })
+	{
+		clip[jointId].getPositionTrack().resize(jointId + 1);
+	}
+
+	// Existing joints aren't added again
+	clip[2].getPositionTrack();
+
+	const uint32_t sortedIds[] = { 0, 2, 4, 7, 9 };
+	bool bSorted = clip.getSize() == 5;
+
+	for (uint32_t i = 0; bSorted && i < 5; i++)
+	{
+		uint32_t jointId = sortedIds[i];
+
+		bSorted = clip.getJointIdAtIndex(i) == jointId && clip.getTrackIndex(jointId) == static_cast<int32_t>(i) &&
+			clip[jointId].getPositionTrack().frameCount() == jointId + 1;
+	}
+
+	CHECK(bSorted);
+	CHECK(clip.getTrackIndex(1) == -1);
+	CHECK(clip.getTrackIndex(100) == -1);
+
+	// Swapped ids and one moved past the others, as RearrangeBones does
+	clip.setJointIdAtIndex(0, 9);
+	clip.setJointIdAtIndex(4, 0);
+	clip.setJointIdAtIndex(2, 12);
+
+	// The tracks stay where they are until sortTracks, the lookup follows right away
+	CHECK(clip.getJointIdAtIndex(0) == 9 && clip.getJointIdAtIndex(4) == 0 && clip.getJointIdAtIndex(2) == 12);
+	CHECK(clip.getTrackIndex(9) == 0 && clip.getTrackIndex(0) == 4 && clip.getTrackIndex(12) == 2);
+	CHECK(clip.getTrackIndex(4) == -1);
+
+	clip.sortTracks();
+
+	// New id and the key count of the track it had before
+	const uint32_t rearrangedIds[] = { 0, 2, 7, 9, 12 };
+	const uint32_t keyCounts[] = { 10, 3, 8, 1, 5 };
+	bool bRearranged = clip.getSize() == 5;
+
+	for (uint32_t i = 0; bRearranged && i < 5; i++)
+	{
+		uint32_t jointId = rearrangedIds[i];
+
+		bRearranged = clip.getJointIdAtIndex(i) == jointId && clip.getTrackIndex(jointId) == static_cast<int32_t>(i) &&
+			clip[jointId].getPositionTrack().frameCount() == keyCounts[i];
+	}
+
+	CHECK(bRearranged);
+	CHECK(clip.getTrackIndex(4) == -1);
+	CHECK(clip.getSize() == 5);
+}
+
+// A crowd of NumInstances playing Walking at their own times
+BENCHMARK(FastAnimationClipSampleBatch)
+{
+	using namespace AnimationClipTestsHelpers;
+
+	const AnimationPose& bindPose = Tests::getWomanSkeleton().getBindPose();
+
+	for (QuaternionInterpolation quaternionInterpolation : { QuaternionInterpolation::Nlerp, QuaternionInterpolation::FastSlerp, QuaternionInterpolation::Slerp })
+	{
+		FastAnimationClip clip = Tests::getWomanFastClips()[7];
+		clip.setQuaternionInterpolation(quaternionInterpolation);
+
+		std::vector<float> times = createInstanceTimes(clip);
+		std::vector<AnimationPose> poses(NumInstances, bindPose);
+
+		double sampleTime = Tests::measure(15, [&]()
+		{
+			for (uint32_t i = 0; i < NumInstances; i++)
+			{
+				clip.sample(poses[i], times[i]);
+			}
+		});
+
+		double batchTime = Tests::measure(15, [&]()
+		{
+			clip.sampleBatch(times.data(), poses.data(), NumInstances);
+		});
+
+		spdlog::info("{}, {} instances: sample {:.3f} ms, sampleBatch {:.3f} ms, {:.2f}x",
+			getName(quaternionInterpolation), NumInstances, sampleTime, batchTime, sampleTime / batchTime);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationPose.h>
+#include <Math/Matrix3x4.h>
+#include <Math/Matrix4.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationPoseTestsHelpers
+{
+	AnimationPose samplePose(float time)
+	{
+		AnimationPose pose = Tests::getWomanSkeleton().getRestPose();
+		Tests::getWomanClips()[0].sample(pose, time);
+
+		return pose;
+	}
+
+	float maxDifference(const Matrix4& a, const Matrix3x4& b)
+	{
+		Matrix4 expanded = toMatrix4(b);
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			difference = std::fmax(difference, std::abs(a.elements[i] - expanded.elements[i]));
+		}
+
+		return difference;
+	}
+}
+
+TEST(AnimationPoseMatrixPalettesAgree)
+{
+	using namespace AnimationPoseTestsHelpers;
+
+	AnimationPose pose = samplePose(0.3f);
+	const std::vector<Matrix3x4>& inverseBindPose = Tests::getWomanSkeleton().getAffineInverseBindPose();
+
+	std::vector<Matrix4> palette;
+	std::vector<Matrix3x4> affinePalette;
+	pose.getMatrixPalette(palette);
+	pose.getMatrixPalette(affinePalette);
+
+	std::vector<Matrix4> skinningPalette(pose.getSize());
+	std::vector<Matrix3x4> affineSkinningPalette(pose.getSize());
+	pose.getSkinningPalette(inverseBindPose, &skinningPalette[0]);
+	pose.getSkinningPalette(inverseBindPose, &affineSkinningPalette[0]);
+
+	float difference = 0.0f;
+
+	for (uint32_t i = 0; i < pose.getSize(); i++)
+	{
+		difference = std::fmax(difference, maxDifference(palette[i], affinePalette[i]));
+		difference = std::fmax(difference, maxDifference(skinningPalette[i], affineSkinningPalette[i]));
+	}
+
+	CHECK(difference < 1e-4f);
+}
+
+BENCHMARK(AnimationPoseMatrixPalette)
+{
+	using namespace AnimationPoseTestsHelpers;
+
+	const uint32_t NumPalettes = 10000;
+
+	AnimationPose pose = samplePose(0.3f);
+	const std::vector<Matrix3x4>& inverseBindPose = Tests::getWomanSkeleton().getAffineInverseBindPose();
+
+	std::vector<Matrix4> palette(pose.getSize());
+	std::vector<Matrix3x4> affinePalette(pose.getSize());
+
+	double matrix4Time = Tests::measure(10, [&]()
+	{
+		for (uint32_t i = 0; i < NumPalettes; i++)
+		{
+			pose.getMatrixPalette(&palette[0]);
+		}
+	});
+
+	double matrix3x4Time = Tests::measure(10, [&]()
+	{
+		for (uint32_t i = 0; i < NumPalettes; i++)
+		{
+			pose.getMatrixPalette(&affinePalette[0]);
+		}
+	});
+
+	double skinningTime = Tests::measure(10, [&]()
+	{
+		for (uint32_t i = 0; i < NumPalettes; i++)
+		{
+			pose.getSkinningPalette(inverseBindPose, &palette[0]);
+		}
+	});
+
+	double affineSkinningTime = Tests::measure(10, [&]()
+	{
+		for (uint32_t i = 0; i < NumPalettes; i++)
+		{
+			pose.getSkinningPalette(inverseBindPose, &affinePalette[0]);
+		}
+	});
+
+	spdlog::info("{} palettes of {} joints", NumPalettes, pose.getSize());
+	spdlog::info("getMatrixPalette Matrix4: {:.3f} ms, Matrix3x4: {:.3f} ms", matrix4Time, matrix3x4Time);
+	spdlog::info("getSkinningPalette Matrix4: {:.3f} ms, Matrix3x4: {:.3f} ms", skinningTime, affineSkinningTime);
+}
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationSystem.h>
+#include <Math/Matrix3x4.h>
+#include <Utils/JobSystem.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationSystemTestsHelpers
+{
+	const uint32_t NumCharacters = 5000;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	bool nearlyEqual(const Matrix3x4& a, const Matrix3x4& b)
+	{
+		for (uint32_t i = 0; i < 12; i++)
+		{
+			if (std::abs(a.elements[i] - b.elements[i]) > 1e-4f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	template <typename TAnimationClip>
+	void addCharacters(AnimationSystem<TAnimationClip>& animationSystem, const std::vector<TAnimationClip>& clips)
+	{
+		animationSystem.reserve(NumCharacters);
+
+		for (uint32_t i = 0; i < NumCharacters; i++)
+		{
+			const TAnimationClip& clip = clips[i % clips.size()];
+			float time = clip.getStartTime() + clip.getDuration() * static_cast<float>(i % 97) / 97.0f;
+			animationSystem.addInstance(i % clips.size(), time);
+		}
+	}
+}
+
+TEST(AnimationSystemPaletteMatchesPose)
+{
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+
+	AnimationSystem<FastAnimationClip> animationSystem;
+	animationSystem.setSkeleton(skeleton);
+	animationSystem.setAnimationClips(clips);
+
+	uint32_t instance = animationSystem.addInstance(1, 0.25f);
+	animationSystem.update(0.1f);
+
+	AnimationPose pose = skeleton.getRestPose();
+	clips[1].sample(pose, 0.35f);
+
+	std::vector<Matrix3x4> expected(pose.getSize());
+	pose.getSkinningPalette(skeleton.getAffineInverseBindPose(), &expected[0]);
+
+	const Matrix3x4* palette = animationSystem.getPalette(instance);
+	bool bMatches = animationSystem.getPaletteStride() == pose.getSize();
+
+	for (uint32_t i = 0; bMatches && i < pose.getSize(); i++)
+	{
+		bMatches = AnimationSystemTestsHelpers::nearlyEqual(palette[i], expected[i]);
+	}
+
+	CHECK(bMatches);
+}
+
+TEST(AnimationSystemRejectsInvalidClips)
+{
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	uint32_t numClips = static_cast<uint32_t>(clips.size());
+
+	AnimationSystem<FastAnimationClip> animationSystem;
+	animationSystem.setSkeleton(Tests::getWomanSkeleton());
+	animationSystem.setAnimationClips(clips);
+
+	CHECK(animationSystem.addInstance(numClips) == AnimationSystem<FastAnimationClip>::InvalidInstance);
+	CHECK(animationSystem.getNumInstances() == 0);
+
+	uint32_t instance = animationSystem.addInstance(0);
+	animationSystem.play(instance, numClips, 0.0f);
+	animationSystem.fadeTo(instance, numClips + 5, 0.5f);
+
+	CHECK(animationSystem.getInstance(instance).clip == 0);
+	CHECK(animationSystem.getInstance(instance).fadeClip == -1);
+
+	// Dropping clips moves their instances back to the first one
+	uint32_t lastClipInstance = animationSystem.addInstance(numClips - 1);
+	std::vector<FastAnimationClip> fewerClips(clips.begin(), clips.begin() + 1);
+	animationSystem.setAnimationClips(fewerClips);
+	animationSystem.update(AnimationSystemTestsHelpers::DeltaTime);
+
+	CHECK(animationSystem.getInstance(lastClipInstance).clip == 0);
+}
+
+TEST(AnimationSystemLODLevels)
+{
+	using namespace AnimationSystemTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+
+	AnimationSystem<FastAnimationClip> animationSystem;
+	animationSystem.setSkeleton(skeleton);
+	animationSystem.setAnimationClips(clips);
+	animationSystem.setLODDistances(10.0f, 20.0f, 30.0f);
+
+	for (uint32_t i = 0; i < 64; i++)
+	{
+		animationSystem.addInstance(i % clips.size());
+		animationSystem.setDistance(i, static_cast<float>(i % 4) * 10.0f);
+	}
+
+	// Everything is sampled once, then each level every 2^level frames
+	animationSystem.update(DeltaTime);
+
+	for (uint32_t level = 0; level < AnimationSystem<FastAnimationClip>::NumLODLevels; level++)
+	{
+		CHECK(animationSystem.getLODStats(level).numSampled == 16);
+	}
+
+	uint32_t numSampled[AnimationSystem<FastAnimationClip>::NumLODLevels] = {};
+
+	for (uint32_t frame = 0; frame < 8; frame++)
+	{
+		animationSystem.update(DeltaTime);
+
+		for (uint32_t level = 0; level < AnimationSystem<FastAnimationClip>::NumLODLevels; level++)
+		{
+			const AnimationLODStats& stats = animationSystem.getLODStats(level);
+			CHECK(stats.numInstances == 16);
+			CHECK(stats.numSampled + stats.numInterpolated == 16);
+			numSampled[level] += stats.numSampled;
+		}
+	}
+
+	CHECK(numSampled[0] == 16 * 8);
+	CHECK(numSampled[1] == 16 * 4);
+	CHECK(numSampled[2] == 16 * 2);
+	CHECK(numSampled[3] == 16);
+
+	// Moving from level 0 to a lower rate starts from a fresh sample
+	animationSystem.setDistance(0, 10.0f);
+	animationSystem.update(DeltaTime);
+
+	AnimationPose pose = skeleton.getRestPose();
+	clips[0].sampleAtTick(pose, animationSystem.getInstance(0).tick);
+
+	std::vector<Matrix3x4> expected(pose.getSize());
+	pose.getSkinningPalette(skeleton.getAffineInverseBindPose(), &expected[0]);
+
+	const Matrix3x4* palette = animationSystem.getPalette(0);
+	bool bMatches = true;
+
+	for (uint32_t i = 0; bMatches && i < pose.getSize(); i++)
+	{
+		bMatches = nearlyEqual(palette[i], expected[i]);
+	}
+
+	CHECK(bMatches);
+}
+
+// 5000 characters of the Woman.gltf skeleton spread over its clips, one frame of
+// sampling and skinning palettes without any rendering
+BENCHMARK(AnimationSystemFiveThousandCharacters)
+{
+	using namespace AnimationSystemTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+
+	// Every character sampled and skinned on its own, the way separate controllers would
+	std::vector<float> times(NumCharacters);
+	std::vector<Matrix3x4> palettes(NumCharacters * skeleton.getRestPose().getSize());
+	AnimationPose pose = skeleton.getRestPose();
+
+	double separateTime = Tests::measure(10, [&]()
+	{
+		for (uint32_t i = 0; i < NumCharacters; i++)
+		{
+			pose = skeleton.getRestPose();
+			times[i] = clips[i % clips.size()].sample(pose, times[i] + DeltaTime);
+			pose.getSkinningPalette(skeleton.getAffineInverseBindPose(), &palettes[i * pose.getSize()]);
+		}
+	});
+
+	AnimationSystem<FastAnimationClip> animationSystem;
+	animationSystem.setSkeleton(skeleton);
+	animationSystem.setAnimationClips(clips);
+	addCharacters(animationSystem, clips);
+
+	double serialTime = Tests::measure(10, [&]() { animationSystem.update(DeltaTime); });
+
+	Util::JobSystem jobSystem(4);
+	double jobTime = Tests::measure(10, [&]() { animationSystem.update(DeltaTime, jobSystem); });
+
+	// A quarter of the characters at each LOD level
+	animationSystem.setLODDistances(10.0f, 20.0f, 30.0f);
+
+	for (uint32_t i = 0; i < NumCharacters; i++)
+	{
+		animationSystem.setDistance(i, static_cast<float>(i % 4) * 10.0f);
+	}
+
+	double lodTime = Tests::measure(16, [&]() { animationSystem.update(DeltaTime); });
+
+	spdlog::info("{} characters, {} joints, per frame", NumCharacters, skeleton.getRestPose().getSize());
+	spdlog::info("separate: {:.3f} ms", separateTime);
+	spdlog::info("AnimationSystem: {:.3f} ms", serialTime);
+	spdlog::info("AnimationSystem, {} workers: {:.3f} ms", jobSystem.getNumWorkers(), jobTime);
+	spdlog::info("AnimationSystem, update-rate LOD: {:.3f} ms", lodTime);
+}
+
+TEST(AnimationSystemBakedPlaybackOverBudget)
+{
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+
+	SkinPaletteCache<FastAnimationClip> skinPaletteCache;
+	skinPaletteCache.setSkeleton(skeleton);
+
+	// Room for two of the three clips played back
+	const uint32_t playedClips[] = { 1, 5, 7 };
+	size_t workingSet = 0;
+
+	for (uint32_t clip : playedClips)
+	{
+		workingSet += skinPaletteCache.getBakedSize(clips[clip]);
+	}
+
+	skinPaletteCache.setMemoryBudget(workingSet - 1);
+
+	AnimationSystem<FastAnimationClip> animationSystem;
+	animationSystem.setSkeleton(skeleton);
+	animationSystem.setAnimationClips(clips);
+	animationSystem.setSkinPaletteCache(&skinPaletteCache);
+
+	for (uint32_t i = 0; i < 30; i++)
+	{
+		uint32_t instance = animationSystem.addInstance(playedClips[i % 3], 0.1f * i);
+		animationSystem.setBakedPlayback(instance, true);
+	}
+
+	animationSystem.update(AnimationSystemTestsHelpers::DeltaTime);
+	uint64_t numBakes = skinPaletteCache.getNumBakes();
+
+	for (uint32_t frame = 0; frame < 20; frame++)
+	{
+		animationSystem.update(AnimationSystemTestsHelpers::DeltaTime);
+	}
+
+	CHECK(numBakes == 2);
+	CHECK(skinPaletteCache.getNumBakes() == numBakes);
+	CHECK(skinPaletteCache.getMemoryUsage() <= skinPaletteCache.getMemoryBudget());
+
+	// The instances of the clip left out are sampled as usual
+	uint32_t sampledInstance = 0;
+
+	while (sampledInstance < 3 && skinPaletteCache.findBakedClip(clips[playedClips[sampledInstance]]) != nullptr)
+	{
+		sampledInstance++;
+	}
+
+	CHECK(sampledInstance < 3);
+
+	if (sampledInstance < 3)
+	{
+		const FastAnimationClip& clip = clips[playedClips[sampledInstance]];
+		AnimationPose pose = skeleton.getRestPose();
+		clip.sample(pose, 0.1f * sampledInstance + 21 * AnimationSystemTestsHelpers::DeltaTime);
+
+		std::vector<Matrix3x4> expected(pose.getSize());
+		pose.getSkinningPalette(skeleton.getAffineInverseBindPose(), &expected[0]);
+
+		const Matrix3x4* palette = animationSystem.getPalette(sampledInstance);
+		bool bMatches = true;
+
+		for (uint32_t i = 0; bMatches && i < pose.getSize(); i++)
+		{
+			bMatches = AnimationSystemTestsHelpers::nearlyEqual(palette[i], expected[i]);
+		}
+
+		CHECK(bMatches);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationBaker.h>
+#include <Animation/AnimationTexture.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationTextureTestsHelpers
+{
+	const uint32_t TextureSize = 64;
+
+	// Difference between the float data of a texture and what its encoded data decodes to,
+	// measured like measureEncodingError
+	AnimationTextureError measureEncodedDataError(const AnimationTexture& texture)
+	{
+		AnimationTexture decoded = texture;
+		decoded.decode();
+
+		AnimationTextureError error;
+
+		for (uint32_t clipIndex = 0; clipIndex < texture.getNumClips(); clipIndex++)
+		{
+			const AnimationTextureClip& clip = texture.getClip(clipIndex);
+
+			for (uint32_t joint = 0; joint < clip.numRows / 3; joint++)
+			{
+				for (uint32_t x = 0; x < clip.numFrames; x++)
+				{
+					uint32_t y = clip.rowOffset + joint * 3;
+
+					Vector4 positionA = texture.getTexel(x, y);
+					Vector4 positionB = decoded.getTexel(x, y);
+					Vector4 rotationA = texture.getTexel(x, y + 1);
+					Vector4 rotationB = decoded.getTexel(x, y + 1);
+					Vector4 scaleA = texture.getTexel(x, y + 2);
+					Vector4 scaleB = decoded.getTexel(x, y + 2);
+
+					Vector3 positionDelta(positionA.x - positionB.x, positionA.y - positionB.y, positionA.z - positionB.z);
+					Quaternion a = normalized(Quaternion(rotationA.x, rotationA.y, rotationA.z, rotationA.w));
+					Quaternion b = normalized(Quaternion(rotationB.x, rotationB.y, rotationB.z, rotationB.w));
+					float cosHalfAngle = std::fmin(std::abs(dot(a, b)), 1.0f);
+
+					float positionError = std::sqrt(dot(positionDelta, positionDelta));
+					float scaleError = 0.0f;
+
+					for (uint32_t i = 0; i < 3; i++)
+					{
+						scaleError = std::fmax(scaleError, std::abs(scaleA.elements[i] - scaleB.elements[i]));
+					}
+
+					error.maxPositionError = std::fmax(error.maxPositionError, positionError);
+					error.maxRotationError = std::fmax(error.maxRotationError, 2.0f * std::acos(cosHalfAngle));
+					error.maxScaleError = std::fmax(error.maxScaleError, scaleError);
+				}
+			}
+		}
+
+		return error;
+	}
+
+	const char* const TestFilePath = "AnimationTextureTests.atex";
+
+	// Size of the header and clip directory of a file, where the chunk table starts
+	size_t getChunkTableOffset(const AnimationTexture& texture)
+	{
+		size_t offset = sizeof(AnimationTextureFileHeader);
+
+		for (uint32_t i = 0; i < texture.getNumClips(); i++)
+		{
+			offset += 61 + texture.getClip(i).name.size();
+		}
+
+		return offset;
+	}
+
+	std::vector<uint8_t> readFile(const char* path)
+	{
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(const char* path, const std::vector<uint8_t>& bytes)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::binary);
+		file.write((const char*)bytes.data(), bytes.size());
+	}
+
+	// Three clips of Woman.gltf, several chunks of data in every format
+	void bakeTestTexture(AnimationTexture& texture, AnimationTextureFormat format)
+	{
+		std::vector<AnimationClip>& clips = Tests::getWomanClips();
+		std::vector<AnimationClip> bakedClips = { clips[0], clips[7], clips[4] };
+		std::vector<uint32_t> rowOffsets;
+
+		texture.resize(128);
+		bakeAnimationsToTexture(Tests::getWomanSkeleton(), bakedClips, texture, rowOffsets);
+		texture.setFormat(format);
+	}
+}
+
+TEST(AnimationTextureUploadEncodesCurrentData)
+{
+	using namespace AnimationTextureTestsHelpers;
+
+	if (!Tests::createGLContext())
+	{
+		return;
+	}
+
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+	std::vector<AnimationClip>& clips = Tests::getWomanClips();
+
+	for (AnimationTextureFormat format : { AnimationTextureFormat::RGBA16F, AnimationTextureFormat::Packed })
+	{
+		AnimationTexture texture;
+		texture.resize(TextureSize);
+
+		std::vector<AnimationClip> firstClips = { clips[7] };
+		std::vector<uint32_t> rowOffsets;
+		bakeAnimationsToTexture(skeleton, firstClips, texture, rowOffsets);
+		texture.setFormat(format);
+
+		// A rebake changes the data and the layout without going through setFormat
+		std::vector<AnimationClip> secondClips = { clips[0], clips[7], clips[4] };
+		bakeAnimationsToTexture(skeleton, secondClips, texture, rowOffsets);
+
+		AnimationTextureError expected = texture.measureEncodingError();
+		AnimationTextureError error = measureEncodedDataError(texture);
+
+		CHECK(texture.getEncodedData().size() == static_cast<size_t>(texture.getSize()) * texture.getEncodedHeight() * 4);
+		CHECK(error.maxPositionError <= expected.maxPositionError + 1e-6f);
+		// acos is steep next to 1, the angles only agree to a few 1e-4
+		CHECK(error.maxRotationError <= expected.maxRotationError + 1e-3f);
+		CHECK(error.maxScaleError <= expected.maxScaleError + 1e-6f);
+	}
+}
+
+TEST(AnimationTextureFileRoundTrip)
+{
+	using namespace AnimationTextureTestsHelpers;
+
+	if (!Tests::createGLContext())
+	{
+		return;
+	}
+
+	for (AnimationTextureFormat format : { AnimationTextureFormat::RGBA32F, AnimationTextureFormat::RGBA16F, AnimationTextureFormat::Packed })
+	{
+		AnimationTexture texture;
+		bakeTestTexture(texture, format);
+
+		for (bool bCompress : { false, true })
+		{
+			CHECK(texture.save(TestFilePath, bCompress));
+
+			// The padding of the header is written as zeros
+			std::vector<uint8_t> bytes = readFile(TestFilePath);
+			AnimationTextureFileHeader header = {};
+
+			if (bytes.size() >= sizeof(header))
+			{
+				std::copy(bytes.begin(), bytes.begin() + sizeof(header), (uint8_t*)&header);
+			}
+
+			CHECK(header.padding == 0);
+			CHECK(header.numChunks > 1);
+
+			AnimationTexture loaded;
+			uint32_t numChunksRead = 1;
+
+			CHECK(loaded.beginLoad(TestFilePath));
+			CHECK(loaded.isLoading());
+
+			while (loaded.loadNextChunk())
+			{
+				numChunksRead++;
+			}
+
+			CHECK(loaded.getLoadProgress() == 1.0f);
+			CHECK(loaded.endLoad());
+			CHECK(!loaded.isLoading());
+			CHECK(numChunksRead == header.numChunks);
+
+			CHECK(loaded.getFormat() == format);
+			CHECK(loaded.getSize() == texture.getSize());
+			CHECK(loaded.getHeight() == texture.getHeight());
+			CHECK(loaded.getNumClips() == texture.getNumClips());
+
+			bool bSameClips = loaded.getNumClips() == texture.getNumClips();
+
+			for (uint32_t i = 0; bSameClips && i < texture.getNumClips(); i++)
+			{
+				const AnimationTextureClip& a = texture.getClip(i);
+				const AnimationTextureClip& b = loaded.getClip(i);
+
+				bSameClips = a.name == b.name && a.rowOffset == b.rowOffset && a.numRows == b.numRows &&
+					a.numFrames == b.numFrames && a.duration == b.duration && a.bLooping == b.bLooping &&
+					a.encodedRowOffset == b.encodedRowOffset && a.rowsPerJoint == b.rowsPerJoint;
+			}
+
+			CHECK(bSameClips);
+
+			if (format == AnimationTextureFormat::RGBA32F)
+			{
+				CHECK(loaded.getData() == texture.getData());
+			}
+			else
+			{
+				CHECK(loaded.getEncodedData() == texture.getEncodedData());
+
+				// Uploads what was read, not an encoding of what it decodes to
+				loaded.uploadTextureDataToGPU();
+				CHECK(loaded.getEncodedData() == texture.getEncodedData());
+			}
+		}
+	}
+
+	std::remove(TestFilePath);
+}
+
+TEST(AnimationTextureFileRejectsCorruptFiles)
+{
+	using namespace AnimationTextureTestsHelpers;
+
+	if (!Tests::createGLContext())
+	{
+		return;
+	}
+
+	AnimationTexture texture;
+	bakeTestTexture(texture, AnimationTextureFormat::RGBA16F);
+	CHECK(texture.save(TestFilePath, true));
+
+	std::vector<uint8_t> bytes = readFile(TestFilePath);
+	size_t chunkTableOffset = getChunkTableOffset(texture);
+	CHECK(bytes.size() > chunkTableOffset + 2 * sizeof(AnimationTextureChunk));
+
+	AnimationTexture loaded;
+	loaded.resize(16);
+
+	// A file cut short no longer holds the chunks of its table
+	std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 100);
+	writeFile(TestFilePath, truncated);
+	CHECK(!loaded.beginLoad(TestFilePath));
+
+	std::vector<uint8_t> badMagic = bytes;
+	badMagic[0] ^= 0xff;
+	writeFile(TestFilePath, badMagic);
+	CHECK(!loaded.beginLoad(TestFilePath));
+
+	std::vector<uint8_t> badVersion = bytes;
+	badVersion[4] = 2;
+	writeFile(TestFilePath, badVersion);
+	CHECK(!loaded.beginLoad(TestFilePath));
+
+	// A rejected file leaves the texture as it was
+	CHECK(!loaded.isLoading());
+	CHECK(loaded.getSize() == 16);
+	CHECK(loaded.getFormat() == AnimationTextureFormat::RGBA32F);
+
+	// The table passes, but the first chunk doesn't decompress from fewer bytes
+	std::vector<uint8_t> badChunk = bytes;
+	AnimationTextureChunk chunk;
+	std::copy(badChunk.begin() + chunkTableOffset, badChunk.begin() + chunkTableOffset + sizeof(chunk), (uint8_t*)&chunk);
+	chunk.storedSize /= 2;
+	std::copy((uint8_t*)&chunk, (uint8_t*)&chunk + sizeof(chunk), badChunk.begin() + chunkTableOffset);
+	writeFile(TestFilePath, badChunk);
+
+	CHECK(loaded.beginLoad(TestFilePath));
+
+	while (loaded.loadNextChunk())
+	{
+	}
+
+	CHECK(!loaded.endLoad());
+	CHECK(!loaded.isLoading());
+
+	std::remove(TestFilePath);
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationSystem.h>
+#include <Animation/AnimationTick.h>
+#include <Animation/CrossFadeController.h>
+
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationTickTestsHelpers
+{
+	// A day of 60 Hz frames, 1/60 s is exactly 800 ticks (checked by AnimationTickConversions)
+	const uint32_t FramesPerDay = 24 * 60 * 60 * 60;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	const int64_t DayTicks = static_cast<int64_t>(FramesPerDay) * 800;
+
+	// First track of Running (0.7 s) on its own, a day of frames samples in seconds instead of
+	// minutes. Playback time is handled the same whatever the number of tracks.
+	FastAnimationClip createRunningTrackClip()
+	{
+		AnimationClip& running = Tests::getWomanClips()[0];
+		uint32_t jointId = running.getJointIdAtIndex(0);
+
+		AnimationClip clip;
+		clip.setName("RunningTrack");
+		clip.setLooping(true);
+		clip[jointId] = running[jointId];
+		clip.recalculateDuration();
+
+		return optimizeAnimationClip(clip);
+	}
+
+	// Where a looping clip is after a day of frames, in one step
+	int64_t getTickAfterDay(const FastAnimationClip& clip)
+	{
+		int64_t startTick = clip.getStartTick();
+
+		return wrapTick(startTick + DayTicks, startTick, clip.getEndTick() - startTick);
+	}
+}
+
+TEST(AnimationTickConversions)
+{
+	CHECK(secondsToTicks(1.0f / 60.0f) == 800);
+	CHECK(secondsToTicks(-0.5f) == -TicksPerSecond / 2);
+	CHECK(ticksToSeconds(TicksPerSecond * 3) == 3.0f);
+
+	CHECK(wrapTick(25, 5, 10) == 5);
+	CHECK(wrapTick(14, 5, 10) == 14);
+	CHECK(wrapTick(4, 5, 10) == 14);
+	CHECK(wrapTick(-16, 5, 10) == 14);
+}
+
+TEST(CrossFadeControllerDayOfPlayback)
+{
+	using namespace AnimationTickTestsHelpers;
+
+	FastAnimationClip clip = createRunningTrackClip();
+
+	// The day doesn't end on a loop boundary
+	CHECK(DayTicks % (clip.getEndTick() - clip.getStartTick()) != 0);
+
+	CrossFadeController<FastAnimationClip> controller(Tests::getWomanSkeleton());
+	controller.play(&clip);
+
+	for (uint32_t frame = 0; frame < FramesPerDay; frame++)
+	{
+		controller.update(DeltaTime);
+	}
+
+	// Exactly the pose of the phase the clip has to be at, not merely close to it
+	AnimationPose expected = Tests::getWomanSkeleton().getRestPose();
+	clip.sampleAtTick(expected, getTickAfterDay(clip));
+
+	CHECK(controller.getCurrentAnimationPose() == expected);
+}
+
+TEST(AnimationSystemDayOfPlayback)
+{
+	using namespace AnimationTickTestsHelpers;
+
+	std::vector<FastAnimationClip> clips(1, createRunningTrackClip());
+
+	AnimationSystem<FastAnimationClip> animationSystem;
+	animationSystem.setSkeleton(Tests::getWomanSkeleton());
+	animationSystem.setAnimationClips(clips);
+
+	uint32_t instance = animationSystem.addInstance(0);
+
+	for (uint32_t frame = 0; frame < FramesPerDay; frame++)
+	{
+		animationSystem.update(DeltaTime);
+	}
+
+	CHECK(animationSystem.getInstance(instance).tick == getTickAfterDay(clips[0]));
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/AnimationClip.h>
+#include <Animation/AnimationTrack.h>
+#include <Animation/FastAnimationTrack.h>
+#include <Math/Quaternion.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace Animation;
+
+namespace AnimationTrackTestsHelpers
+{
+	// Unevenly spaced keys that start at 1 second
+	const float KeyTimes[] = { 1.0f, 1.4f, 1.45f, 2.3f, 3.1f };
+	const uint32_t NumKeys = sizeof(KeyTimes) / sizeof(KeyTimes[0]);
+
+	QuaternionTrack createRotationTrack(Interpolation interpolation)
+	{
+		QuaternionTrack track;
+		track.resize(NumKeys);
+		track.setInterpolation(interpolation);
+
+		for (uint32_t i = 0; i < NumKeys; i++)
+		{
+			Quaternion rotation = angleAxis(0.7f * i, normalized(Vector3(1.0f, 2.0f, 0.5f * i)));
+
+			AnimationKeyFrame<4>& key = track[i];
+			key = AnimationKeyFrame<4>();
+			key.time = KeyTimes[i];
+			key.value[0] = rotation.x;
+			key.value[1] = rotation.y;
+			key.value[2] = rotation.z;
+			key.value[3] = rotation.w;
+		}
+
+		track.updateHermiteSegments();
+
+		return track;
+	}
+
+	VectorTrack createPositionTrack(Interpolation interpolation)
+	{
+		VectorTrack track;
+		track.resize(NumKeys);
+		track.setInterpolation(interpolation);
+
+		for (uint32_t i = 0; i < NumKeys; i++)
+		{
+			AnimationKeyFrame<3>& key = track[i];
+			key = AnimationKeyFrame<3>();
+			key.time = KeyTimes[i];
+			key.value[0] = static_cast<float>(i);
+			key.value[1] = static_cast<float>(i * i);
+			key.value[2] = -2.0f * i;
+		}
+
+		track.updateHermiteSegments();
+
+		return track;
+	}
+
+	// Different in and out tangents on every key, cubic tracks have to use the out
+	// tangent of the key before a segment and the in tangent of the one after
+	template <int32_t N>
+	void setTangents(AnimationKeyFrame<N>& key, uint32_t index, float scale)
+	{
+		for (int32_t j = 0; j < N; j++)
+		{
+			key.in[j] = scale * std::sin(1.3f * index + j);
+			key.out[j] = scale * std::cos(0.7f * index - 2.0f * j);
+		}
+	}
+
+	float maxRotationDifference(const Quaternion& a, const Quaternion& b)
+	{
+		float sign = dot(a, b) < 0.0f ? -1.0f : 1.0f;
+		float difference = 0.0f;
+
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			difference = std::fmax(difference, std::abs(a.elements[j] - sign * b.elements[j]));
+		}
+
+		return difference;
+	}
+
+	// glTF cubic spline interpolation, evaluated as the specification writes it
+	template <int32_t N>
+	void evaluateGltfCubic(const AnimationKeyFrame<N>& current, const AnimationKeyFrame<N>& next, float time, float* out)
+	{
+		float frameDelta = next.time - current.time;
+		float t = (time - current.time) / frameDelta;
+		float t2 = t * t;
+		float t3 = t2 * t;
+
+		for (int32_t j = 0; j < N; j++)
+		{
+			out[j] = (2.0f * t3 - 3.0f * t2 + 1.0f) * current.value[j] +
+					 (t3 - 2.0f * t2 + t) * frameDelta * current.out[j] +
+					 (-2.0f * t3 + 3.0f * t2) * next.value[j] +
+					 (t3 - t2) * frameDelta * next.in[j];
+		}
+	}
+}
+
+TEST(FastAnimationTrackMatchesTrackNotStartingAtZero)
+{
+	using namespace AnimationTrackTestsHelpers;
+
+	for (Interpolation interpolation : { Interpolation::Constant, Interpolation::Linear, Interpolation::Cubic })
+	{
+		QuaternionTrack rotationTrack = createRotationTrack(interpolation);
+		FastQuaternionTrack fastRotationTrack = optimizeAnimationTrack(rotationTrack);
+		VectorTrack positionTrack = createPositionTrack(interpolation);
+		FastVectorTrack fastPositionTrack = optimizeAnimationTrack(positionTrack);
+
+		float maxRotationError = 0.0f;
+		float maxPositionError = 0.0f;
+
+		for (float time = 0.5f; time < 3.5f; time += 0.007f)
+		{
+			for (bool bLooping : { false, true })
+			{
+				Quaternion rotation = rotationTrack.sample(time, bLooping);
+				Quaternion fastRotation = fastRotationTrack.sample(time, bLooping);
+				maxRotationError = std::fmax(maxRotationError, 1.0f - std::abs(dot(rotation, fastRotation)));
+
+				Vector3 position = positionTrack.sample(time, bLooping);
+				Vector3 fastPosition = fastPositionTrack.sample(time, bLooping);
+				maxPositionError = std::fmax(maxPositionError, length(position - fastPosition));
+			}
+		}
+
+		CHECK(maxRotationError < 1e-5f);
+		CHECK(maxPositionError < 1e-4f);
+	}
+}
+
+TEST(AnimationTrackCubicMatchesGltfHermite)
+{
+	using namespace AnimationTrackTestsHelpers;
+
+	VectorTrack positionTrack = createPositionTrack(Interpolation::Cubic);
+	QuaternionTrack rotationTrack = createRotationTrack(Interpolation::Cubic);
+
+	for (uint32_t i = 0; i < NumKeys; i++)
+	{
+		setTangents(positionTrack[i], i, 2.0f);
+		setTangents(rotationTrack[i], i, 0.2f);
+	}
+
+	// Hemisphere alignment would change the curve, the keys don't need it
+	bool bSameHemisphere = true;
+
+	for (uint32_t i = 1; i < NumKeys; i++)
+	{
+		const float* a = rotationTrack[i - 1].value;
+		const float* b = rotationTrack[i].value;
+		bSameHemisphere = bSameHemisphere && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] > 0.0f;
+	}
+
+	CHECK(bSameHemisphere);
+
+	positionTrack.updateHermiteSegments();
+	rotationTrack.updateHermiteSegments();
+
+	// Updating a linear track drops the segments, the copies evaluate the Hermite basis
+	VectorTrack positionBasisTrack = positionTrack;
+	QuaternionTrack rotationBasisTrack = rotationTrack;
+
+	for (Interpolation interpolation : { Interpolation::Linear, Interpolation::Cubic })
+	{
+		positionBasisTrack.setInterpolation(interpolation);
+		positionBasisTrack.updateHermiteSegments();
+		rotationBasisTrack.setInterpolation(interpolation);
+		rotationBasisTrack.updateHermiteSegments();
+	}
+
+	float maxPositionError = 0.0f;
+	float maxBasisPositionError = 0.0f;
+	float maxRotationError = 0.0f;
+	float maxBasisRotationError = 0.0f;
+
+	for (uint32_t i = 0; i + 1 < NumKeys; i++)
+	{
+		for (float u = 0.0f; u <= 1.0f; u += 0.05f)
+		{
+			float time = KeyTimes[i] + (KeyTimes[i + 1] - KeyTimes[i]) * u;
+
+			float expectedPosition[3];
+			evaluateGltfCubic(positionTrack[i], positionTrack[i + 1], time, expectedPosition);
+
+			float expectedRotation[4];
+			evaluateGltfCubic(rotationTrack[i], rotationTrack[i + 1], time, expectedRotation);
+			Quaternion expected = normalized(Quaternion(expectedRotation[0], expectedRotation[1], expectedRotation[2], expectedRotation[3]));
+
+			Vector3 position = positionTrack.sample(time, false);
+			Vector3 basisPosition = positionBasisTrack.sample(time, false);
+			Quaternion rotation = rotationTrack.sample(time, false);
+			Quaternion basisRotation = rotationBasisTrack.sample(time, false);
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				maxPositionError = std::fmax(maxPositionError, std::abs(position.elements[j] - expectedPosition[j]));
+				maxBasisPositionError = std::fmax(maxBasisPositionError, std::abs(basisPosition.elements[j] - expectedPosition[j]));
+			}
+
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				maxRotationError = std::fmax(maxRotationError, std::abs(rotation.elements[j] - expected.elements[j]));
+				maxBasisRotationError = std::fmax(maxBasisRotationError, std::abs(basisRotation.elements[j] - expected.elements[j]));
+			}
+		}
+	}
+
+	CHECK(maxPositionError < 1e-4f);
+	CHECK(maxBasisPositionError < 1e-4f);
+	CHECK(maxRotationError < 1e-5f);
+	CHECK(maxBasisRotationError < 1e-5f);
+}
+
+TEST(QuaternionTrackPrecondition)
+{
+	using namespace AnimationTrackTestsHelpers;
+
+	for (Interpolation interpolation : { Interpolation::Linear, Interpolation::Cubic })
+	{
+		QuaternionTrack reference = createRotationTrack(interpolation);
+
+		for (uint32_t i = 0; i < NumKeys; i++)
+		{
+			setTangents(reference[i], i, interpolation == Interpolation::Cubic ? 0.2f : 0.0f);
+		}
+
+		reference.updateHermiteSegments();
+
+		// A key that isn't unit length and a key negated with its tangents, the same
+		// rotation and curve on the other side
+		QuaternionTrack track = reference;
+
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			track[1].value[j] *= 2.5f;
+			track[2].value[j] = -track[2].value[j];
+			track[2].in[j] = -track[2].in[j];
+			track[2].out[j] = -track[2].out[j];
+		}
+
+		track.precondition();
+		CHECK(track.isPreconditioned());
+
+		float maxKeyDifference = 0.0f;
+		bool bSameHemisphere = true;
+
+		for (uint32_t i = 0; i < NumKeys; i++)
+		{
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				maxKeyDifference = std::fmax(maxKeyDifference, std::abs(track[i].value[j] - reference[i].value[j]));
+				maxKeyDifference = std::fmax(maxKeyDifference, std::abs(track[i].in[j] - reference[i].in[j]));
+				maxKeyDifference = std::fmax(maxKeyDifference, std::abs(track[i].out[j] - reference[i].out[j]));
+			}
+
+			if (i > 0)
+			{
+				const float* a = track[i - 1].value;
+				const float* b = track[i].value;
+				bSameHemisphere = bSameHemisphere && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] >= 0.0f;
+			}
+		}
+
+		CHECK(maxKeyDifference < 1e-6f);
+		CHECK(bSameHemisphere);
+
+		// Once is enough
+		QuaternionTrack again = track;
+		again.precondition();
+
+		bool bUnchanged = true;
+
+		for (uint32_t i = 0; i < NumKeys; i++)
+		{
+			bUnchanged = bUnchanged && std::memcmp(&again[i], &track[i], sizeof(AnimationKeyFrame<4>)) == 0;
+		}
+
+		CHECK(bUnchanged);
+
+		float maxDifference = 0.0f;
+
+		for (float time = 0.9f; time < 3.2f; time += 0.01f)
+		{
+			maxDifference = std::fmax(maxDifference, maxRotationDifference(track.sample(time, false), reference.sample(time, false)));
+			maxDifference = std::fmax(maxDifference, maxRotationDifference(again.sample(time, false), reference.sample(time, false)));
+		}
+
+		CHECK(maxDifference < 1e-5f);
+	}
+}
+
+TEST(OptimizedClipSamplesSameRotations)
+{
+	using namespace AnimationTrackTestsHelpers;
+
+	const AnimationPose& restPose = Tests::getWomanSkeleton().getRestPose();
+	std::vector<AnimationClip> clips = Tests::getWomanClips();
+
+	// Every other key of a track on the other side, as exporters sometimes write them
+	QuaternionTrack& flippedTrack = clips[7][clips[7].getJointIdAtIndex(1)].getRotationTrack();
+
+	for (uint32_t i = 1; i < flippedTrack.frameCount(); i += 2)
+	{
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			flippedTrack[i].value[j] = -flippedTrack[i].value[j];
+		}
+	}
+
+	for (QuaternionInterpolation quaternionInterpolation : { QuaternionInterpolation::Nlerp, QuaternionInterpolation::FastSlerp, QuaternionInterpolation::Slerp })
+	{
+		float maxDifference = 0.0f;
+
+		for (AnimationClip& clip : clips)
+		{
+			clip.setQuaternionInterpolation(quaternionInterpolation);
+			FastAnimationClip fastClip = optimizeAnimationClip(clip);
+
+			AnimationPose pose = restPose;
+			AnimationPose fastPose = restPose;
+
+			for (float t = 0.0f; t <= 1.0f; t += 0.013f)
+			{
+				float time = clip.getStartTime() + clip.getDuration() * t;
+				clip.sample(pose, time);
+				fastClip.sample(fastPose, time);
+
+				for (uint32_t i = 0; i < pose.getSize(); i++)
+				{
+					maxDifference = std::fmax(maxDifference, maxRotationDifference(pose.getLocalTransform(i).rotation, fastPose.getLocalTransform(i).rotation));
+				}
+			}
+		}
+
+		CHECK(maxDifference < 1e-5f);
+	}
+}
\ No newline at end of file
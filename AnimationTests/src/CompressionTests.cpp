@@ -0,0 +1,91 @@
+#include "TestFramework.h"
+
+#include <Utils/Compression.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace Util;
+
+namespace CompressionTestsHelpers
+{
+	bool roundTrips(const std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> compressed;
+		size_t compressedSize = compressLZ(data.data(), data.size(), compressed);
+
+		std::vector<uint8_t> decompressed(data.size());
+
+		return compressedSize == compressed.size() &&
+			decompressLZ(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) &&
+			decompressed == data;
+	}
+
+	// Runs of repeated bytes and patterns between noise, like constant tracks between moving
+	// ones
+	std::vector<uint8_t> createMixedData(size_t size)
+	{
+		std::vector<uint8_t> data(size);
+		uint32_t state = 12345;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			state = state * 1664525u + 1013904223u;
+
+			switch ((i / 1000) % 3)
+			{
+			case 0:
+				data[i] = 7;
+				break;
+			case 1:
+				data[i] = static_cast<uint8_t>(i % 13);
+				break;
+			default:
+				data[i] = static_cast<uint8_t>(state >> 24);
+				break;
+			}
+		}
+
+		return data;
+	}
+}
+
+TEST(CompressionRoundTrip)
+{
+	using namespace CompressionTestsHelpers;
+
+	CHECK(roundTrips({}));
+	CHECK(roundTrips({ 1 }));
+	CHECK(roundTrips({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 }));
+	CHECK(roundTrips(std::vector<uint8_t>(100000, 42)));
+	CHECK(roundTrips(createMixedData(300000)));
+
+	std::vector<uint8_t> compressed;
+	std::vector<uint8_t> runs(100000, 42);
+	CHECK(compressLZ(runs.data(), runs.size(), compressed) < runs.size() / 50);
+}
+
+TEST(CompressionRejectsCorruptData)
+{
+	using namespace CompressionTestsHelpers;
+
+	std::vector<uint8_t> data = createMixedData(50000);
+	std::vector<uint8_t> compressed;
+	compressLZ(data.data(), data.size(), compressed);
+
+	std::vector<uint8_t> decompressed(data.size() + 1);
+
+	// Exactly the original size is expected
+	CHECK(!decompressLZ(compressed.data(), compressed.size(), decompressed.data(), data.size() - 1));
+	CHECK(!decompressLZ(compressed.data(), compressed.size(), decompressed.data(), data.size() + 1));
+
+	// Cut anywhere the data runs out early
+	for (size_t size : { size_t(0), size_t(1), compressed.size() / 2, compressed.size() - 1 })
+	{
+		CHECK(!decompressLZ(compressed.data(), size, decompressed.data(), data.size()));
+	}
+
+	// A match offset before the start of the output
+	std::vector<uint8_t> badOffset = { 0x14, 'a', 0xff, 0x00, 0x00 };
+	CHECK(!decompressLZ(badOffset.data(), badOffset.size(), decompressed.data(), 100));
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/CrossFadeController.h>
+
+#include <vector>
+
+using namespace Animation;
+
+namespace CrossFadeTestsHelpers
+{
+	// Updates with fades started every few frames, long enough that the ring of fade
+	// targets fills up and the oldest ones are cut short
+	template <typename TAnimationClip>
+	uint64_t countUpdateAllocations(std::vector<TAnimationClip>& clips)
+	{
+		CrossFadeController<TAnimationClip> controller(Tests::getWomanSkeleton());
+		controller.play(&clips[0]);
+
+		uint64_t allocationsBefore = Tests::getNumAllocations();
+
+		for (uint32_t frame = 0; frame < 5000; frame++)
+		{
+			if (frame % 7 == 0)
+			{
+				controller.fadeTo(&clips[(frame / 7) % clips.size()], frame % 2 == 0 ? 0.2f : 1.5f);
+			}
+
+			controller.update(1.0f / 60.0f);
+		}
+
+		return Tests::getNumAllocations() - allocationsBefore;
+	}
+}
+
+TEST(CrossFadeControllerUpdateDoesNotAllocate)
+{
+	CHECK(CrossFadeTestsHelpers::countUpdateAllocations(Tests::getWomanClips()) == 0);
+	CHECK(CrossFadeTestsHelpers::countUpdateAllocations(Tests::getWomanFastClips()) == 0);
+}
+
+TEST(CrossFadeControllerRingFull)
+{
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+
+	CrossFadeController<FastAnimationClip> controller(Tests::getWomanSkeleton());
+	controller.play(&clips[0]);
+
+	for (uint32_t i = 1; i <= CrossFadeController<FastAnimationClip>::MaxFadeTargets + 2; i++)
+	{
+		controller.fadeTo(&clips[i % clips.size()], 10.0f);
+	}
+
+	CHECK(controller.getNumFadeTargets() == CrossFadeController<FastAnimationClip>::MaxFadeTargets);
+
+	// Every fade is done after its time, the last target is the current clip
+	for (uint32_t frame = 0; frame < 11 * 60; frame++)
+	{
+		controller.update(1.0f / 60.0f);
+	}
+
+	CHECK(controller.getNumFadeTargets() == 0);
+	CHECK(controller.getCurrentAnimationClip() == &clips[(CrossFadeController<FastAnimationClip>::MaxFadeTargets + 2) % clips.size()]);
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/CrossFadeController.h>
+#include <Animation/InertializationController.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Animation;
+
+namespace InertializationTestsHelpers
+{
+	const float DeltaTime = 1.0f / 60.0f;
+	const float FadeTime = 1.0f;
+	const uint32_t NumFrames = 30;
+	const uint32_t NumRuns = 20;
+	const int64_t DeltaTicks = 800;
+
+	// Rotations q and -q are the same
+	float maxDifference(const AnimationPose& a, const AnimationPose& b)
+	{
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < a.getSize(); i++)
+		{
+			const Transform& transformA = a.getLocalTransform(i);
+			const Transform& transformB = b.getLocalTransform(i);
+			float sign = dot(transformA.rotation, transformB.rotation) < 0.0f ? -1.0f : 1.0f;
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				difference = std::fmax(difference, std::abs(transformA.position.elements[j] - transformB.position.elements[j]));
+				difference = std::fmax(difference, std::abs(transformA.scale.elements[j] - transformB.scale.elements[j]));
+			}
+
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				difference = std::fmax(difference, std::abs(transformA.rotation.elements[j] - sign * transformB.rotation.elements[j]));
+			}
+		}
+
+		return difference;
+	}
+
+	// Quaternion components only, unlike positions they don't scale with the model
+	float maxRotationDifference(const AnimationPose& a, const AnimationPose& b)
+	{
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < a.getSize(); i++)
+		{
+			const Quaternion& rotationA = a.getLocalTransform(i).rotation;
+			const Quaternion& rotationB = b.getLocalTransform(i).rotation;
+			float sign = dot(rotationA, rotationB) < 0.0f ? -1.0f : 1.0f;
+
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				difference = std::fmax(difference, std::abs(rotationA.elements[j] - sign * rotationB.elements[j]));
+			}
+		}
+
+		return difference;
+	}
+
+	AnimationPose sampleAtTick(const FastAnimationClip& clip, int64_t tick)
+	{
+		AnimationPose pose = Tests::getWomanSkeleton().getRestPose();
+		clip.sampleAtTick(pose, tick);
+
+		return pose;
+	}
+
+	// numTransitions fades one frame apart, all still running afterwards, then the time
+	// of NumFrames updates in the middle of them
+	template <typename TController>
+	double measureOverlappingTransitions(uint32_t numTransitions)
+	{
+		std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+		double best = 0.0;
+
+		for (uint32_t run = 0; run < NumRuns; run++)
+		{
+			TController controller(Tests::getWomanSkeleton());
+			controller.play(&clips[0]);
+			controller.update(DeltaTime);
+
+			for (uint32_t i = 1; i <= numTransitions; i++)
+			{
+				controller.fadeTo(&clips[i % clips.size()], FadeTime);
+				controller.update(DeltaTime);
+			}
+
+			double time = Tests::measure(1, [&]()
+			{
+				for (uint32_t frame = 0; frame < NumFrames; frame++)
+				{
+					controller.update(DeltaTime);
+				}
+			});
+
+			if (run == 0 || time < best)
+			{
+				best = time;
+			}
+		}
+
+		return best / NumFrames;
+	}
+}
+
+TEST(InertializationContinuousAtFade)
+{
+	using namespace InertializationTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+
+	InertializationController<FastAnimationClip> controller(Tests::getWomanSkeleton());
+	controller.play(&clips[0]);
+
+	for (uint32_t frame = 0; frame < 10; frame++)
+	{
+		controller.updateTicks(DeltaTicks);
+	}
+
+	AnimationPose before = controller.getCurrentAnimationPose();
+	AnimationPose targetStart = sampleAtTick(clips[4], clips[4].getStartTick());
+
+	// The offset makes up for the whole jump to the destination at the start of the fade
+	controller.fadeTo(&clips[4], 0.5f);
+	controller.updateTicks(0);
+
+	CHECK(controller.isInertializing());
+	CHECK(controller.getCurrentAnimationClip() == &clips[4]);
+	CHECK(maxRotationDifference(before, targetStart) > 0.5f);
+	CHECK(maxDifference(controller.getCurrentAnimationPose(), before) < 1e-3f);
+
+	// One frame later the pose moved a bit, it didn't jump to the destination
+	controller.updateTicks(DeltaTicks);
+	CHECK(maxRotationDifference(controller.getCurrentAnimationPose(), before) < 0.1f * maxRotationDifference(before, targetStart));
+}
+
+TEST(InertializationMatchesTargetAfterFade)
+{
+	using namespace InertializationTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+
+	InertializationController<FastAnimationClip> controller(Tests::getWomanSkeleton());
+	controller.play(&clips[0]);
+	controller.updateTicks(DeltaTicks);
+	controller.fadeTo(&clips[4], 0.25f);
+
+	int64_t tick = clips[4].getStartTick();
+	uint32_t numFrames = 0;
+
+	while (controller.isInertializing())
+	{
+		controller.updateTicks(DeltaTicks);
+		tick += DeltaTicks;
+		numFrames++;
+	}
+
+	// Done once the fade time passed, from then on it's the destination clip alone
+	CHECK(numFrames == 15);
+	CHECK(maxDifference(controller.getCurrentAnimationPose(), sampleAtTick(clips[4], tick)) == 0.0f);
+
+	for (uint32_t frame = 0; frame < 100; frame++)
+	{
+		controller.updateTicks(DeltaTicks);
+		tick += DeltaTicks;
+	}
+
+	CHECK(maxDifference(controller.getCurrentAnimationPose(), sampleAtTick(clips[4], tick)) == 0.0f);
+}
+
+TEST(InertializationInterruptedContinuous)
+{
+	using namespace InertializationTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+
+	InertializationController<FastAnimationClip> controller(Tests::getWomanSkeleton());
+	controller.play(&clips[0]);
+	controller.updateTicks(DeltaTicks);
+	controller.fadeTo(&clips[4], 1.0f);
+
+	for (uint32_t frame = 0; frame < 10; frame++)
+	{
+		controller.updateTicks(DeltaTicks);
+	}
+
+	// Halfway through the first fade, a second one starts from where the pose is
+	AnimationPose before = controller.getCurrentAnimationPose();
+	float jump = maxRotationDifference(before, sampleAtTick(clips[5], clips[5].getStartTick()));
+
+	controller.fadeTo(&clips[5], 0.5f);
+	controller.updateTicks(0);
+
+	CHECK(maxDifference(controller.getCurrentAnimationPose(), before) < 1e-3f);
+
+	float maxStep = 0.0f;
+	int64_t tick = clips[5].getStartTick();
+
+	for (uint32_t frame = 0; frame < 30; frame++)
+	{
+		before = controller.getCurrentAnimationPose();
+		controller.updateTicks(DeltaTicks);
+		tick += DeltaTicks;
+		maxStep = std::fmax(maxStep, maxRotationDifference(controller.getCurrentAnimationPose(), before));
+	}
+
+	// No frame comes close to the jump the second fade hides
+	CHECK(maxStep < 0.25f * jump);
+	CHECK(!controller.isInertializing());
+	CHECK(maxDifference(controller.getCurrentAnimationPose(), sampleAtTick(clips[5], tick)) == 0.0f);
+}
+
+BENCHMARK(InertializationOverlappingTransitions)
+{
+	using namespace InertializationTestsHelpers;
+
+	spdlog::info("{} clips, {} joints, time per update", Tests::getWomanFastClips().size(), Tests::getWomanSkeleton().getRestPose().getSize());
+
+	for (uint32_t numTransitions : { 1u, 3u, 6u })
+	{
+		double crossFadeTime = measureOverlappingTransitions<CrossFadeController<FastAnimationClip>>(numTransitions);
+		double inertializationTime = measureOverlappingTransitions<InertializationController<FastAnimationClip>>(numTransitions);
+
+		spdlog::info("{} transitions: cross fade {:.4f} ms, inertialization {:.4f} ms", numTransitions, crossFadeTime, inertializationTime);
+	}
+}
\ No newline at end of file
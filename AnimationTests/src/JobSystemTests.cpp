@@ -0,0 +1,299 @@
+#include "TestFramework.h"
+
+#include <Utils/JobSystem.h>
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace Util;
+
+TEST(JobSystemNestedJobs)
+{
+	JobSystem jobSystem(4);
+
+	std::atomic<uint32_t> numGrandchildren(0);
+	std::atomic<bool> bParentFinishedEarly(false);
+
+	Job* root = jobSystem.createJob(nullptr);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		Job* child = jobSystem.createChildJob(root, [&, root](uint32_t)
+		{
+			// Children of a running job keep its parent unfinished as well
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				jobSystem.run(jobSystem.createChildJob(root, [&](uint32_t)
+				{
+					numGrandchildren++;
+				}));
+			}
+
+			if (jobSystem.isFinished(root))
+			{
+				bParentFinishedEarly = true;
+			}
+		});
+
+		jobSystem.run(child);
+	}
+
+	std::atomic<uint32_t> continuationSeen(0);
+	Job* continuation = jobSystem.createJob([&](uint32_t)
+	{
+		continuationSeen = numGrandchildren.load();
+	});
+
+	jobSystem.addContinuation(root, continuation);
+	jobSystem.run(root);
+	jobSystem.wait(root);
+	jobSystem.wait(continuation);
+
+	CHECK(numGrandchildren == 16 * 16);
+	CHECK(!bParentFinishedEarly);
+	CHECK(continuationSeen == 16 * 16);
+}
+
+TEST(JobSystemRecyclingAcrossRingWrapAround)
+{
+	JobSystem jobSystem(4);
+
+	// Enough rounds for the job ring of every worker to wrap around several times, while
+	// finishing jobs race with the allocation of new ones
+	const uint32_t numRounds = 300;
+	const uint32_t numChildren = 16;
+	const uint32_t numGrandchildren = 4;
+	const uint32_t numRootContinuations = 3;
+
+	uint32_t numBadRounds = 0;
+
+	for (uint32_t round = 0; round < numRounds; round++)
+	{
+		std::atomic<uint32_t> numGrandchildrenRun(0);
+		std::atomic<uint32_t> numChildContinuationsRun(0);
+		std::atomic<uint32_t> numRootContinuationsRun(0);
+		std::atomic<uint32_t> numEarlyContinuations(0);
+
+		// Everything of the round is below top, so waiting on it never sees a recycled slot
+		Job* top = jobSystem.createJob(nullptr);
+		Job* root = jobSystem.createChildJob(top, nullptr);
+
+		for (uint32_t i = 0; i < numRootContinuations; i++)
+		{
+			jobSystem.addContinuation(root, jobSystem.createChildJob(top, [&](uint32_t)
+			{
+				if (numGrandchildrenRun != numChildren * numGrandchildren)
+				{
+					numEarlyContinuations++;
+				}
+
+				numRootContinuationsRun++;
+			}));
+		}
+
+		for (uint32_t i = 0; i < numChildren; i++)
+		{
+			Job* child = jobSystem.createChildJob(root, [&, root](uint32_t)
+			{
+				for (uint32_t j = 0; j < numGrandchildren; j++)
+				{
+					jobSystem.run(jobSystem.createChildJob(root, [&](uint32_t)
+					{
+						numGrandchildrenRun++;
+					}));
+				}
+			});
+
+			jobSystem.addContinuation(child, jobSystem.createChildJob(top, [&](uint32_t)
+			{
+				numChildContinuationsRun++;
+			}));
+
+			jobSystem.run(child);
+		}
+
+		jobSystem.run(root);
+		jobSystem.run(top);
+		jobSystem.wait(top);
+
+		bool bGood = numGrandchildrenRun == numChildren * numGrandchildren &&
+			numChildContinuationsRun == numChildren &&
+			numRootContinuationsRun == numRootContinuations &&
+			numEarlyContinuations == 0;
+
+		numBadRounds += bGood ? 0 : 1;
+	}
+
+	CHECK(numBadRounds == 0);
+}
+
+TEST(JobSystemStealing)
+{
+	JobSystem jobSystem(4);
+
+	// Everything is pushed to the queue of worker 0, the others only get work by stealing
+	std::vector<std::atomic<uint32_t>> jobsPerWorker(jobSystem.getNumWorkers());
+
+	for (auto& count : jobsPerWorker)
+	{
+		count = 0;
+	}
+
+	Job* root = jobSystem.createJob(nullptr);
+
+	for (uint32_t i = 0; i < 64; i++)
+	{
+		jobSystem.run(jobSystem.createChildJob(root, [&](uint32_t workerIndex)
+		{
+			jobsPerWorker[workerIndex]++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}));
+	}
+
+	jobSystem.run(root);
+	jobSystem.wait(root);
+
+	uint32_t numBusyWorkers = 0;
+	uint32_t numJobs = 0;
+
+	for (auto& count : jobsPerWorker)
+	{
+		numBusyWorkers += count > 0 ? 1 : 0;
+		numJobs += count;
+	}
+
+	CHECK(numJobs == 64);
+	CHECK(numBusyWorkers > 1);
+}
+
+TEST(JobSystemParallelForMoreBatchesThanJobs)
+{
+	JobSystem jobSystem(4);
+
+	// Batches of one would need three times the job ring
+	uint32_t count = JobSystem::MaxJobsPerWorker * 3;
+	std::vector<std::atomic<uint32_t>> visits(count);
+
+	for (auto& visit : visits)
+	{
+		visit = 0;
+	}
+
+	jobSystem.parallelFor(count, 1, [&](uint32_t begin, uint32_t end, uint32_t)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			visits[i]++;
+		}
+	});
+
+	bool bAllOnce = true;
+
+	for (auto& visit : visits)
+	{
+		bAllOnce = bAllOnce && visit == 1;
+	}
+
+	CHECK(bAllOnce);
+}
+
+TEST(JobSystemNestedParallelFor)
+{
+	JobSystem jobSystem(4);
+
+	std::atomic<uint64_t> sum(0);
+
+	jobSystem.parallelFor(64, 1, [&](uint32_t outerBegin, uint32_t outerEnd, uint32_t)
+	{
+		for (uint32_t outer = outerBegin; outer < outerEnd; outer++)
+		{
+			// Every outer batch may wait inside another one, 64 levels of 17 jobs fit
+			jobSystem.parallelFor(1000, 64, [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				uint64_t local = 0;
+
+				for (uint32_t i = begin; i < end; i++)
+				{
+					local += i;
+				}
+
+				sum += local;
+			});
+		}
+	});
+
+	CHECK(sum == 64ull * (999ull * 1000ull / 2));
+}
+
+TEST(JobSystemWorkerIndex)
+{
+	JobSystem jobSystem(4);
+	JobSystem otherJobSystem(2);
+
+	CHECK(jobSystem.getWorkerIndex() == 0);
+	CHECK(otherJobSystem.getWorkerIndex() == 0);
+
+	std::atomic<uint32_t> numMismatches(0);
+
+	jobSystem.parallelFor(256, 1, [&](uint32_t, uint32_t, uint32_t workerIndex)
+	{
+		// Worker threads of one system are strangers to the other one
+		bool bMatches = jobSystem.getWorkerIndex() == workerIndex;
+		bool bOther = workerIndex == 0 || otherJobSystem.getWorkerIndex() == JobSystem::InvalidWorkerIndex;
+
+		if (!bMatches || !bOther)
+		{
+			numMismatches++;
+		}
+	});
+
+	CHECK(numMismatches == 0);
+
+	uint32_t foreignIndex = 0;
+	std::thread foreign([&]() { foreignIndex = jobSystem.getWorkerIndex(); });
+	foreign.join();
+
+	CHECK(foreignIndex == JobSystem::InvalidWorkerIndex);
+}
+
+BENCHMARK(JobSystemScaling)
+{
+	const uint32_t count = 1 << 16;
+	std::vector<float> results(count);
+	double baseTime = 0.0;
+
+	for (uint32_t numWorkers : { 1u, 2u, 4u, 8u })
+	{
+		JobSystem jobSystem(numWorkers);
+
+		double time = Tests::measure(10, [&]()
+		{
+			jobSystem.parallelFor(count, 256, [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					float value = static_cast<float>(i);
+
+					for (uint32_t j = 0; j < 64; j++)
+					{
+						value = std::sqrt(value * 1.0001f + 1.0f);
+					}
+
+					results[i] = value;
+				}
+			});
+		});
+
+		if (numWorkers == 1)
+		{
+			baseTime = time;
+		}
+
+		spdlog::info("{} workers: {:.3f} ms, {:.2f}x", numWorkers, time, baseTime / time);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "TestFramework.h"
+
+#include <Math/Matrix3x4.h>
+#include <Math/Matrix4.h>
+#include <Math/Transform.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Math;
+
+namespace Matrix3x4TestsHelpers
+{
+	Transform createTransform(float seed)
+	{
+		return Transform(Vector3(seed, -2.0f * seed, 0.5f),
+						 angleAxis(seed, normalized(Vector3(1.0f, seed, -0.3f))),
+						 Vector3(1.0f + 0.1f * seed, 0.9f, 1.2f));
+	}
+
+	float maxDifference(const Matrix4& a, const Matrix4& b)
+	{
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			difference = std::fmax(difference, std::abs(a.elements[i] - b.elements[i]));
+		}
+
+		return difference;
+	}
+
+	// What AffineSkinning.vert does with the uploaded palette, vec4 rows three per joint
+	Vector3 skinPoint(const float* rows, const uint32_t joints[4], const float weights[4], const Vector3& point)
+	{
+		float blended[12] = {};
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			for (uint32_t j = 0; j < 12; j++)
+			{
+				blended[j] += rows[joints[i] * 12 + j] * weights[i];
+			}
+		}
+
+		return Vector3(blended[0] * point.x + blended[1] * point.y + blended[2] * point.z + blended[3],
+					   blended[4] * point.x + blended[5] * point.y + blended[6] * point.z + blended[7],
+					   blended[8] * point.x + blended[9] * point.y + blended[10] * point.z + blended[11]);
+	}
+}
+
+TEST(Matrix3x4MultiplyAffine)
+{
+	using namespace Matrix3x4TestsHelpers;
+
+	float difference = 0.0f;
+
+	for (float seed = 0.1f; seed < 3.0f; seed += 0.37f)
+	{
+		Matrix4 a = transformToMatrix4(createTransform(seed));
+		Matrix4 b = transformToMatrix4(createTransform(1.7f - seed));
+
+		difference = std::fmax(difference, maxDifference(multiplyAffine(a, toMatrix3x4(b)), a * b));
+	}
+
+	CHECK(difference < 1e-4f);
+}
+
+TEST(Matrix3x4PackPaletteLayout)
+{
+	using namespace Matrix3x4TestsHelpers;
+
+	// Three vec4 rows per joint, the array stride of std140 and std430
+	CHECK(sizeof(Matrix3x4) == 12 * sizeof(float));
+
+	std::vector<Matrix4> palette;
+
+	for (float seed = 0.1f; seed < 3.0f; seed += 0.37f)
+	{
+		palette.push_back(transformToMatrix4(createTransform(seed)));
+	}
+
+	uint32_t numJoints = static_cast<uint32_t>(palette.size());
+	std::vector<Matrix3x4> packed(numJoints);
+	packPalette(palette.data(), numJoints, packed.data());
+
+	const float* rows = &packed[0].elements[0];
+	bool bRowsMatch = true;
+
+	for (uint32_t joint = 0; joint < numJoints; joint++)
+	{
+		for (uint32_t row = 0; row < 3; row++)
+		{
+			for (uint32_t column = 0; column < 4; column++)
+			{
+				// Matrix4 is column major
+				bRowsMatch = bRowsMatch && rows[joint * 12 + row * 4 + column] == palette[joint].elements[column * 4 + row];
+			}
+		}
+	}
+
+	CHECK(bRowsMatch);
+}
+
+TEST(Matrix3x4PackPaletteInverseBindPose)
+{
+	using namespace Matrix3x4TestsHelpers;
+
+	std::vector<Matrix4> pose;
+	std::vector<Matrix3x4> inverseBindPose;
+
+	for (float seed = 0.1f; seed < 3.0f; seed += 0.37f)
+	{
+		pose.push_back(transformToMatrix4(createTransform(seed)));
+		inverseBindPose.push_back(inverse(toMatrix3x4(transformToMatrix4(createTransform(2.3f - seed)))));
+	}
+
+	uint32_t numJoints = static_cast<uint32_t>(pose.size());
+	std::vector<Matrix3x4> packed(numJoints);
+	packPalette(pose.data(), inverseBindPose.data(), numJoints, packed.data());
+
+	float difference = 0.0f;
+
+	for (uint32_t i = 0; i < numJoints; i++)
+	{
+		difference = std::fmax(difference, maxDifference(toMatrix4(packed[i]), pose[i] * toMatrix4(inverseBindPose[i])));
+	}
+
+	CHECK(difference < 1e-4f);
+
+	// Blending the rows as the shader does matches blending the full skinning matrices
+	const uint32_t joints[4] = { 0, 3, 5, numJoints - 1 };
+	const float weights[4] = { 0.4f, 0.3f, 0.2f, 0.1f };
+	Vector3 point(0.3f, 1.5f, -0.7f);
+
+	Matrix4 skin = (pose[joints[0]] * toMatrix4(inverseBindPose[joints[0]])) * weights[0] +
+				   (pose[joints[1]] * toMatrix4(inverseBindPose[joints[1]])) * weights[1] +
+				   (pose[joints[2]] * toMatrix4(inverseBindPose[joints[2]])) * weights[2] +
+				   (pose[joints[3]] * toMatrix4(inverseBindPose[joints[3]])) * weights[3];
+
+	CHECK(length(skinPoint(&packed[0].elements[0], joints, weights, point) - transformPoint(skin, point)) < 1e-4f);
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/PoseCache.h>
+#include <Utils/JobSystem.h>
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+using namespace Animation;
+
+namespace PoseCacheTestsHelpers
+{
+	const float TimeQuantum = 1.0f / 60.0f;
+
+	bool equal(const AnimationPose& a, const AnimationPose& b)
+	{
+		if (a.getSize() != b.getSize())
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < a.getSize(); i++)
+		{
+			const Transform& transformA = a.getLocalTransform(i);
+			const Transform& transformB = b.getLocalTransform(i);
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				if (transformA.position.elements[j] != transformB.position.elements[j] || transformA.scale.elements[j] != transformB.scale.elements[j])
+				{
+					return false;
+				}
+			}
+
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				if (transformA.rotation.elements[j] != transformB.rotation.elements[j])
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// What the cache hands out for a request at time, the clip sampled at the quantized time
+	AnimationPose sampleQuantized(const FastAnimationClip& clip, float time, const std::vector<bool>* activeJoints = nullptr)
+	{
+		AnimationPose pose = Tests::getWomanSkeleton().getRestPose();
+		float quantized = std::floor(clip.adjustTimeToFitRange(time) / TimeQuantum + 0.5f) * TimeQuantum;
+
+		if (activeJoints != nullptr)
+		{
+			clip.sample(pose, quantized, *activeJoints);
+		}
+		else
+		{
+			clip.sample(pose, quantized);
+		}
+
+		return pose;
+	}
+}
+
+TEST(PoseCacheHitsAndMisses)
+{
+	using namespace PoseCacheTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const AnimationPose& restPose = Tests::getWomanSkeleton().getRestPose();
+
+	PoseCache<FastAnimationClip> poseCache(16, TimeQuantum);
+	AnimationPose pose = restPose;
+
+	// Every other joint, a different key than the full pose
+	std::vector<bool> activeJoints(restPose.getSize());
+
+	for (uint32_t i = 0; i < activeJoints.size(); i++)
+	{
+		activeJoints[i] = i % 2 == 0;
+	}
+
+	poseCache.sample(clips[7], pose, 0.5f);
+	CHECK(poseCache.getNumHits() == 0 && poseCache.getNumMisses() == 1);
+	CHECK(equal(pose, sampleQuantized(clips[7], 0.5f)));
+
+	// Within the same quantum
+	pose = restPose;
+	float time = poseCache.sample(clips[7], pose, 0.5f + TimeQuantum * 0.3f);
+	CHECK(poseCache.getNumHits() == 1 && poseCache.getNumMisses() == 1);
+	CHECK(equal(pose, sampleQuantized(clips[7], 0.5f)));
+	CHECK(time == clips[7].adjustTimeToFitRange(0.5f + TimeQuantum * 0.3f));
+
+	// Another tick, another clip and another mask are all new entries
+	pose = restPose;
+	poseCache.sample(clips[7], pose, 0.5f + TimeQuantum);
+	CHECK(equal(pose, sampleQuantized(clips[7], 0.5f + TimeQuantum)));
+
+	pose = restPose;
+	poseCache.sample(clips[0], pose, 0.5f);
+	CHECK(equal(pose, sampleQuantized(clips[0], 0.5f)));
+
+	pose = restPose;
+	poseCache.sample(clips[7], pose, 0.5f, &activeJoints);
+	CHECK(equal(pose, sampleQuantized(clips[7], 0.5f, &activeJoints)));
+
+	CHECK(poseCache.getNumHits() == 1 && poseCache.getNumMisses() == 4);
+
+	// Times that wrap onto an entry find it
+	pose = restPose;
+	poseCache.sample(clips[7], pose, 0.5f + clips[7].getDuration());
+	CHECK(poseCache.getNumHits() == 2 && poseCache.getNumMisses() == 4);
+
+	// A new frame starts empty
+	poseCache.beginFrame();
+	pose = restPose;
+	poseCache.sample(clips[7], pose, 0.5f);
+	CHECK(poseCache.getNumHits() == 2 && poseCache.getNumMisses() == 5);
+	CHECK(poseCache.getHitRate() == 2.0f / 7.0f);
+
+	poseCache.resetStats();
+	CHECK(poseCache.getNumHits() == 0 && poseCache.getNumMisses() == 0);
+}
+
+TEST(PoseCacheFull)
+{
+	using namespace PoseCacheTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const AnimationPose& restPose = Tests::getWomanSkeleton().getRestPose();
+
+	PoseCache<FastAnimationClip> poseCache(2, TimeQuantum);
+	AnimationPose pose = restPose;
+
+	poseCache.sample(clips[7], pose, 0.1f);
+	poseCache.sample(clips[7], pose, 0.2f);
+
+	// No room for a third entry, the clip is sampled at the exact time
+	float time = 0.3f + TimeQuantum * 0.3f;
+	pose = restPose;
+	poseCache.sample(clips[7], pose, time);
+
+	AnimationPose expected = restPose;
+	clips[7].sample(expected, time);
+
+	CHECK(equal(pose, expected));
+	CHECK(poseCache.getNumHits() == 0 && poseCache.getNumMisses() == 3);
+
+	// The entries that made it are still shared
+	pose = restPose;
+	poseCache.sample(clips[7], pose, 0.2f);
+	CHECK(equal(pose, sampleQuantized(clips[7], 0.2f)));
+	CHECK(poseCache.getNumHits() == 1);
+
+	// Without capacity everything is sampled directly
+	poseCache.setCapacity(0);
+	pose = restPose;
+	poseCache.sample(clips[7], pose, time);
+	CHECK(equal(pose, expected));
+}
+
+TEST(PoseCacheConcurrentLookups)
+{
+	using namespace PoseCacheTestsHelpers;
+
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const AnimationPose& restPose = Tests::getWomanSkeleton().getRestPose();
+
+	const uint32_t clipIndices[] = { 0, 4, 7 };
+	const uint32_t numTimes = 8;
+	const uint32_t numRequests = 4096;
+
+	// Every worker compares with poses sampled up front, so they only read the clips
+	std::vector<AnimationPose> expected;
+
+	for (uint32_t clip : clipIndices)
+	{
+		for (uint32_t i = 0; i < numTimes; i++)
+		{
+			expected.push_back(sampleQuantized(clips[clip], i * TimeQuantum));
+		}
+	}
+
+	Util::JobSystem jobSystem(4);
+	PoseCache<FastAnimationClip> poseCache(64, TimeQuantum);
+	std::atomic<uint32_t> numMismatches(0);
+
+	for (uint32_t frame = 0; frame < 4; frame++)
+	{
+		poseCache.beginFrame();
+		poseCache.resetStats();
+
+		jobSystem.parallelFor(numRequests, 16, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+			AnimationPose pose;
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				// Requests for one key are spread over every batch
+				uint32_t key = (i * 7 + frame) % (3 * numTimes);
+				const FastAnimationClip& clip = clips[clipIndices[key / numTimes]];
+
+				pose = restPose;
+				poseCache.sample(clip, pose, (key % numTimes) * TimeQuantum + TimeQuantum * 0.2f);
+
+				if (!equal(pose, expected[key]))
+				{
+					numMismatches++;
+				}
+			}
+		});
+
+		CHECK(poseCache.getNumMisses() == 3 * numTimes);
+		CHECK(poseCache.getNumHits() == numRequests - 3 * numTimes);
+	}
+
+	CHECK(numMismatches == 0);
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "TestFramework.h"
+
+#include <Math/Quaternion.h>
+#include <Math/SIMD.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace Math;
+
+namespace QuaternionTestsHelpers
+{
+	const uint32_t NumPairs = 100000;
+
+	// Deterministic in [0, 1)
+	float random(uint32_t& state)
+	{
+		state = state * 1664525u + 1013904223u;
+		return static_cast<float>(state >> 8) / 16777216.0f;
+	}
+
+	Quaternion randomRotation(uint32_t& state)
+	{
+		Vector3 axis(random(state) * 2.0f - 1.0f, random(state) * 2.0f - 1.0f, random(state) * 2.0f - 1.0f);
+
+		if (dot(axis, axis) < 1e-4f)
+		{
+			axis = Vector3::Y;
+		}
+
+		return angleAxis(random(state) * 2.0f * 3.14159265f, axis);
+	}
+
+	// Half of the pairs are uniformly random, the others keys of an animation, a rotation
+	// and a small turn of it
+	void createPairs(std::vector<Quaternion>& outFrom, std::vector<Quaternion>& outTo, std::vector<float>& outT)
+	{
+		uint32_t state = 12345;
+
+		outFrom.resize(NumPairs);
+		outTo.resize(NumPairs);
+		outT.resize(NumPairs);
+
+		for (uint32_t i = 0; i < NumPairs; i++)
+		{
+			outFrom[i] = randomRotation(state);
+
+			if (i % 2 == 0)
+			{
+				outTo[i] = randomRotation(state);
+			}
+			else
+			{
+				Quaternion turn = angleAxis(random(state) * 0.5f, Vector3(random(state), 1.0f, random(state)));
+				outTo[i] = normalized(outFrom[i] * turn);
+			}
+
+			outT[i] = random(state);
+		}
+	}
+
+	// Exact slerp along the shorter arc, in double and without quaternion products
+	void referenceSlerp(const Quaternion& from, const Quaternion& to, float t, double* out)
+	{
+		double cosine = 0.0;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			cosine += static_cast<double>(from.elements[i]) * to.elements[i];
+		}
+
+		double sign = cosine < 0.0 ? -1.0 : 1.0;
+		double angle = std::acos(std::fmin(std::abs(cosine), 1.0));
+		double sine = std::sin(angle);
+		double a = sine > 1e-9 ? std::sin((1.0 - t) * angle) / sine : 1.0 - t;
+		double b = sine > 1e-9 ? std::sin(t * angle) / sine : t;
+		double length = 0.0;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			out[i] = from.elements[i] * a + to.elements[i] * b * sign;
+			length += out[i] * out[i];
+		}
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			out[i] /= std::sqrt(length);
+		}
+	}
+
+	// Angle of the rotation between two, from the chord so it stays accurate for small
+	// angles where acos of the dot product doesn't
+	double angleBetween(const Quaternion& a, const double* b)
+	{
+		double cosine = 0.0;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			cosine += a.elements[i] * b[i];
+		}
+
+		double sign = cosine < 0.0 ? -1.0 : 1.0;
+		double chord = 0.0;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			double difference = a.elements[i] - sign * b[i];
+			chord += difference * difference;
+		}
+
+		return 4.0 * std::asin(std::fmin(std::sqrt(chord) * 0.5, 1.0));
+	}
+
+	float maxComponentDifference(const Quaternion& a, const Quaternion& b)
+	{
+		float difference = 0.0f;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			difference = std::fmax(difference, std::abs(a.elements[i] - b.elements[i]));
+		}
+
+		return difference;
+	}
+}
+
+TEST(QuaternionFastSlerpWithinBound)
+{
+	using namespace QuaternionTestsHelpers;
+
+	std::vector<Quaternion> from;
+	std::vector<Quaternion> to;
+	std::vector<float> t;
+	createPairs(from, to, t);
+
+	double maxFastSlerpError = 0.0;
+	double maxSlerpError = 0.0;
+
+	for (uint32_t i = 0; i < NumPairs; i++)
+	{
+		double expected[4];
+		referenceSlerp(from[i], to[i], t[i], expected);
+
+		// slerp follows the arc it's given, fastSlerp the shorter one
+		Quaternion shorterTo = dot(from[i], to[i]) < 0.0f ? -to[i] : to[i];
+
+		maxFastSlerpError = std::fmax(maxFastSlerpError, angleBetween(fastSlerp(from[i], to[i], t[i]), expected));
+		maxSlerpError = std::fmax(maxSlerpError, angleBetween(slerp(from[i], shorterTo, t[i]), expected));
+	}
+
+	// The bound documented on QuaternionInterpolation::FastSlerp. slerp takes the angle of
+	// small turns from acos in float, so it isn't exact either.
+	CHECK(maxFastSlerpError <= 8e-4);
+	CHECK(maxSlerpError <= 3e-4);
+}
+
+TEST(QuaternionFastSlerpNMatchesFastSlerp)
+{
+	using namespace QuaternionTestsHelpers;
+
+	std::vector<Quaternion> from;
+	std::vector<Quaternion> to;
+	std::vector<float> t;
+	createPairs(from, to, t);
+
+	std::vector<Quaternion> batched(NumPairs);
+	std::vector<Quaternion> batchedPerPair(NumPairs);
+
+	fastSlerpN(from.data(), to.data(), 0.3f, batched.data(), NumPairs);
+	fastSlerpN(from.data(), to.data(), t.data(), batchedPerPair.data(), NumPairs);
+
+	float difference = 0.0f;
+
+	// Only the order the dot products are summed in differs
+	for (uint32_t i = 0; i < NumPairs; i++)
+	{
+		difference = std::fmax(difference, maxComponentDifference(batched[i], fastSlerp(from[i], to[i], 0.3f)));
+		difference = std::fmax(difference, maxComponentDifference(batchedPerPair[i], fastSlerp(from[i], to[i], t[i])));
+	}
+
+	CHECK(difference < 1e-6f);
+}
+
+TEST(QuaternionSlerpProductOrder)
+{
+	using namespace QuaternionTestsHelpers;
+
+	// Rotations that don't commute, where the side the delta is composed on matters
+	Quaternion from = angleAxis(1.2f, Vector3::X);
+	Quaternion to = normalized(angleAxis(0.9f, Vector3::Y) * angleAxis(0.4f, Vector3::Z));
+
+	CHECK(maxComponentDifference(slerp(from, to, 0.0f), from) < 1e-6f);
+	CHECK(maxComponentDifference(slerp(from, to, 1.0f), to) < 1e-6f);
+
+	for (float t : { 0.25f, 0.5f, 0.75f })
+	{
+		double expected[4];
+		referenceSlerp(from, to, t, expected);
+
+		CHECK(angleBetween(slerp(from, to, t), expected) < 1e-5);
+	}
+}
\ No newline at end of file
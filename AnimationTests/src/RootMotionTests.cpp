@@ -0,0 +1,216 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/RootMotion.h>
+#include <Math/Transform.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Animation;
+
+namespace RootMotionTestsHelpers
+{
+	const uint32_t RootJointId = 1;
+	const float FrameRate = 30.0f;
+
+	// Walking with the armature carried forward and turned, the hips face about 1.2
+	// radians and not yaw 0 on the first frame
+	AnimationClip createMovingClip()
+	{
+		AnimationClip clip = Tests::getWomanClips()[7];
+		float start = clip.getStartTime();
+		float end = start + clip.getDuration();
+
+		AnimationTransformTrack& armature = clip[0];
+		VectorTrack& positionTrack = armature.getPositionTrack();
+		QuaternionTrack& rotationTrack = armature.getRotationTrack();
+
+		positionTrack.resize(2);
+		positionTrack.setInterpolation(Interpolation::Linear);
+		rotationTrack.resize(2);
+		rotationTrack.setInterpolation(Interpolation::Linear);
+
+		Vector3 positions[] = { Vector3(0.5f, 0.0f, -0.25f), Vector3(1.5f, 0.0f, 1.75f) };
+		Quaternion rotations[] = { angleAxis(1.0f, Vector3::Y), angleAxis(1.5f, Vector3::Y) };
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			positionTrack[i] = AnimationKeyFrame<3>();
+			positionTrack[i].time = i == 0 ? start : end;
+			positionTrack[i].value[0] = positions[i].x;
+			positionTrack[i].value[1] = positions[i].y;
+			positionTrack[i].value[2] = positions[i].z;
+
+			rotationTrack[i] = AnimationKeyFrame<4>();
+			rotationTrack[i].time = i == 0 ? start : end;
+			rotationTrack[i].value[0] = rotations[i].x;
+			rotationTrack[i].value[1] = rotations[i].y;
+			rotationTrack[i].value[2] = rotations[i].z;
+			rotationTrack[i].value[3] = rotations[i].w;
+		}
+
+		positionTrack.updateHermiteSegments();
+		rotationTrack.updateHermiteSegments();
+
+		return clip;
+	}
+
+	// Motion from a to b followed by motion from b to c, in the frame of a
+	RootMotionDelta compose(const RootMotionDelta& a, const RootMotionDelta& b)
+	{
+		RootMotionDelta result;
+		result.translation = a.translation + a.getRotation() * b.translation;
+		result.yaw = a.yaw + b.yaw;
+
+		return result;
+	}
+
+	float difference(const RootMotionDelta& a, const RootMotionDelta& b)
+	{
+		float result = std::abs(a.yaw - b.yaw);
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			result = std::fmax(result, std::abs(a.translation.elements[i] - b.translation.elements[i]));
+		}
+
+		return result;
+	}
+
+	float rotationDifference(const Quaternion& a, const Quaternion& b)
+	{
+		float result = 0.0f;
+		float sign = dot(a, b) < 0.0f ? -1.0f : 1.0f;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			result = std::fmax(result, std::abs(a.elements[i] - sign * b.elements[i]));
+		}
+
+		return result;
+	}
+}
+
+TEST(RootMotionExtractKeepsTrajectory)
+{
+	using namespace RootMotionTestsHelpers;
+
+	const AnimationPose& restPose = Tests::getWomanSkeleton().getRestPose();
+	AnimationClip original = createMovingClip();
+	AnimationClip inPlace = original;
+
+	RootMotionTrack rootMotion;
+	CHECK(rootMotion.extract(inPlace, restPose, RootJointId, FrameRate));
+	CHECK(rootMotion.getNumFrames() == static_cast<uint32_t>(std::ceil(original.getDuration() * FrameRate)) + 1);
+
+	Transform first = original.sampleGlobalTransform(restPose, original.getStartTime(), RootJointId);
+	float initialYaw = 2.0f * std::atan2(first.rotation.y, first.rotation.w);
+	Quaternion initialRotation = angleAxis(initialYaw, Vector3::Y);
+
+	float maxPositionDifference = 0.0f;
+	float maxRotationDifference = 0.0f;
+	float maxDrift = 0.0f;
+
+	// The tracks are resampled, on the frames they match the clip. The last frame is left
+	// out, the looping clip wraps back to its first one there.
+	for (uint32_t frame = 0; frame + 1 < rootMotion.getNumFrames(); frame++)
+	{
+		float time = original.getStartTime() + original.getDuration() * frame / (rootMotion.getNumFrames() - 1);
+
+		Transform expected = original.sampleGlobalTransform(restPose, time, RootJointId);
+		Transform root = inPlace.sampleGlobalTransform(restPose, time, RootJointId);
+		RootMotionDelta trajectory = rootMotion.getTrajectory(time);
+
+		maxDrift = std::fmax(maxDrift, std::abs(root.position.x - first.position.x));
+		maxDrift = std::fmax(maxDrift, std::abs(root.position.z - first.position.z));
+
+		// An agent starting at the root, facing where it faces, carries it along the clip
+		Vector3 position = first.position + initialRotation * trajectory.translation;
+		position.y = root.position.y;
+		Quaternion rotation = root.rotation * trajectory.getRotation();
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			maxPositionDifference = std::fmax(maxPositionDifference, std::abs(position.elements[i] - expected.position.elements[i]));
+		}
+
+		maxRotationDifference = std::fmax(maxRotationDifference, rotationDifference(rotation, expected.rotation));
+	}
+
+	CHECK(std::abs(initialYaw) > 1.0f);
+	CHECK(maxDrift < 1e-5f);
+	CHECK(maxPositionDifference < 1e-4f);
+	CHECK(maxRotationDifference < 1e-4f);
+
+	// The clip moved, forward in the frame it started in
+	RootMotionDelta loop = rootMotion.getTrajectory(original.getStartTime() + original.getDuration());
+	CHECK(std::abs(loop.yaw - 0.5f) < 0.05f);
+	CHECK(loop.translation.z > 1.0f);
+}
+
+TEST(RootMotionDeltaOverLoops)
+{
+	using namespace RootMotionTestsHelpers;
+
+	AnimationClip clip = createMovingClip();
+	RootMotionTrack rootMotion;
+	CHECK(rootMotion.extract(clip, Tests::getWomanSkeleton().getRestPose(), RootJointId, FrameRate));
+	CHECK(rootMotion.isLooping());
+
+	float start = rootMotion.getStartTime();
+	float duration = rootMotion.getDuration();
+
+	// Whole loops are the motion of one loop repeated
+	RootMotionDelta loop = rootMotion.getRootMotionDelta(start, start + duration);
+	RootMotionDelta threeLoops = compose(loop, compose(loop, loop));
+	CHECK(difference(rootMotion.getRootMotionDelta(start, start + 3.0f * duration), threeLoops) < 1e-4f);
+
+	// Spans over several loops, some starting before the clip, are the sum of short steps
+	for (float time0 : { start + 0.3f * duration, start - 2.3f * duration })
+	{
+		float time1 = time0 + 3.55f * duration;
+		uint32_t numSteps = 71;
+		RootMotionDelta steps;
+
+		for (uint32_t i = 0; i < numSteps; i++)
+		{
+			float from = time0 + (time1 - time0) * i / numSteps;
+			float to = time0 + (time1 - time0) * (i + 1) / numSteps;
+			steps = compose(steps, rootMotion.getRootMotionDelta(from, to));
+		}
+
+		RootMotionDelta delta = rootMotion.getRootMotionDelta(time0, time1);
+		CHECK(difference(delta, steps) < 1e-3f);
+
+		// Going back undoes going forward
+		RootMotionDelta back = rootMotion.getRootMotionDelta(time1, time0);
+		CHECK(difference(compose(delta, back), RootMotionDelta()) < 1e-3f);
+	}
+
+	CHECK(difference(rootMotion.getRootMotionDelta(start + 0.4f, start + 0.4f), RootMotionDelta()) < 1e-6f);
+}
+
+TEST(RootMotionDeltaClampsWithoutLooping)
+{
+	using namespace RootMotionTestsHelpers;
+
+	AnimationClip clip = createMovingClip();
+	clip.setLooping(false);
+
+	RootMotionTrack rootMotion;
+	CHECK(rootMotion.extract(clip, Tests::getWomanSkeleton().getRestPose(), RootJointId, FrameRate));
+	CHECK(!rootMotion.isLooping());
+
+	float start = rootMotion.getStartTime();
+	float end = start + rootMotion.getDuration();
+
+	RootMotionDelta whole = rootMotion.getRootMotionDelta(start, end);
+	CHECK(whole.translation.z > 1.0f);
+
+	// Past either end the root stands still
+	CHECK(difference(rootMotion.getRootMotionDelta(start - 2.0f, end + 5.0f), whole) < 1e-6f);
+	CHECK(difference(rootMotion.getRootMotionDelta(end, end + 3.0f), RootMotionDelta()) < 1e-6f);
+	CHECK(difference(rootMotion.getRootMotionDelta(start - 3.0f, start), RootMotionDelta()) < 1e-6f);
+	CHECK(difference(rootMotion.getTrajectory(end + 1.0f), whole) < 1e-6f);
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "TestFramework.h"
+
+#include <Math/SIMD.h>
+#include <Math/Matrix4.h>
+#include <Math/Quaternion.h>
+#include <Math/Transform.h>
+#include <Math/Vector3.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Math;
+
+namespace SIMDTestsHelpers
+{
+	const uint32_t NumValues = 4096;
+	const uint32_t NumRuns = 50;
+
+	// Two of everything per index, the SIMD types loaded from the regular ones
+	struct Inputs
+	{
+		std::vector<Vector3> vectors[2];
+		std::vector<Quaternion> quaternions[2];
+		std::vector<Matrix4> matrices[2];
+		std::vector<Transform> transforms[2];
+
+		std::vector<Vector3A> vectorsA[2];
+		std::vector<QuaternionA> quaternionsA[2];
+		std::vector<Matrix4A> matricesA[2];
+		std::vector<TransformA> transformsA[2];
+	};
+
+	const Inputs& getInputs()
+	{
+		static Inputs inputs;
+
+		if (!inputs.vectors[0].empty())
+		{
+			return inputs;
+		}
+
+		for (uint32_t side = 0; side < 2; side++)
+		{
+			for (uint32_t i = 0; i < NumValues; i++)
+			{
+				float seed = static_cast<float>(i * 2 + side) * 0.37f;
+
+				Vector3 vector(std::sin(seed) * 3.0f, std::cos(seed * 1.3f) * 2.0f, std::sin(seed * 0.7f + 1.0f));
+				Quaternion rotation = angleAxis(seed, normalized(Vector3(std::cos(seed), 1.0f, std::sin(seed * 2.1f))));
+				Transform transform(vector, rotation, Vector3(1.0f + 0.1f * std::sin(seed), 1.0f, 0.9f));
+
+				inputs.vectors[side].push_back(vector);
+				inputs.quaternions[side].push_back(rotation);
+				inputs.matrices[side].push_back(transformToMatrix4(transform));
+				inputs.transforms[side].push_back(transform);
+
+				inputs.vectorsA[side].push_back(load(vector));
+				inputs.quaternionsA[side].push_back(load(rotation));
+				inputs.matricesA[side].push_back(load(inputs.matrices[side].back()));
+				inputs.transformsA[side].push_back(load(transform));
+			}
+		}
+
+		return inputs;
+	}
+
+	float difference(const Vector3& a, const Vector3& b)
+	{
+		return length(a - b);
+	}
+
+	float difference(const Quaternion& a, const Quaternion& b)
+	{
+		return std::fmax(std::fmax(std::abs(a.x - b.x), std::abs(a.y - b.y)), std::fmax(std::abs(a.z - b.z), std::abs(a.w - b.w)));
+	}
+
+	float difference(const Matrix4& a, const Matrix4& b)
+	{
+		float result = 0.0f;
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			result = std::fmax(result, std::abs(a.elements[i] - b.elements[i]));
+		}
+
+		return result;
+	}
+
+	float difference(const Transform& a, const Transform& b)
+	{
+		return std::fmax(std::fmax(difference(a.position, b.position), difference(a.rotation, b.rotation)), difference(a.scale, b.scale));
+	}
+
+	template <typename TScalar, typename TSIMD>
+	void compare(const char* name, const TScalar& scalar, const TSIMD& simd)
+	{
+		double scalarTime = Tests::measure(NumRuns, scalar);
+		double simdTime = Tests::measure(NumRuns, simd);
+
+		spdlog::info("{:<26} scalar {:7.4f} ms, SIMD {:7.4f} ms, {:.2f}x", name, scalarTime, simdTime, scalarTime / simdTime);
+	}
+}
+
+TEST(SIMDMatchesScalar)
+{
+	using namespace SIMDTestsHelpers;
+
+	const Inputs& inputs = getInputs();
+	float maxDifference = 0.0f;
+
+	for (uint32_t i = 0; i < NumValues; i++)
+	{
+		const Vector3& a = inputs.vectors[0][i];
+		const Vector3& b = inputs.vectors[1][i];
+		const Vector3A& aA = inputs.vectorsA[0][i];
+		const Vector3A& bA = inputs.vectorsA[1][i];
+
+		maxDifference = std::fmax(maxDifference, difference(store(aA + bA), a + b));
+		maxDifference = std::fmax(maxDifference, std::abs(dot(aA, bA) - dot(a, b)));
+		maxDifference = std::fmax(maxDifference, difference(store(cross(aA, bA)), cross(a, b)));
+		maxDifference = std::fmax(maxDifference, difference(store(normalized(aA)), normalized(a)));
+		maxDifference = std::fmax(maxDifference, difference(store(lerp(aA, bA, 0.3f)), lerp(a, b, 0.3f)));
+
+		const Quaternion& p = inputs.quaternions[0][i];
+		const Quaternion& q = inputs.quaternions[1][i];
+		const QuaternionA& pA = inputs.quaternionsA[0][i];
+		const QuaternionA& qA = inputs.quaternionsA[1][i];
+
+		// Same order as Quaternion, p * q applies p first
+		maxDifference = std::fmax(maxDifference, difference(store(pA * qA), p * q));
+		maxDifference = std::fmax(maxDifference, difference(store(qA * (pA * aA)), (p * q) * a));
+		maxDifference = std::fmax(maxDifference, difference(store(pA * aA), p * a));
+		maxDifference = std::fmax(maxDifference, difference(store(nlerp(pA, qA, 0.3f)), nlerp(p, q, 0.3f)));
+
+		const Matrix4A& mA = inputs.matricesA[0][i];
+		const Matrix4A& nA = inputs.matricesA[1][i];
+
+		maxDifference = std::fmax(maxDifference, difference(store(mA * nA), inputs.matrices[0][i] * inputs.matrices[1][i]));
+		maxDifference = std::fmax(maxDifference, difference(store(transformPoint(mA, aA)), transformPoint(inputs.matrices[0][i], a)));
+
+		const TransformA& sA = inputs.transformsA[0][i];
+		const TransformA& tA = inputs.transformsA[1][i];
+
+		maxDifference = std::fmax(maxDifference, difference(store(combine(sA, tA)), combine(inputs.transforms[0][i], inputs.transforms[1][i])));
+		maxDifference = std::fmax(maxDifference, difference(store(transformPoint(sA, aA)), transformPoint(inputs.transforms[0][i], a)));
+	}
+
+	CHECK(maxDifference < 1e-4f);
+}
+
+// Every operation of the SIMD types against the regular type, NumValues of them per run
+BENCHMARK(SIMDOperations)
+{
+	using namespace SIMDTestsHelpers;
+
+	const Inputs& inputs = getInputs();
+
+	std::vector<float> floats(NumValues);
+	std::vector<Vector3> vectors(NumValues);
+	std::vector<Vector3A> vectorsA(NumValues);
+	std::vector<Quaternion> quaternions(NumValues);
+	std::vector<QuaternionA> quaternionsA(NumValues);
+	std::vector<Matrix4> matrices(NumValues);
+	std::vector<Matrix4A> matricesA(NumValues);
+	std::vector<Transform> transforms(NumValues);
+	std::vector<TransformA> transformsA(NumValues);
+
+	compare("Vector3 add",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = inputs.vectors[0][i] + inputs.vectors[1][i]; } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = inputs.vectorsA[0][i] + inputs.vectorsA[1][i]; } });
+
+	compare("Vector3 dot",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { floats[i] = dot(inputs.vectors[0][i], inputs.vectors[1][i]); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { floats[i] = dot(inputs.vectorsA[0][i], inputs.vectorsA[1][i]); } });
+
+	compare("Vector3 cross",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = cross(inputs.vectors[0][i], inputs.vectors[1][i]); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = cross(inputs.vectorsA[0][i], inputs.vectorsA[1][i]); } });
+
+	compare("Vector3 normalized",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = normalized(inputs.vectors[0][i]); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = normalized(inputs.vectorsA[0][i]); } });
+
+	compare("Vector3 lerp",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = lerp(inputs.vectors[0][i], inputs.vectors[1][i], 0.3f); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = lerp(inputs.vectorsA[0][i], inputs.vectorsA[1][i], 0.3f); } });
+
+	compare("Quaternion multiply",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternions[i] = inputs.quaternions[0][i] * inputs.quaternions[1][i]; } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternionsA[i] = inputs.quaternionsA[0][i] * inputs.quaternionsA[1][i]; } });
+
+	compare("Quaternion rotate",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = inputs.quaternions[0][i] * inputs.vectors[0][i]; } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = inputs.quaternionsA[0][i] * inputs.vectorsA[0][i]; } });
+
+	compare("Quaternion nlerp",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternions[i] = nlerp(inputs.quaternions[0][i], inputs.quaternions[1][i], 0.3f); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternionsA[i] = nlerp(inputs.quaternionsA[0][i], inputs.quaternionsA[1][i], 0.3f); } });
+
+	compare("Matrix4 multiply",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { matrices[i] = inputs.matrices[0][i] * inputs.matrices[1][i]; } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { matricesA[i] = inputs.matricesA[0][i] * inputs.matricesA[1][i]; } });
+
+	compare("Matrix4 transformPoint",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = transformPoint(inputs.matrices[0][i], inputs.vectors[0][i]); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = transformPoint(inputs.matricesA[0][i], inputs.vectorsA[0][i]); } });
+
+	compare("Transform combine",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { transforms[i] = combine(inputs.transforms[0][i], inputs.transforms[1][i]); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { transformsA[i] = combine(inputs.transformsA[0][i], inputs.transformsA[1][i]); } });
+
+	compare("Transform transformPoint",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = transformPoint(inputs.transforms[0][i], inputs.vectors[0][i]); } },
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectorsA[i] = transformPoint(inputs.transformsA[0][i], inputs.vectorsA[0][i]); } });
+
+	// The batched functions work on the regular types
+	compare("mul4x4xN",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { matrices[i] = inputs.matrices[0][i] * inputs.matrices[1][i]; } },
+		[&]() { mul4x4xN(&inputs.matrices[0][0], &inputs.matrices[1][0], &matrices[0], NumValues); });
+
+	compare("quatMulN",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternions[i] = inputs.quaternions[0][i] * inputs.quaternions[1][i]; } },
+		[&]() { quatMulN(&inputs.quaternions[0][0], &inputs.quaternions[1][0], &quaternions[0], NumValues); });
+
+	compare("nlerpN",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternions[i] = nlerp(inputs.quaternions[0][i], inputs.quaternions[1][i], 0.3f); } },
+		[&]() { nlerpN(&inputs.quaternions[0][0], &inputs.quaternions[1][0], 0.3f, &quaternions[0], NumValues); });
+
+	compare("fastSlerpN",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { quaternions[i] = fastSlerp(inputs.quaternions[0][i], inputs.quaternions[1][i], 0.3f); } },
+		[&]() { fastSlerpN(&inputs.quaternions[0][0], &inputs.quaternions[1][0], 0.3f, &quaternions[0], NumValues); });
+
+	compare("transformPointsN",
+		[&]() { for (uint32_t i = 0; i < NumValues; i++) { vectors[i] = transformPoint(inputs.matrices[0][0], inputs.vectors[0][i]); } },
+		[&]() { transformPointsN(inputs.matrices[0][0], &inputs.vectors[0][0], &vectors[0], NumValues); });
+}
\ No newline at end of file
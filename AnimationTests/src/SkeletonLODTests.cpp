@@ -0,0 +1,22 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/SkeletonLOD.h>
+
+using namespace Animation;
+
+TEST(SkeletonLODByName)
+{
+	const Skeleton& skeleton = Tests::getWomanSkeleton();
+	uint32_t size = skeleton.getRestPose().getSize();
+
+	SkeletonLOD noFingers = createSkeletonLODByName(skeleton, "Hand(Thumb|Index|Middle|Ring|Pinky)");
+	CHECK(noFingers.getSize() == size);
+	CHECK(noFingers.getNumActiveJoints() < size);
+	CHECK(noFingers.getNumActiveJoints() > 0);
+
+	// An invalid expression keeps every joint instead of throwing
+	SkeletonLOD invalid = createSkeletonLODByName(skeleton, "Hand([");
+	CHECK(invalid.getSize() == size);
+	CHECK(invalid.getNumActiveJoints() == size);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/SkinPaletteCache.h>
+
+#include <vector>
+
+using namespace Animation;
+
+TEST(SkinPaletteCacheSamplingCountsAsUse)
+{
+	std::vector<FastAnimationClip>& clips = Tests::getWomanFastClips();
+	const FastAnimationClip& first = clips[1];
+	const FastAnimationClip& second = clips[5];
+	const FastAnimationClip& third = clips[7];
+
+	SkinPaletteCache<FastAnimationClip> skinPaletteCache;
+	skinPaletteCache.setSkeleton(Tests::getWomanSkeleton());
+
+	size_t totalSize = 0;
+
+	for (const FastAnimationClip* clip : { &first, &second, &third })
+	{
+		totalSize += skinPaletteCache.bake(*clip)->frames.size() * sizeof(float);
+	}
+
+	// Room for two of the three clips
+	skinPaletteCache.clear();
+	skinPaletteCache.setMemoryBudget(totalSize - 1);
+
+	skinPaletteCache.bake(first);
+	skinPaletteCache.bake(second);
+
+	// Played back after the second one was baked, the first clip is the more recent one
+	std::vector<Matrix3x4> palette(Tests::getWomanSkeleton().getRestPose().getSize());
+	CHECK(skinPaletteCache.samplePalette(first, 0.5f, &palette[0]));
+
+	skinPaletteCache.bake(third);
+
+	CHECK(skinPaletteCache.findBakedClip(first) != nullptr);
+	CHECK(skinPaletteCache.findBakedClip(second) == nullptr);
+	CHECK(skinPaletteCache.findBakedClip(third) != nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "TestData.h"
+#include "TestFramework.h"
+
+#include <Animation/RearrangeBones.h>
+#include <Loader/GLTFLoader.h>
+
+namespace Tests
+{
+	namespace
+	{
+		struct WomanData
+		{
+			WomanData()
+			{
+				cgltf_data* data = Loader::loadGLTFFile(getAssetPath("Models/Woman.gltf"));
+				skeleton = Loader::loadSkeleton(data);
+				clips = Loader::loadAnimationClips(data);
+				Loader::freeGLTFFile(data);
+
+				// Parents before children, the way the samples set up the model
+				Animation::BoneMap boneMap = Animation::rearrangeSkeleton(skeleton);
+
+				for (Animation::AnimationClip& clip : clips)
+				{
+					Animation::rearrangeAnimationClip(clip, boneMap);
+					fastClips.push_back(Animation::optimizeAnimationClip(clip));
+				}
+			}
+
+			Animation::Skeleton skeleton;
+			std::vector<Animation::AnimationClip> clips;
+			std::vector<Animation::FastAnimationClip> fastClips;
+		};
+
+		WomanData& getWomanData()
+		{
+			static WomanData data;
+			return data;
+		}
+	}
+
+	const Animation::Skeleton& getWomanSkeleton()
+	{
+		return getWomanData().skeleton;
+	}
+
+	std::vector<Animation::AnimationClip>& getWomanClips()
+	{
+		return getWomanData().clips;
+	}
+
+	std::vector<Animation::FastAnimationClip>& getWomanFastClips()
+	{
+		return getWomanData().fastClips;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Animation/Skeleton.h>
+#include <Animation/AnimationClip.h>
+
+#include <vector>
+
+namespace Tests
+{
+	// Skeleton and clips of Assets/Models/Woman.gltf, loaded on first use and shared by the
+	// tests. Tests that change the clips work on copies.
+	const Animation::Skeleton& getWomanSkeleton();
+	std::vector<Animation::AnimationClip>& getWomanClips();
+	std::vector<Animation::FastAnimationClip>& getWomanFastClips();
+}
\ No newline at end of file
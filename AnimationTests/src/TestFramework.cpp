@@ -0,0 +1,168 @@
+#include "TestFramework.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace
+{
+	std::atomic<uint64_t> numAllocations(0);
+}
+
+// Counts the allocations for the tests that check code doesn't allocate. The other forms
+// of operator new and delete forward to these.
+void* operator new(std::size_t size)
+{
+	numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	void* memory = std::malloc(size == 0 ? 1 : size);
+
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+namespace Tests
+{
+	namespace
+	{
+		struct Test
+		{
+			const char* name;
+			TestFunction function;
+			bool bBenchmark;
+		};
+
+		// Function local so registrars in other translation units can run first
+		std::vector<Test>& getTests()
+		{
+			static std::vector<Test> tests;
+			return tests;
+		}
+
+		uint32_t numFailedChecks = 0;
+	}
+
+	TestRegistrar::TestRegistrar(const char* name, TestFunction function, bool bBenchmark)
+	{
+		getTests().push_back({ name, function, bBenchmark });
+	}
+
+	int runTests(bool bBenchmarks, const char* filter)
+	{
+		uint32_t numRun = 0;
+		uint32_t numFailed = 0;
+
+		for (const Test& test : getTests())
+		{
+			if (test.bBenchmark != bBenchmarks || (filter != nullptr && std::strstr(test.name, filter) == nullptr))
+			{
+				continue;
+			}
+
+			spdlog::info("[ RUN  ] {}", test.name);
+
+			uint32_t failedBefore = numFailedChecks;
+			test.function();
+			numRun++;
+
+			if (numFailedChecks != failedBefore)
+			{
+				spdlog::error("[ FAIL ] {}", test.name);
+				numFailed++;
+			}
+			else
+			{
+				spdlog::info("[  OK  ] {}", test.name);
+			}
+		}
+
+		spdlog::info("{} of {} passed", numRun - numFailed, numRun);
+
+		return numFailed == 0 ? 0 : 1;
+	}
+
+	void check(bool bCondition, const char* expression, const char* file, int32_t line)
+	{
+		if (!bCondition)
+		{
+			spdlog::error("{}({}): CHECK({}) failed", file, line, expression);
+			numFailedChecks++;
+		}
+	}
+
+	std::string getAssetPath(const std::string& path)
+	{
+		return "../Animation/Assets/" + path;
+	}
+
+	uint64_t getNumAllocations()
+	{
+		return numAllocations.load(std::memory_order_relaxed);
+	}
+
+	bool createGLContext()
+	{
+		static GLFWwindow* window = nullptr;
+		static bool bCreated = false;
+
+		if (bCreated)
+		{
+			if (window != nullptr)
+			{
+				glfwMakeContextCurrent(window);
+			}
+
+			return window != nullptr;
+		}
+
+		bCreated = true;
+
+		if (!glfwInit())
+		{
+			spdlog::error("Failed to initialize GLFW, no GL context for the tests");
+			return false;
+		}
+
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		window = glfwCreateWindow(64, 64, "AnimationTests", nullptr, nullptr);
+
+		if (window == nullptr)
+		{
+			spdlog::error("Failed to create a GLFW window, no GL context for the tests");
+			glfwTerminate();
+			return false;
+		}
+
+		glfwMakeContextCurrent(window);
+
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+		{
+			spdlog::error("Failed to initialize GLAD, no GL context for the tests");
+			glfwDestroyWindow(window);
+			window = nullptr;
+			return false;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
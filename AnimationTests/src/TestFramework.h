@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Tests
+{
+	using TestFunction = void(*)();
+
+	// Tests and benchmarks register themselves through the TEST and BENCHMARK macros and
+	// are run by main, tests by default and benchmarks with --bench
+	class TestRegistrar
+	{
+	public:
+		TestRegistrar(const char* name, TestFunction function, bool bBenchmark);
+	};
+
+	int runTests(bool bBenchmarks, const char* filter);
+
+	void check(bool bCondition, const char* expression, const char* file, int32_t line);
+
+	// Path of a file in the assets of the Animation project
+	std::string getAssetPath(const std::string& path);
+
+	// Number of calls to the global operator new so far, from every thread
+	uint64_t getNumAllocations();
+
+	// Makes the GL context of a hidden window current, for the tests of GPU resources. The
+	// window is created on first use. Returns false when there is no GL to create it with.
+	bool createGLContext();
+
+	// Best time of numRuns calls of function, in milliseconds. The machines these run on
+	// are noisy, the best run is the one least disturbed.
+	template <typename TFunction>
+	double measure(uint32_t numRuns, const TFunction& function)
+	{
+		double best = 0.0;
+
+		for (uint32_t i = 0; i < numRuns; i++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			function();
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+			if (i == 0 || elapsed.count() < best)
+			{
+				best = elapsed.count();
+			}
+		}
+
+		return best;
+	}
+}
+
+#define TEST(name) \
+	static void name(); \
+	static Tests::TestRegistrar name##Registrar(#name, name, false); \
+	static void name()
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static Tests::TestRegistrar name##Registrar(#name, name, true); \
+	static void name()
+
+#define CHECK(condition) Tests::check((condition), #condition, __FILE__, __LINE__)
\ No newline at end of file
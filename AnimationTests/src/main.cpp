@@ -0,0 +1,26 @@
+#include "TestFramework.h"
+
+#include <cstring>
+
+// AnimationTests [--bench] [filter]
+// Runs the tests, or the benchmarks with --bench, whose name contains filter. Run from
+// the AnimationTests directory so the assets of the Animation project are found.
+int main(int argc, char** argv)
+{
+	bool bBenchmarks = false;
+	const char* filter = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--bench") == 0)
+		{
+			bBenchmarks = true;
+		}
+		else
+		{
+			filter = argv[i];
+		}
+	}
+
+	return Tests::runTests(bBenchmarks, filter);
+}
\ No newline at end of file